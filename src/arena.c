@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+static size_t	align_up(size_t n)
+{
+	return ((n + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1));
+}
+
+static t_arena_chunk	*chunk_new(t_arena *a, size_t size)
+{
+	t_arena_chunk	*c;
+
+	if (size < ARENA_CHUNK_SIZE)
+		size = ARENA_CHUNK_SIZE;
+	c = malloc(ARENA_HDR_SIZE + size);
+	if (!c)
+		return (NULL);
+	c->next = NULL;
+	c->size = size;
+	c->used = 0;
+	++a->stats.mallocs;
+	++a->stats.total_mallocs;
+	a->stats.reserved += size;
+	return (c);
+}
+
+int	arena_init(t_arena *a)
+{
+	memset(a, 0, sizeof(*a));
+	a->head = chunk_new(a, ARENA_CHUNK_SIZE);
+	if (!a->head)
+		return (0);
+	a->cur = a->head;
+	a->stats.mallocs = 0;
+	return (1);
+}
+
+/* Moves `a->cur` to a chunk that has at least `size` free bytes.
+ * The stale chunk that follows the current one is recycled
+ * if it's big enough, otherwise it is replaced by a bigger one:
+ * the list never holds more chunks than one prompt needed */
+static t_arena_chunk	*chunk_next(t_arena *a, size_t size)
+{
+	t_arena_chunk	*c;
+	t_arena_chunk	*old;
+
+	old = a->cur->next;
+	if (old && old->size >= size)
+	{
+		old->used = 0;
+		a->cur = old;
+		return (old);
+	}
+	c = chunk_new(a, size);
+	if (!c)
+		return (NULL);
+	c->next = NULL;
+	if (old)
+	{
+		c->next = old->next;
+		a->stats.reserved -= old->size;
+		free(old);
+	}
+	a->cur->next = c;
+	a->cur = c;
+	return (c);
+}
+
+/* Returns ARENA_ALIGN-aligned memory that lives until
+ * the next arena_reset(). Never returns NULL unless
+ * malloc(3) itself fails */
+void	*arena_alloc(t_arena *a, size_t size)
+{
+	t_arena_chunk	*c;
+	void			*p;
+
+	size = align_up(size);
+	c = a->cur;
+	if (c->used + size > c->size)
+		c = chunk_next(a, size);
+	if (!c)
+		return (NULL);
+	p = (unsigned char *)c + ARENA_HDR_SIZE + c->used;
+	c->used += size;
+	++a->stats.allocs;
+	++a->stats.total_allocs;
+	a->stats.used += size;
+	if (a->stats.used > a->stats.peak)
+		a->stats.peak = a->stats.used;
+	return (p);
+}
+
+char	*arena_strndup(t_arena *a, const char *s, size_t n)
+{
+	char	*dup;
+
+	dup = arena_alloc(a, n + 1);
+	if (!dup)
+		return (NULL);
+	memcpy(dup, s, n);
+	dup[n] = '\0';
+	return (dup);
+}
+
+/* Releases everything allocated since the previous reset in O(1):
+ * only the first chunk is rewound, the others are rewound lazily
+ * by chunk_next() when the bump pointer reaches them again */
+void	arena_reset(t_arena *a)
+{
+	a->cur = a->head;
+	a->head->used = 0;
+	if (a->stats.mallocs)
+		++a->stats.malloc_resets;
+	a->stats.allocs = 0;
+	a->stats.mallocs = 0;
+	a->stats.used = 0;
+	++a->stats.resets;
+}
+
+void	arena_destroy(t_arena *a)
+{
+	t_arena_chunk	*c;
+	t_arena_chunk	*next;
+
+	c = a->head;
+	while (c)
+	{
+		next = c->next;
+		free(c);
+		c = next;
+	}
+	memset(a, 0, sizeof(*a));
+}
+
+void	arena_print_stats(const t_arena *a, int fd)
+{
+	dprintf(fd, "arena: %zu allocs, %zu mallocs, %zu of %zu prompts "
+		"called malloc, peak %zu bytes, %zu bytes reserved\n",
+		a->stats.total_allocs, a->stats.total_mallocs,
+		a->stats.malloc_resets, a->stats.resets, a->stats.peak,
+		a->stats.reserved);
+}
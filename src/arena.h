@@ -0,0 +1,66 @@
+#ifndef ARENA_H
+# define ARENA_H
+
+# include <stddef.h>
+
+/* Size of one arena chunk. A typical prompt (a few dozen tokens
+ * together with their AST and redirections) fits into the first
+ * chunk, so once it exists the parse path never calls malloc(3) */
+# define ARENA_CHUNK_SIZE	16384
+# define ARENA_ALIGN		16
+
+/* One block of memory we bump-allocate from.
+ * The data follows the header (see ARENA_HDR_SIZE) */
+typedef struct s_arena_chunk
+{
+	struct s_arena_chunk	*next;
+	size_t					size;
+	size_t					used;
+}	t_arena_chunk;
+
+# define ARENA_HDR_SIZE	((sizeof(t_arena_chunk) + ARENA_ALIGN - 1) \
+	& ~((size_t)ARENA_ALIGN - 1))
+
+/* allocs		 - objects handed out since the last reset;
+ * mallocs		 - chunks requested from malloc(3) since the last reset
+ *				   (must stay 0 for typical prompts once warmed up);
+ * used			 - bytes handed out since the last reset;
+ * total_allocs	 - `allocs` over the whole arena lifetime;
+ * total_mallocs - `mallocs` over the whole arena lifetime;
+ * resets		 - how many prompts were released;
+ * malloc_resets - how many of those prompts needed a malloc(3);
+ * peak			 - the biggest `used` ever seen;
+ * reserved		 - bytes held by all chunks. */
+typedef struct s_arena_stats
+{
+	size_t	allocs;
+	size_t	mallocs;
+	size_t	used;
+	size_t	total_allocs;
+	size_t	total_mallocs;
+	size_t	resets;
+	size_t	malloc_resets;
+	size_t	peak;
+	size_t	reserved;
+}	t_arena_stats;
+
+/* head	- the first chunk, it is kept across resets;
+ * cur	- the chunk we are currently bumping in. Chunks after
+ *		  it are stale leftovers of previous prompts and get
+ *		  reused when `cur` runs out of space, or replaced
+ *		  when they are too small. */
+typedef struct s_arena
+{
+	t_arena_chunk	*head;
+	t_arena_chunk	*cur;
+	t_arena_stats	stats;
+}	t_arena;
+
+int		arena_init(t_arena *a);
+void	*arena_alloc(t_arena *a, size_t size);
+char	*arena_strndup(t_arena *a, const char *s, size_t n);
+void	arena_reset(t_arena *a);
+void	arena_destroy(t_arena *a);
+void	arena_print_stats(const t_arena *a, int fd);
+
+#endif
@@ -0,0 +1,45 @@
+#include "ast.h"
+
+t_token	*token_new(t_arena *a, t_token_type type, const char *s, size_t len)
+{
+	t_token	*tok;
+
+	tok = arena_alloc(a, sizeof(*tok));
+	if (!tok)
+		return (NULL);
+	tok->type = type;
+	tok->value = arena_strndup(a, s, len);
+	if (!tok->value)
+		return (NULL);
+	tok->next = NULL;
+	tok->prev = NULL;
+	return (tok);
+}
+
+t_ast	*ast_new(t_arena *a, t_node_type type, t_ast *left, t_ast *right)
+{
+	t_ast	*node;
+
+	node = arena_alloc(a, sizeof(*node));
+	if (!node)
+		return (NULL);
+	node->type = type;
+	node->left = left;
+	node->right = right;
+	node->args = NULL;
+	node->redirections = NULL;
+	return (node);
+}
+
+t_redi_node	*redi_new(t_arena *a, t_token_type type, char *filename)
+{
+	t_redi_node	*redi;
+
+	redi = arena_alloc(a, sizeof(*redi));
+	if (!redi)
+		return (NULL);
+	redi->type = type;
+	redi->filename = filename;
+	redi->next = NULL;
+	return (redi);
+}
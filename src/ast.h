@@ -0,0 +1,89 @@
+#ifndef AST_H
+# define AST_H
+
+# include <stddef.h>
+
+# include "arena.h"
+
+/* Lexer identifiers (raw tokens) */
+typedef enum e_token_type
+{
+	T_WORD,
+	T_PIPE,
+	T_AND,
+	T_OR,
+	T_LEFT_PAREN,
+	T_RIGHT_PAREN,
+	T_REDIR_IN,
+	T_REDIR_OUT,
+	T_APPEND,
+	T_HEREDOC,
+	T_BG,
+	T_SEMI
+}	t_token_type;
+
+/* Parser identifiers (AST nodes) */
+typedef enum e_node_type
+{
+	NODE_PIPE,
+	NODE_AND,
+	NODE_OR,
+	NODE_CMD,
+	NODE_SUBSHELL,
+	NODE_BG,
+	NODE_SEQ,
+	NODE_GROUP
+}	t_node_type;
+
+/* Flat token list produced before the tree is built.
+ * value - the token text ("ls", "|", "&&");
+ * prev  - lets the parser look back. */
+typedef struct s_token
+{
+	t_token_type	type;
+	char			*value;
+	struct s_token	*next;
+	struct s_token	*prev;
+}	t_token;
+
+/* Redirections attached to a command, applied left to right.
+ * type		- T_REDIR_IN, T_REDIR_OUT, T_APPEND or T_HEREDOC;
+ * filename	- file name or heredoc delimiter. */
+typedef struct s_redi_node
+{
+	t_token_type		type;
+	char				*filename;
+	struct s_redi_node	*next;
+}	t_redi_node;
+
+/* One node type for the whole tree.
+ * NODE_BG		- runs `left` in the background and goes on with
+ *				  `right`, NULL when the list ends with `&`;
+ * NODE_SEQ		- runs `left`, then `right` (NULL after a final `;`);
+ * NODE_GROUP	- `{ left }`, or a subshell found not to change the
+ *				  shell's state (see elide.c): no fork of its own;
+ * args			- execve() argv: ["ls", "-la", NULL] (NODE_CMD only);
+ * redirections	- <, >, <<, >> in the order they were written. */
+typedef struct s_ast
+{
+	t_node_type		type;
+	struct s_ast	*left;
+	struct s_ast	*right;
+	char			**args;
+	t_redi_node		*redirections;
+}	t_ast;
+
+/* Every object below lives in the per-prompt arena
+ * and must never be passed to free(3). redi_new() does not
+ * copy `filename`, it is the text of a token of the prompt */
+t_token		*token_new(t_arena *a, t_token_type type,
+				const char *s, size_t len);
+t_ast		*ast_new(t_arena *a, t_node_type type,
+				t_ast *left, t_ast *right);
+t_redi_node	*redi_new(t_arena *a, t_token_type type, char *filename);
+
+/* ast_clone.c */
+size_t		ast_clone_size(const t_ast *node);
+t_ast		*ast_clone(const t_ast *node, char **mem);
+
+#endif
@@ -0,0 +1,174 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "ast.h"
+#include "vector.h"
+
+/* A node of the tree being copied and where its copy goes */
+typedef struct s_clone_frame
+{
+	const t_ast	*node;
+	t_ast		**dst;
+}	t_clone_frame;
+
+static size_t	clone_align(size_t n)
+{
+	return ((n + sizeof(void *) - 1) & ~(sizeof(void *) - 1));
+}
+
+static void	*clone_take(char **mem, size_t n)
+{
+	void	*p;
+
+	p = *mem;
+	*mem += clone_align(n);
+	return (p);
+}
+
+/* Bytes of `node` itself: its arguments and redirections, not its
+ * children */
+static size_t	clone_node_size(const t_ast *node)
+{
+	const t_redi_node	*r;
+	size_t				n;
+	size_t				i;
+
+	n = clone_align(sizeof(*node));
+	i = 0;
+	while (node->args && node->args[i])
+		n += clone_align(strlen(node->args[i++]) + 1);
+	if (node->args)
+		n += clone_align((i + 1) * sizeof(char *));
+	r = node->redirections;
+	while (r)
+	{
+		n += clone_align(sizeof(*r)) + clone_align(strlen(r->filename) + 1);
+		r = r->next;
+	}
+	return (n);
+}
+
+/* Bytes ast_clone() needs to copy the tree of `root`. The walk uses
+ * an explicit stack, however deep the tree: SIZE_MAX if memory runs
+ * out for it */
+size_t	ast_clone_size(const t_ast *root)
+{
+	t_vector	stack;
+	const t_ast	*node;
+	size_t		n;
+	int			ok;
+
+	vec_init(&stack, sizeof(node));
+	n = 0;
+	ok = (!root || vec_push(&stack, &root));
+	while (ok && stack.len)
+	{
+		node = VEC_LAST(&stack, const t_ast *);
+		vec_pop(&stack);
+		n += clone_node_size(node);
+		if (node->left)
+			ok = ok && vec_push(&stack, &node->left);
+		if (node->right)
+			ok = ok && vec_push(&stack, &node->right);
+	}
+	vec_free(&stack);
+	if (!ok)
+		return (SIZE_MAX);
+	return (n);
+}
+
+static char	*clone_str(char **mem, const char *s)
+{
+	size_t	n;
+
+	n = strlen(s) + 1;
+	return (memcpy(clone_take(mem, n), s, n));
+}
+
+static t_redi_node	*clone_redirs(char **mem, const t_redi_node *r)
+{
+	t_redi_node	*head;
+	t_redi_node	**tail;
+
+	head = NULL;
+	tail = &head;
+	while (r)
+	{
+		*tail = clone_take(mem, sizeof(**tail));
+		(*tail)->type = r->type;
+		(*tail)->filename = clone_str(mem, r->filename);
+		(*tail)->next = NULL;
+		tail = &(*tail)->next;
+		r = r->next;
+	}
+	return (head);
+}
+
+/* Copies `node` without its children, which are left to
+ * clone_push() */
+static t_ast	*clone_node(const t_ast *node, char **mem)
+{
+	t_ast	*copy;
+	size_t	i;
+
+	copy = clone_take(mem, sizeof(*copy));
+	*copy = *node;
+	copy->left = NULL;
+	copy->right = NULL;
+	if (node->args)
+	{
+		i = 0;
+		while (node->args[i])
+			++i;
+		copy->args = clone_take(mem, (i + 1) * sizeof(char *));
+		copy->args[i] = NULL;
+		while (i--)
+			copy->args[i] = clone_str(mem, node->args[i]);
+	}
+	copy->redirections = clone_redirs(mem, node->redirections);
+	return (copy);
+}
+
+/* `node` is to be copied into the pointer at `dst` */
+static int	clone_push(t_vector *stack, const t_ast *node, t_ast **dst)
+{
+	t_clone_frame	*f;
+
+	if (!node)
+		return (1);
+	f = vec_emplace(stack);
+	if (!f)
+		return (0);
+	f->node = node;
+	f->dst = dst;
+	return (1);
+}
+
+/* Deep-copies the tree of `root` into the buffer at *mem, which
+ * must hold ast_clone_size(root) bytes, and advances *mem. The
+ * copy does not point into the arena the original came from.
+ * Like ast_clone_size() it walks with an explicit stack: NULL if
+ * memory runs out for it */
+t_ast	*ast_clone(const t_ast *root, char **mem)
+{
+	t_vector		stack;
+	t_clone_frame	f;
+	t_ast			*copy;
+	int				ok;
+
+	vec_init(&stack, sizeof(t_clone_frame));
+	copy = NULL;
+	ok = clone_push(&stack, root, &copy);
+	while (ok && stack.len)
+	{
+		f = VEC_LAST(&stack, t_clone_frame);
+		vec_pop(&stack);
+		*f.dst = clone_node(f.node, mem);
+		ok = clone_push(&stack, f.node->left, &(*f.dst)->left)
+			&& clone_push(&stack, f.node->right, &(*f.dst)->right);
+	}
+	vec_free(&stack);
+	if (!ok)
+		return (NULL);
+	return (copy);
+}
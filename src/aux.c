@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aux.h"
+
+/* FNV-1a hash of the first `n` bytes of `s` */
+uint64_t	aux_hash(const char *s, size_t n)
+{
+	uint64_t	h;
+
+	h = 14695981039346656037ULL;
+	while (n--)
+	{
+		h ^= (unsigned char)*s++;
+		h *= 1099511628211ULL;
+	}
+	return (h);
+}
+
+/* Writes `path` to `buf` with a leading "~/" replaced by `home`.
+ * Returns 0 if `home` is needed but unknown or `buf` is too small */
+int	aux_tilde(char *buf, size_t size, const char *path, const char *home)
+{
+	int	n;
+
+	if (path[0] != '~' || path[1] != '/')
+		n = snprintf(buf, size, "%s", path);
+	else if (!home || !*home)
+		return (0);
+	else
+		n = snprintf(buf, size, "%s%s", home, path + 1);
+	return (n >= 0 && (size_t)n < size);
+}
+
+void	aux_sb_init(t_strbuf *sb)
+{
+	sb->buf = NULL;
+	sb->len = 0;
+	sb->cap = 0;
+}
+
+void	aux_sb_free(t_strbuf *sb)
+{
+	free(sb->buf);
+	aux_sb_init(sb);
+}
+
+/* Makes room for `n` more bytes and the NUL, doubling the buffer */
+static int	aux_sb_grow(t_strbuf *sb, size_t n)
+{
+	size_t	cap;
+	char	*buf;
+
+	cap = sb->cap;
+	if (cap < AUX_SB_MIN)
+		cap = AUX_SB_MIN;
+	while (cap < sb->len + n + 1)
+		cap *= 2;
+	buf = realloc(sb->buf, cap);
+	if (!buf)
+		return (0);
+	sb->buf = buf;
+	sb->cap = cap;
+	return (1);
+}
+
+/* Appends `n` bytes of `s`. Returns 0 when out of memory, the
+ * string is left as it was */
+int	aux_sb_put(t_strbuf *sb, const char *s, size_t n)
+{
+	if (sb->len + n + 1 > sb->cap && !aux_sb_grow(sb, n))
+		return (0);
+	memcpy(sb->buf + sb->len, s, n);
+	sb->len += n;
+	sb->buf[sb->len] = '\0';
+	return (1);
+}
+
+int	aux_sb_putc(t_strbuf *sb, char c)
+{
+	if (sb->len + 2 > sb->cap && !aux_sb_grow(sb, 1))
+		return (0);
+	sb->buf[sb->len++] = c;
+	sb->buf[sb->len] = '\0';
+	return (1);
+}
+
+/* Shortens the string to its first `len` bytes, aux_sb_cut(sb, 0)
+ * empties it */
+void	aux_sb_cut(t_strbuf *sb, size_t len)
+{
+	if (len >= sb->len)
+		return ;
+	sb->len = len;
+	sb->buf[len] = '\0';
+}
@@ -0,0 +1,32 @@
+#ifndef AUX_H
+# define AUX_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+/* First capacity of a t_strbuf */
+# define AUX_SB_MIN	256
+
+/* A growable string that is reused: clearing it keeps the memory,
+ * so once it has grown to the longest string built no more
+ * allocations are made.
+ * buf - `len` bytes followed by a NUL, NULL until the first byte
+ *		 is added;
+ * cap - bytes allocated. */
+typedef struct s_strbuf
+{
+	char	*buf;
+	size_t	len;
+	size_t	cap;
+}	t_strbuf;
+
+uint64_t	aux_hash(const char *s, size_t n);
+int			aux_tilde(char *buf, size_t size, const char *path,
+				const char *home);
+void		aux_sb_init(t_strbuf *sb);
+void		aux_sb_free(t_strbuf *sb);
+int			aux_sb_put(t_strbuf *sb, const char *s, size_t n);
+int			aux_sb_putc(t_strbuf *sb, char c);
+void		aux_sb_cut(t_strbuf *sb, size_t len);
+
+#endif
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+/* Leading -n, -nn... options suppress the newline */
+static int	echo_opt_n(const char *arg)
+{
+	if (arg[0] != '-' || arg[1] != 'n')
+		return (0);
+	++arg;
+	while (*arg == 'n')
+		++arg;
+	return (*arg == '\0');
+}
+
+/* The whole line is assembled first and written at once */
+int	bi_echo(t_engine *eng, char **argv)
+{
+	char	*buf;
+	size_t	len;
+	size_t	n;
+	int		i;
+	int		nl;
+
+	i = 1;
+	while (argv[i] && echo_opt_n(argv[i]))
+		++i;
+	nl = (i == 1);
+	len = 1;
+	n = i;
+	while (argv[n])
+		len += strlen(argv[n++]) + 1;
+	buf = arena_alloc(&eng->arena, len);
+	if (!buf)
+		return (EXIT_FAILURE);
+	len = 0;
+	while (argv[i])
+	{
+		n = strlen(argv[i]);
+		memcpy(buf + len, argv[i], n);
+		len += n;
+		if (argv[++i])
+			buf[len++] = ' ';
+	}
+	if (nl)
+		buf[len++] = '\n';
+	if (len && write(STDOUT_FILENO, buf, len) != (ssize_t)len)
+	{
+		perror("minishell: echo: write error");
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
+
+int	bi_pwd(t_engine *eng, char **argv)
+{
+	char	*cwd;
+
+	(void)eng;
+	(void)argv;
+	cwd = getcwd(NULL, 0);
+	if (!cwd)
+	{
+		perror("minishell: pwd");
+		return (EXIT_FAILURE);
+	}
+	dprintf(STDOUT_FILENO, "%s\n", cwd);
+	free(cwd);
+	return (EXIT_SUCCESS);
+}
+
+int	bi_true(t_engine *eng, char **argv)
+{
+	(void)eng;
+	(void)argv;
+	return (EXIT_SUCCESS);
+}
+
+int	bi_false(t_engine *eng, char **argv)
+{
+	(void)eng;
+	(void)argv;
+	return (EXIT_FAILURE);
+}
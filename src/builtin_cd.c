@@ -0,0 +1,74 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+/* Directory to go to: the argument, $HOME or, for "-", $OLDPWD */
+static const char	*cd_target(t_engine *eng, char **argv)
+{
+	const char	*dir;
+	const char	*var;
+
+	var = NULL;
+	dir = argv[1];
+	if (!dir)
+		var = "HOME";
+	else if (!strcmp(dir, "-"))
+		var = "OLDPWD";
+	if (var)
+	{
+		dir = env_get(&eng->env, var);
+		if (!dir)
+			fprintf(stderr, "minishell: cd: %s not set\n", var);
+	}
+	return (dir);
+}
+
+/* Updates PWD and OLDPWD once the directory has changed */
+static int	cd_update(t_engine *eng, char *old)
+{
+	char	*cwd;
+	int		ok;
+
+	cwd = getcwd(NULL, 0);
+	ok = (!old || env_set(&eng->env, "OLDPWD", old))
+		&& (!cwd || env_set(&eng->env, "PWD", cwd));
+	free(cwd);
+	if (!ok)
+		perror("minishell: cd");
+	return (ok);
+}
+
+int	bi_cd(t_engine *eng, char **argv)
+{
+	const char	*dir;
+	char		*old;
+	int			ok;
+
+	if (argv[1] && argv[2])
+	{
+		fprintf(stderr, "minishell: cd: too many arguments\n");
+		return (EXIT_FAILURE);
+	}
+	dir = cd_target(eng, argv);
+	if (!dir)
+		return (EXIT_FAILURE);
+	old = getcwd(NULL, 0);
+	if (chdir(dir) == -1)
+	{
+		fprintf(stderr, "minishell: cd: %s: %s\n", dir, strerror(errno));
+		free(old);
+		return (EXIT_FAILURE);
+	}
+	if (argv[1] && !strcmp(argv[1], "-"))
+		dprintf(STDOUT_FILENO, "%s\n", dir);
+	path_cache_chdir(&eng->path);
+	ok = cd_update(eng, old);
+	free(old);
+	if (!ok)
+		return (EXIT_FAILURE);
+	return (EXIT_SUCCESS);
+}
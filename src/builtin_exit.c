@@ -0,0 +1,68 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+/* Strict decimal long long: optional blanks and sign, digits,
+ * optional blanks. Returns 0 on garbage or overflow */
+static int	exit_atoll(const char *s, long long *out)
+{
+	unsigned long long	n;
+	int					neg;
+	int					digits;
+	int					d;
+
+	while (*s == ' ' || *s == '\t')
+		++s;
+	neg = (*s == '-');
+	if (*s == '-' || *s == '+')
+		++s;
+	n = 0;
+	digits = 0;
+	while (*s >= '0' && *s <= '9' && ++digits)
+	{
+		d = *s++ - '0';
+		if (n > ((unsigned long long)LLONG_MAX + neg - d) / 10)
+			return (0);
+		n = n * 10 + d;
+	}
+	while (*s == ' ' || *s == '\t')
+		++s;
+	if (!digits || *s)
+		return (0);
+	*out = (long long)n;
+	if (neg)
+		*out = (long long)(0 - n);
+	return (1);
+}
+
+/* Stops the shell once the current command is done. In a child
+ * (a pipeline stage or subshell) only that child exits */
+int	bi_exit(t_engine *eng, char **argv)
+{
+	long long	n;
+
+	if (engine_interactive(eng))
+		dprintf(STDERR_FILENO, "exit\n");
+	if (!argv[1])
+	{
+		eng->exiting = true;
+		return (eng->status);
+	}
+	if (!exit_atoll(argv[1], &n))
+	{
+		fprintf(stderr, "minishell: exit: %s: numeric argument required\n",
+			argv[1]);
+		eng->exiting = true;
+		return (EXIT_USAGE);
+	}
+	if (argv[2])
+	{
+		fprintf(stderr, "minishell: exit: too many arguments\n");
+		return (EXIT_FAILURE);
+	}
+	eng->exiting = true;
+	return ((unsigned char)n);
+}
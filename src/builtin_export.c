@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+static int	var_cmp(const void *a, const void *b)
+{
+	const t_env_var	*x;
+	const t_env_var	*y;
+	size_t			n;
+	int				c;
+
+	x = *(t_env_var *const *)a;
+	y = *(t_env_var *const *)b;
+	n = x->klen;
+	if (y->klen < n)
+		n = y->klen;
+	c = memcmp(x->kv, y->kv, n);
+	if (c)
+		return (c);
+	return ((x->klen > y->klen) - (x->klen < y->klen));
+}
+
+/* declare -x NAME="value", with ", \, $ and ` escaped */
+static void	export_print_var(const t_env_var *v)
+{
+	const char	*p;
+	size_t		n;
+
+	if (!v->set)
+	{
+		dprintf(STDOUT_FILENO, "declare -x %s\n", v->kv);
+		return ;
+	}
+	dprintf(STDOUT_FILENO, "declare -x %.*s=\"", (int)v->klen, v->kv);
+	p = v->kv + v->klen + 1;
+	while (*p)
+	{
+		n = strcspn(p, "\"\\$`");
+		if (n)
+			dprintf(STDOUT_FILENO, "%.*s", (int)n, p);
+		p += n;
+		if (*p)
+			dprintf(STDOUT_FILENO, "\\%c", *p++);
+	}
+	dprintf(STDOUT_FILENO, "\"\n");
+}
+
+/* `export` without arguments: every exported variable by name */
+static int	export_print(t_engine *eng)
+{
+	t_env_var	**vars;
+	size_t		n;
+	size_t		i;
+
+	vars = arena_alloc(&eng->arena, (eng->env.cnt + 1) * sizeof(*vars));
+	if (!vars)
+		return (EXIT_FAILURE);
+	n = 0;
+	i = 0;
+	while (i < eng->env.cap)
+	{
+		if (eng->env.tab[i].kv && eng->env.tab[i].exported)
+			vars[n++] = &eng->env.tab[i];
+		++i;
+	}
+	qsort(vars, n, sizeof(*vars), var_cmp);
+	i = 0;
+	while (i < n)
+		export_print_var(vars[i++]);
+	return (EXIT_SUCCESS);
+}
+
+int	bi_export(t_engine *eng, char **argv)
+{
+	char	*eq;
+	char	*name;
+	int		status;
+
+	if (!argv[1])
+		return (export_print(eng));
+	status = EXIT_SUCCESS;
+	while (*++argv)
+	{
+		eq = strchr(*argv, '=');
+		if (!eq)
+			eq = *argv + strlen(*argv);
+		if (!env_is_name(*argv, eq - *argv))
+		{
+			fprintf(stderr, "minishell: export: `%s': not a valid "
+				"identifier\n", *argv);
+			status = EXIT_FAILURE;
+			continue ;
+		}
+		name = arena_strndup(&eng->arena, *argv, eq - *argv);
+		if (!name || (*eq && !env_set(&eng->env, name, eq + 1))
+			|| !env_export(&eng->env, name, true))
+		{
+			perror("minishell: export");
+			status = EXIT_FAILURE;
+		}
+	}
+	return (status);
+}
+
+int	bi_unset(t_engine *eng, char **argv)
+{
+	int	status;
+
+	status = EXIT_SUCCESS;
+	while (*++argv)
+	{
+		if (env_is_name(*argv, strlen(*argv)))
+			env_unset(&eng->env, *argv);
+		else
+		{
+			fprintf(stderr, "minishell: unset: `%s': not a valid "
+				"identifier\n", *argv);
+			status = EXIT_FAILURE;
+		}
+	}
+	return (status);
+}
+
+int	bi_env(t_engine *eng, char **argv)
+{
+	char	**envp;
+
+	if (argv[1])
+	{
+		fprintf(stderr, "minishell: env: too many arguments\n");
+		return (EXIT_USAGE);
+	}
+	envp = env_envp(&eng->env);
+	if (!envp)
+	{
+		perror("minishell: env");
+		return (EXIT_FAILURE);
+	}
+	while (*envp)
+		dprintf(STDOUT_FILENO, "%s\n", *envp++);
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+static void	hash_print(t_path_cache *pc)
+{
+	size_t	i;
+	int		empty;
+
+	empty = 1;
+	i = 0;
+	while (i < pc->cap)
+	{
+		if (pc->tab[i].name && pc->tab[i].path)
+		{
+			if (empty)
+				dprintf(STDOUT_FILENO, "hits\tcommand\n");
+			dprintf(STDOUT_FILENO, "%4zu\t%s\n", pc->tab[i].hits,
+				pc->tab[i].path);
+			empty = 0;
+		}
+		++i;
+	}
+	if (empty)
+		dprintf(STDOUT_FILENO, "hash: hash table empty\n");
+}
+
+static void	hash_print_stats(t_path_cache *pc)
+{
+	dprintf(STDOUT_FILENO, "hits %zu, misses %zu, negative hits %zu, "
+		"invalidations %zu, flushes %zu\n", pc->stats.hits,
+		pc->stats.misses, pc->stats.neg_hits, pc->stats.invalidations,
+		pc->stats.flushes);
+}
+
+/* Remembers the locations of the given commands */
+static int	hash_add(t_engine *eng, char **names)
+{
+	int	status;
+
+	status = EXIT_SUCCESS;
+	while (*names)
+	{
+		if (!strchr(*names, '/')
+			&& !path_lookup(&eng->path, *names, engine_path_var(eng)))
+		{
+			fprintf(stderr, "minishell: hash: %s: not found\n", *names);
+			status = EXIT_FAILURE;
+		}
+		++names;
+	}
+	return (status);
+}
+
+/* hash [-rs] [name ...]
+ *     -r - forget all remembered locations;
+ *     -s - print the cache counters (minishell only).
+ * Without arguments prints the remembered commands */
+int	bi_hash(t_engine *eng, char **argv)
+{
+	size_t	i;
+
+	i = 1;
+	while (argv[i] && argv[i][0] == '-' && argv[i][1])
+	{
+		if (!strcmp(argv[i], "-r"))
+			path_cache_flush(&eng->path);
+		else if (!strcmp(argv[i], "-s"))
+			hash_print_stats(&eng->path);
+		else
+		{
+			fprintf(stderr, "minishell: hash: %s: invalid option\n"
+				"hash: usage: hash [-rs] [name ...]\n", argv[i]);
+			return (2);
+		}
+		++i;
+	}
+	if (argv[i])
+		return (hash_add(eng, &argv[i]));
+	if (i == 1)
+		hash_print(&eng->path);
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+static void	parsecache_print(t_parse_cache *pc)
+{
+	size_t	lookups;
+	double	rate;
+
+	lookups = pc->stats.hits + pc->stats.misses;
+	rate = 0;
+	if (lookups)
+		rate = 100.0 * pc->stats.hits / lookups;
+	dprintf(STDOUT_FILENO, "hits %zu, misses %zu, hit rate %.1f%%\n"
+		"entries %zu/%d, bytes %zu/%ld, evictions %zu, flushes %zu\n",
+		pc->stats.hits, pc->stats.misses, rate, pc->cnt,
+		PCACHE_MAX_ENTRIES, pc->bytes, PCACHE_MAX_BYTES,
+		pc->stats.evictions, pc->stats.flushes);
+}
+
+/* parsecache [-r] (minishell only)
+ *     -r - forget all parsed prompts.
+ * Without arguments prints the hit rate and memory use of the
+ * parse cache */
+int	bi_parsecache(t_engine *eng, char **argv)
+{
+	if (!argv[1])
+		parsecache_print(&eng->plans);
+	else if (!strcmp(argv[1], "-r") && !argv[2])
+		pcache_flush(&eng->plans);
+	else
+	{
+		fprintf(stderr, "minishell: parsecache: %s: invalid option\n"
+			"parsecache: usage: parsecache [-r]\n", argv[1]);
+		return (EXIT_USAGE);
+	}
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "builtins.h"
+
+/* -e -f -d -r -w -x -s -L -h -p -S -b -c on `path` */
+static int	test_file(char op, const char *path)
+{
+	struct stat	st;
+
+	if (op == 'L' || op == 'h')
+		return (lstat(path, &st) == 0 && S_ISLNK(st.st_mode));
+	if (op == 'r' || op == 'w' || op == 'x')
+		return (access(path, (op == 'r') * R_OK | (op == 'w') * W_OK
+				| (op == 'x') * X_OK) == 0);
+	if (stat(path, &st) == -1)
+		return (0);
+	return (op == 'e'
+		|| (op == 'f' && S_ISREG(st.st_mode))
+		|| (op == 'd' && S_ISDIR(st.st_mode))
+		|| (op == 's' && st.st_size > 0)
+		|| (op == 'p' && S_ISFIFO(st.st_mode))
+		|| (op == 'S' && S_ISSOCK(st.st_mode))
+		|| (op == 'b' && S_ISBLK(st.st_mode))
+		|| (op == 'c' && S_ISCHR(st.st_mode)));
+}
+
+/* Returns 0 (true), 1 (false) or 2 if `op` is no unary operator */
+static int	test_unary(const char *op, const char *arg)
+{
+	if (op[0] != '-' || !op[1] || op[2]
+		|| !strchr("efdrwxsLhpSbcnzt", op[1]))
+		return (2);
+	if (op[1] == 'n')
+		return (!*arg);
+	if (op[1] == 'z')
+		return (*arg != '\0');
+	if (op[1] == 't')
+		return (!isatty(atoi(arg)));
+	return (!test_file(op[1], arg));
+}
+
+static int	test_int(const char *s, long long *n)
+{
+	char	*end;
+
+	*n = strtoll(s, &end, 10);
+	while (*end == ' ' || *end == '\t')
+		++end;
+	if (end == s || *end)
+	{
+		fprintf(stderr, "minishell: test: %s: integer expression "
+			"expected\n", s);
+		return (0);
+	}
+	return (1);
+}
+
+/* Returns 0, 1, or 2 for an error, -1 if `op` is no binary operator */
+static int	test_binary(const char *a, const char *op, const char *b)
+{
+	long long	x;
+	long long	y;
+
+	if (!strcmp(op, "=") || !strcmp(op, "=="))
+		return (strcmp(a, b) != 0);
+	if (!strcmp(op, "!="))
+		return (strcmp(a, b) == 0);
+	if (!strcmp(op, "<"))
+		return (strcmp(a, b) >= 0);
+	if (!strcmp(op, ">"))
+		return (strcmp(a, b) <= 0);
+	if (strcmp(op, "-eq") && strcmp(op, "-ne") && strcmp(op, "-lt")
+		&& strcmp(op, "-le") && strcmp(op, "-gt") && strcmp(op, "-ge"))
+		return (-1);
+	if (!test_int(a, &x) || !test_int(b, &y))
+		return (2);
+	return (!((!strcmp(op, "-eq") && x == y) || (!strcmp(op, "-ne") && x != y)
+			|| (!strcmp(op, "-lt") && x < y) || (!strcmp(op, "-le") && x <= y)
+			|| (!strcmp(op, "-gt") && x > y)
+			|| (!strcmp(op, "-ge") && x >= y)));
+}
+
+static int	test_not(int status)
+{
+	if (status == 2)
+		return (2);
+	return (!status);
+}
+
+/* POSIX rules by argument count (-a and -o are not supported) */
+static int	test_eval(char **av, int n)
+{
+	int	status;
+
+	if (n == 0)
+		return (1);
+	if (n == 1)
+		return (!*av[0]);
+	status = -1;
+	if (n == 3)
+		status = test_binary(av[0], av[1], av[2]);
+	if (status != -1)
+		return (status);
+	if (n <= 4 && !strcmp(av[0], "!"))
+		return (test_not(test_eval(av + 1, n - 1)));
+	if ((n == 3 || n == 4) && !strcmp(av[0], "(") && !strcmp(av[n - 1], ")"))
+		return (test_eval(av + 1, n - 2));
+	if (n == 2)
+		status = test_unary(av[0], av[1]);
+	if (status != -1 && status != 2)
+		return (status);
+	if (n == 2)
+		fprintf(stderr, "minishell: test: %s: unary operator expected\n",
+			av[0]);
+	else if (n == 3)
+		fprintf(stderr, "minishell: test: %s: binary operator expected\n",
+			av[1]);
+	else
+		fprintf(stderr, "minishell: test: too many arguments\n");
+	return (EXIT_USAGE);
+}
+
+/* test EXPR and [ EXPR ] */
+int	bi_test(t_engine *eng, char **argv)
+{
+	int	n;
+
+	(void)eng;
+	n = 0;
+	while (argv[n])
+		++n;
+	if (!strcmp(argv[0], "["))
+	{
+		if (strcmp(argv[--n], "]"))
+		{
+			fprintf(stderr, "minishell: [: missing `]'\n");
+			return (EXIT_USAGE);
+		}
+	}
+	return (test_eval(argv + 1, n - 1));
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "builtins.h"
+
+/* Status of `wait` for an id that is not one of our jobs */
+#define WAIT_NOT_CHILD	127
+
+static int	wait_all(t_jobs *j)
+{
+	size_t	job;
+
+	while (j->running && jobs_reap(j, true))
+		;
+	job = jobs_next_done(j);
+	while (job != JOBS_NONE)
+	{
+		jobs_drop(j, job);
+		job = jobs_next_done(j);
+	}
+	return (EXIT_SUCCESS);
+}
+
+/* wait -n: the next background job to finish, or the oldest one
+ * that already has */
+static int	wait_next(t_jobs *j)
+{
+	size_t	job;
+	int		status;
+
+	job = jobs_next_done(j);
+	while (job == JOBS_NONE && j->running && jobs_reap(j, true))
+		job = jobs_next_done(j);
+	if (job == JOBS_NONE)
+		return (WAIT_NOT_CHILD);
+	status = jobs_at(j, job)->status;
+	jobs_drop(j, job);
+	return (status);
+}
+
+/* Waits for the job `%n`, dropped once it has finished */
+static int	wait_job(t_jobs *j, const char *arg)
+{
+	t_job	*jb;
+	size_t	job;
+	int		status;
+
+	job = strtoul(arg + 1, NULL, 10);
+	if (arg[1] < '0' || arg[1] > '9' || arg[strspn(arg + 1, "0123456789")
+			+ 1] || job >= j->jobs.len || !jobs_at(j, job)->used
+		|| !jobs_at(j, job)->bg)
+	{
+		fprintf(stderr, "minishell: wait: %s: no such job\n", arg);
+		return (WAIT_NOT_CHILD);
+	}
+	status = jobs_wait(j, job);
+	jb = jobs_at(j, job);
+	if (!jb->left)
+		jobs_drop(j, job);
+	return (status);
+}
+
+/* Waits for the process `pid`. Its job is dropped once all of
+ * it has finished */
+static int	wait_pid(t_jobs *j, const char *arg)
+{
+	t_jproc	*p;
+	size_t	job;
+	int		status;
+
+	if (!*arg || arg[strspn(arg, "0123456789")])
+	{
+		fprintf(stderr, "minishell: wait: `%s': not a pid or valid job "
+			"spec\n", arg);
+		return (EXIT_USAGE);
+	}
+	p = jobs_proc(j, atoi(arg));
+	if (!p || !jobs_at(j, p->job)->bg)
+	{
+		fprintf(stderr, "minishell: wait: pid %s is not a child of this "
+			"shell\n", arg);
+		return (WAIT_NOT_CHILD);
+	}
+	while (!p->done && jobs_reap(j, true))
+		;
+	status = p->status;
+	job = p->job;
+	if (!jobs_at(j, job)->left)
+		jobs_drop(j, job);
+	return (status);
+}
+
+/* wait [-n] [pid | %job]...
+ * Without arguments waits for every background job and returns 0,
+ * otherwise returns the status of the last one waited for */
+int	bi_wait(t_engine *eng, char **argv)
+{
+	int	status;
+
+	if (argv[1] && !strcmp(argv[1], "-n") && !argv[2])
+		return (wait_next(&eng->jobs));
+	if (!argv[1])
+		return (wait_all(&eng->jobs));
+	status = EXIT_SUCCESS;
+	while (*++argv)
+	{
+		if (**argv == '%')
+			status = wait_job(&eng->jobs, *argv);
+		else
+			status = wait_pid(&eng->jobs, *argv);
+	}
+	return (status);
+}
@@ -0,0 +1,58 @@
+#include <string.h>
+
+#include "builtins.h"
+
+static const t_builtin	g_builtins[] = {
+	{"echo", bi_echo, NULL, true},
+	{"cd", bi_cd, NULL, false},
+	{"pwd", bi_pwd, NULL, true},
+	{"export", bi_export, NULL, false},
+	{"unset", bi_unset, NULL, false},
+	{"env", bi_env, NULL, true},
+	{"exit", bi_exit, NULL, false},
+	{"true", bi_true, NULL, true},
+	{"false", bi_false, NULL, true},
+	{"test", bi_test, NULL, true},
+	{"[", bi_test, NULL, true},
+	{"hash", bi_hash, NULL, false},
+	{"parsecache", bi_parsecache, NULL, false},
+	{"cat", bi_cat, cat_accepts, true},
+	{"wait", bi_wait, NULL, false},
+	{NULL, NULL, NULL, false}
+};
+
+/* Returns the builtin that runs `argv` or NULL */
+const t_builtin	*builtin_find(char **argv)
+{
+	size_t	i;
+
+	i = 0;
+	while (g_builtins[i].name)
+	{
+		if (!strcmp(g_builtins[i].name, argv[0]))
+		{
+			if (g_builtins[i].accepts && !g_builtins[i].accepts(argv))
+				return (NULL);
+			return (&g_builtins[i]);
+		}
+		++i;
+	}
+	return (NULL);
+}
+
+/* Tells whether the command `name`, whatever its arguments, leaves
+ * the state of the shell alone: an external command or a pure
+ * builtin */
+bool	builtin_pure(const char *name)
+{
+	size_t	i;
+
+	i = 0;
+	while (g_builtins[i].name)
+	{
+		if (!strcmp(g_builtins[i].name, name))
+			return (g_builtins[i].pure);
+		++i;
+	}
+	return (true);
+}
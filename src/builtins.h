@@ -0,0 +1,45 @@
+#ifndef BUILTINS_H
+# define BUILTINS_H
+
+# include "engine.h"
+
+# include <stdbool.h>
+
+/* Every builtin gets the whole argv (argv[0] is its name)
+ * and returns its exit status */
+typedef int		(*t_builtin_fn)(t_engine *eng, char **argv);
+typedef bool	(*t_builtin_accepts)(char **argv);
+
+/* accepts - NULL, or tells whether the builtin handles this argv;
+ *			 when it does not, the command of the same name in PATH
+ *			 is run instead;
+ * pure	   - it never changes the state of the shell (directory,
+ *			 variables, caches, jobs, `exit`). */
+typedef struct s_builtin
+{
+	const char			*name;
+	t_builtin_fn		fn;
+	t_builtin_accepts	accepts;
+	bool				pure;
+}	t_builtin;
+
+const t_builtin	*builtin_find(char **argv);
+bool			builtin_pure(const char *name);
+
+int				bi_echo(t_engine *eng, char **argv);
+int				bi_pwd(t_engine *eng, char **argv);
+int				bi_true(t_engine *eng, char **argv);
+int				bi_false(t_engine *eng, char **argv);
+int				bi_cd(t_engine *eng, char **argv);
+int				bi_export(t_engine *eng, char **argv);
+int				bi_unset(t_engine *eng, char **argv);
+int				bi_env(t_engine *eng, char **argv);
+int				bi_exit(t_engine *eng, char **argv);
+int				bi_test(t_engine *eng, char **argv);
+int				bi_hash(t_engine *eng, char **argv);
+int				bi_parsecache(t_engine *eng, char **argv);
+int				bi_cat(t_engine *eng, char **argv);
+int				bi_wait(t_engine *eng, char **argv);
+bool			cat_accepts(char **argv);
+
+#endif
@@ -0,0 +1,150 @@
+#include <string.h>
+
+#include "compile.h"
+#include "vector.h"
+
+/* A &&, || or ; node being compiled.
+ * state - 0: its left side comes next, 1: its right side comes
+ *		   next, 2: both are done and its jump can be patched;
+ * patch - index of its jump. */
+typedef struct s_frame
+{
+	t_ast	*node;
+	size_t	patch;
+	int		state;
+}	t_frame;
+
+static int	emit(t_vector *code, t_opcode op, t_ast *node)
+{
+	t_insn	*in;
+
+	in = vec_emplace(code);
+	if (!in)
+		return (0);
+	in->op = op;
+	in->node = node;
+	in->target = 0;
+	return (1);
+}
+
+/* A pipeline is emitted at once, an && / || / ; node is pushed.
+ * Background jobs only come before an && / || list. A group
+ * without redirections has nothing to set up or undo: its list is
+ * compiled in place, nested groups cost no recursion when run */
+static int	compile_node(t_vector *code, t_vector *stack, t_ast *node)
+{
+	t_frame	*f;
+
+	while (node && (node->type == NODE_BG
+			|| (node->type == NODE_GROUP && !node->redirections)))
+	{
+		if (node->type == NODE_GROUP)
+			node = node->left;
+		else if (!emit(code, OP_BG, node->left))
+			return (0);
+		else
+			node = node->right;
+	}
+	if (!node)
+		return (1);
+	if (node->type != NODE_AND && node->type != NODE_OR
+		&& node->type != NODE_SEQ)
+		return (emit(code, OP_RUN, node));
+	f = vec_emplace(stack);
+	if (!f)
+		return (0);
+	f->node = node;
+	f->patch = 0;
+	f->state = 0;
+	return (1);
+}
+
+/* Post-order walk with an explicit stack, so the depth of the
+ * tree does not matter:
+ *     a && b  ->  RUN a; JMP_FAIL end; RUN b; end:
+ *     a || b  ->  RUN a; JMP_OK end; RUN b; end:
+ *     a ; b   ->  RUN a; RUN b
+ * A ; node has nothing left to do once its right side starts, it
+ * is popped then: a long list does not grow the stack */
+static int	compile_walk(t_vector *code, t_vector *stack, t_ast *root)
+{
+	t_frame	*f;
+	t_ast	*next;
+
+	if (!compile_node(code, stack, root))
+		return (0);
+	while (stack->len)
+	{
+		f = &VEC_LAST(stack, t_frame);
+		next = f->node->left;
+		if (f->state == 2)
+		{
+			VEC_AT(code, t_insn, f->patch).target = code->len;
+			vec_pop(stack);
+			continue ;
+		}
+		if (f->state == 1 && f->node->type == NODE_SEQ)
+		{
+			next = f->node->right;
+			vec_pop(stack);
+		}
+		else if (f->state++ == 1)
+		{
+			f->patch = code->len;
+			next = f->node->right;
+			if ((f->node->type == NODE_AND && !emit(code, OP_JMP_FAIL, NULL))
+				|| (f->node->type == NODE_OR && !emit(code, OP_JMP_OK, NULL)))
+				return (0);
+		}
+		if (!compile_node(code, stack, next))
+			return (0);
+	}
+	return (1);
+}
+
+/* Jump threading, last instruction first. A jump landing on a
+ * jump of the same kind would take it as well, a jump landing on
+ * one of the other kind would fall through it: either way the
+ * final target is known at compile time */
+static void	compile_thread(t_insn *code, size_t len)
+{
+	size_t	i;
+	size_t	t;
+
+	i = len;
+	while (i--)
+	{
+		if (code[i].op != OP_JMP_FAIL && code[i].op != OP_JMP_OK)
+			continue ;
+		t = code[i].target;
+		if (t < len && code[t].op == code[i].op)
+			code[i].target = code[t].target;
+		else if (t < len && (code[t].op == OP_JMP_FAIL
+				|| code[t].op == OP_JMP_OK))
+			code[i].target = t + 1;
+	}
+}
+
+/* Compiles the tree of `root` into `prog`, allocated in `a` */
+int	compile_ast(t_arena *a, t_ast *root, t_prog *prog)
+{
+	t_vector	code;
+	t_vector	stack;
+	int			ok;
+
+	vec_init(&code, sizeof(t_insn));
+	vec_init(&stack, sizeof(t_frame));
+	ok = compile_walk(&code, &stack, root);
+	prog->len = code.len;
+	prog->code = NULL;
+	if (ok)
+		prog->code = arena_alloc(a, code.len * sizeof(t_insn));
+	if (prog->code)
+	{
+		memcpy(prog->code, vec_data(&code), code.len * sizeof(t_insn));
+		compile_thread(prog->code, prog->len);
+	}
+	vec_free(&code);
+	vec_free(&stack);
+	return (prog->code != NULL);
+}
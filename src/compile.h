@@ -0,0 +1,41 @@
+#ifndef COMPILE_H
+# define COMPILE_H
+
+# include <stddef.h>
+
+# include "ast.h"
+
+typedef enum e_opcode
+{
+	OP_RUN,
+	OP_BG,
+	OP_JMP_FAIL,
+	OP_JMP_OK
+}	t_opcode;
+
+/* OP_RUN		- run the pipeline `node` (a PIPE spine, a command, a
+ *				  subshell or a group with redirections), its status
+ *				  becomes the current one;
+ * OP_BG		- start `node` (also an && / || list) in the background,
+ *				  the current status becomes 0;
+ * OP_JMP_FAIL	- go to `target` if the current status is not 0;
+ * OP_JMP_OK	- go to `target` if the current status is 0. */
+typedef struct s_insn
+{
+	t_opcode	op;
+	t_ast		*node;
+	size_t		target;
+}	t_insn;
+
+/* The && / || structure of a tree as a flat program. Jumps go
+ * straight to the first instruction that will actually run, a
+ * jump is never followed by another one. `len` is the end */
+typedef struct s_prog
+{
+	t_insn	*code;
+	size_t	len;
+}	t_prog;
+
+int	compile_ast(t_arena *a, t_ast *root, t_prog *prog);
+
+#endif
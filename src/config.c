@@ -0,0 +1,218 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "aux.h"
+#include "config.h"
+#include "lexer.h"
+
+/* Runs a command once the bodies of its here-documents are in
+ * place, then releases what it allocated, as a prompt does. The
+ * step itself lives in `eng->script`. Its plan is cached by its
+ * text, unless here-documents key their bodies to its tokens.
+ * Returns -1 on a syntax error, 0 on a failure with errno set */
+static int	cfg_cmd(t_engine *eng, t_cfg_step *st)
+{
+	t_cfg_doc	*doc;
+	t_token		*tok;
+	const char	*text;
+	int			ok;
+
+	if (!st->tokens)
+	{
+		if (st->val)
+			lex(&eng->arena, st->val, strlen(st->val), &tok);
+		eng->status = LEX_SYNTAX_ERR;
+		return (-1);
+	}
+	ok = 1;
+	doc = st->docs;
+	while (ok && doc)
+	{
+		if (doc->eof)
+			heredoc_eof_warning(doc->delim);
+		ok = heredoc_add_body(&eng->heredocs, doc->key, doc->body,
+				doc->len);
+		doc = doc->next;
+	}
+	text = NULL;
+	if (!st->docs)
+		text = st->text;
+	if (ok && !engine_exec(eng, st->tokens, text, st->len))
+		ok = -1;
+	else if (!ok)
+		eng->status = EXIT_FAILURE;
+	heredoc_clear(&eng->heredocs);
+	dircache_clear(&eng->dirs);
+	arena_reset(&eng->arena);
+	return (ok);
+}
+
+/* Only the last step is in tail position, see t_engine. A syntax
+ * error stops the file, and a shell that is not interactive with
+ * it, with status 2 */
+static void	cfg_run(t_engine *eng, t_vector *steps)
+{
+	t_cfg_step	*st;
+	size_t		i;
+	bool		tail;
+	int			ok;
+
+	tail = eng->tail;
+	i = 0;
+	while (i < steps->len && !eng->exiting)
+	{
+		st = vec_at(steps, i++);
+		eng->tail = tail && i == steps->len;
+		ok = 1;
+		if (st->type == CFG_CMD)
+			ok = cfg_cmd(eng, st);
+		else if (st->type == CFG_UNSET)
+			env_unset(&eng->env, st->name);
+		else
+			ok = (!st->val || env_set(&eng->env, st->name, st->val))
+				&& env_export(&eng->env, st->name, true);
+		if (!ok)
+			perror("minishell");
+		if (ok == -1)
+		{
+			eng->exiting = !engine_interactive(eng);
+			break ;
+		}
+	}
+	eng->tail = tail;
+}
+
+/* cfg_compile(), the whole file at once, profiled as lexing */
+static int	cfg_lex(t_engine *eng, const char *text, size_t len,
+	t_vector *steps)
+{
+	int64_t	t0;
+	int		ret;
+
+	t0 = prof_now(&eng->prof);
+	ret = cfg_compile(&eng->script, text, len, steps);
+	prof_span(&eng->prof, "lex", t0);
+	return (ret);
+}
+
+/* Compiles the file open on `fd`, see cfg_compile(). The file
+ * stays mapped at `*map` until the steps have run, here-document
+ * bodies are read from there */
+static int	cfg_read(t_engine *eng, int fd, const struct stat *st,
+	t_vector *steps, void **map)
+{
+	*map = NULL;
+	if (!st->st_size)
+		return (1);
+	*map = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (*map == MAP_FAILED)
+	{
+		*map = NULL;
+		return (-1);
+	}
+	return (cfg_lex(eng, *map, st->st_size, steps));
+}
+
+/* Runs the steps compiled with result `ret` and drops them */
+static void	cfg_finish(t_engine *eng, t_vector *steps, int ret)
+{
+	if (ret == -1)
+		perror("minishell");
+	else
+		cfg_run(eng, steps);
+	vec_free(steps);
+	arena_reset(&eng->script);
+}
+
+static void	cfg_report(t_engine *eng, const char *path, int hit,
+	t_vector *steps)
+{
+	if (!eng->params->settings
+		|| !eng->params->settings->options.f_verbose)
+		return ;
+	fprintf(stderr, "minishell: %s: config cache %s, %zu steps\n", path,
+		hit ? "hit" : "miss", steps->len);
+}
+
+/* Executes the startup file (or script) `path`. With `use_cache`
+ * an unchanged file is not read again: its compiled form comes
+ * from the config cache. Returns 0 with errno set if the file
+ * could not be opened */
+int	config_source(t_engine *eng, const char *path, bool use_cache)
+{
+	char		buf[PATH_MAX];
+	struct stat	st;
+	t_vector	steps;
+	void		*map;
+	int			fd;
+	int			ret;
+
+	if (!path || !aux_tilde(buf, sizeof(buf), path,
+			env_get(&eng->env, "HOME")))
+		return (0);
+	fd = open(buf, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (0);
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+	{
+		close(fd);
+		return (0);
+	}
+	vec_init(&steps, sizeof(t_cfg_step));
+	map = NULL;
+	ret = 1;
+	if (use_cache && cfg_cache_load(eng, buf, &st, &steps))
+		cfg_report(eng, buf, 1, &steps);
+	else
+	{
+		ret = cfg_read(eng, fd, &st, &steps, &map);
+		if (ret == 1 && use_cache)
+			cfg_cache_store(eng, buf, &st, &steps);
+		if (use_cache)
+			cfg_report(eng, buf, 0, &steps);
+	}
+	close(fd);
+	cfg_finish(eng, &steps, ret);
+	if (map)
+		munmap(map, st.st_size);
+	return (1);
+}
+
+/* Executes `text` (the command string of -c) like a script */
+void	config_text(t_engine *eng, const char *text, size_t len)
+{
+	t_vector	steps;
+
+	vec_init(&steps, sizeof(t_cfg_step));
+	cfg_finish(eng, &steps, cfg_lex(eng, text, len, &steps));
+}
+
+/* Startup files, in the order bash reads them */
+void	config_startup(t_engine *eng)
+{
+	t_settings	*s;
+	t_configs	*c;
+
+	s = eng->params->settings;
+	if (!s)
+		return ;
+	c = &s->configs;
+	if (eng->params->mode == INT_LOG && !s->options.f_noprofile)
+	{
+		config_source(eng, c->etc_prof_path, true);
+		if (!config_source(eng, c->home_prof_path, true)
+			&& !config_source(eng, c->home_login_path, true))
+			config_source(eng, c->home_cmn_prof_path, true);
+	}
+	else if (eng->params->mode == INT_NONLOG && !s->options.f_norc)
+	{
+		if (!s->options.f_initfile)
+			config_source(eng, c->etc_rc_path, true);
+		config_source(eng, c->home_rc_path, true);
+	}
+}
@@ -0,0 +1,122 @@
+#ifndef CONFIG_H
+# define CONFIG_H
+
+# include <stdbool.h>
+# include <stdint.h>
+# include <sys/stat.h>
+
+# include "engine.h"
+# include "vector.h"
+
+# define CFG_CACHE_MAGIC	0x4346534dU
+# define CFG_CACHE_VERSION	4
+
+typedef enum e_cfg_step_type
+{
+	CFG_CMD,
+	CFG_EXPORT,
+	CFG_UNSET
+}	t_cfg_step_type;
+
+/* Here-document of a command line, its body is the text of the
+ * lines that follow it in the file.
+ * key	- the delimiter word token, see t_heredoc;
+ * delim	- the delimiter, unquoted;
+ * body	- `len` bytes inside the mapped file;
+ * eof	- the file ended before the delimiter line. */
+typedef struct s_cfg_doc
+{
+	const char			*key;
+	const char			*delim;
+	const char			*body;
+	size_t				len;
+	bool				eof;
+	struct s_cfg_doc	*next;
+}	t_cfg_doc;
+
+/* One step of a compiled startup file.
+ * CFG_CMD		- `tokens` is a command to parse and execute, with
+ *				  the bodies of its here-documents in `docs`; no
+ *				  tokens stand for a line that failed to lex, `val`
+ *				  is its text, lexed again to report the error
+ *				  when the step is reached; `text` is the source
+ *				  of the command, `len` bytes, NULL when the step
+ *				  comes from the config cache;
+ * CFG_EXPORT	- export `name`, setting it to `val` unless NULL;
+ * CFG_UNSET	- unset `name`.
+ * Lines made only of `export`/`unset` with literal arguments are
+ * compiled into CFG_EXPORT/CFG_UNSET steps: they are applied to
+ * the variables directly and do the same whatever the environment
+ * the shell was started with, so replaying them is always safe. */
+typedef struct s_cfg_step
+{
+	t_cfg_step_type	type;
+	t_token			*tokens;
+	t_cfg_doc		*docs;
+	const char		*text;
+	size_t			len;
+	char			*name;
+	char			*val;
+}	t_cfg_step;
+
+/* A command of a file being compiled, it may span several lines.
+ * head, tail - its tokens so far;
+ * docs		- its here-documents, the next one goes to `tail_doc`;
+ * depth	- parentheses left open;
+ * line		- the line being lexed;
+ * end		- the end of the file. */
+typedef struct s_cfg_cmd
+{
+	t_token		*head;
+	t_token		*tail;
+	t_cfg_doc	*docs;
+	t_cfg_doc	**tail_doc;
+	size_t		depth;
+	const char	*line;
+	const char	*end;
+}	t_cfg_cmd;
+
+/* Header of a cache file, followed by the path of the startup
+ * file and its `steps`. The cached steps are used only while the
+ * startup file keeps the same device, inode, mtime and size. */
+typedef struct s_cfg_hdr
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint64_t	dev;
+	uint64_t	ino;
+	int64_t		mtime_sec;
+	int64_t		mtime_nsec;
+	int64_t		size;
+	uint32_t	path_len;
+	uint32_t	steps;
+}	t_cfg_hdr;
+
+/* Read position in a mapped cache file */
+typedef struct s_cfg_cur
+{
+	const char	*p;
+	const char	*end;
+}	t_cfg_cur;
+
+int		config_source(t_engine *eng, const char *path, bool use_cache);
+void	config_startup(t_engine *eng);
+void	config_text(t_engine *eng, const char *text, size_t len);
+
+/* config_compile.c */
+int		cfg_compile(t_arena *a, const char *text, size_t len,
+			t_vector *steps);
+
+/* config_encode.c, config_decode.c */
+int		cfg_encode(t_vector *b, const t_cfg_hdr *hdr, const char *path,
+			t_vector *steps);
+int		cfg_decode(t_arena *a, t_cfg_cur *c, const t_cfg_hdr *want,
+			const char *path, t_vector *steps);
+
+/* config_cache.c */
+int		cfg_cache_load(t_engine *eng, const char *path,
+			const struct stat *st, t_vector *steps);
+void	cfg_cache_store(t_engine *eng, const char *path,
+			const struct stat *st, t_vector *steps);
+
+#endif
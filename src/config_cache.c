@@ -0,0 +1,137 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "aux.h"
+#include "config.h"
+
+/* DEF_MINISHL_CACHE_DIR/cfg-<hash of the startup file path> */
+static int	cfg_cache_path(t_engine *eng, const char *path, char *buf,
+	size_t size)
+{
+	char	dir[PATH_MAX];
+	int		n;
+
+	if (!aux_tilde(dir, sizeof(dir), DEF_MINISHL_CACHE_DIR,
+			env_get(&eng->env, "HOME")))
+		return (0);
+	n = snprintf(buf, size, "%s/cfg-%016llx", dir,
+			(unsigned long long)aux_hash(path, strlen(path)));
+	return (n >= 0 && (size_t)n < size);
+}
+
+/* What the cache of `path` must have been written for */
+static void	cfg_hdr_fill(t_cfg_hdr *h, const char *path,
+	const struct stat *st, size_t steps)
+{
+	memset(h, 0, sizeof(*h));
+	h->magic = CFG_CACHE_MAGIC;
+	h->version = CFG_CACHE_VERSION;
+	h->dev = st->st_dev;
+	h->ino = st->st_ino;
+	h->mtime_sec = st->st_mtim.tv_sec;
+	h->mtime_nsec = st->st_mtim.tv_nsec;
+	h->size = st->st_size;
+	h->path_len = strlen(path);
+	h->steps = steps;
+}
+
+/* Loads the compiled form of the startup file `path` (as described
+ * by `st`) into `steps`. Returns 0 when there is no valid cache */
+int	cfg_cache_load(t_engine *eng, const char *path, const struct stat *st,
+	t_vector *steps)
+{
+	char		cache[PATH_MAX];
+	t_cfg_hdr	want;
+	t_cfg_cur	cur;
+	struct stat	cst;
+	void		*map;
+	int			fd;
+	int			ok;
+
+	if (!cfg_cache_path(eng, path, cache, sizeof(cache)))
+		return (0);
+	fd = open(cache, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (0);
+	map = MAP_FAILED;
+	if (fstat(fd, &cst) == 0 && cst.st_size >= (off_t) sizeof(want))
+		map = mmap(NULL, cst.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return (0);
+	cur.p = map;
+	cur.end = cur.p + cst.st_size;
+	cfg_hdr_fill(&want, path, st, 0);
+	ok = cfg_decode(&eng->script, &cur, &want, path, steps);
+	munmap(map, cst.st_size);
+	if (!ok)
+		vec_clear(steps);
+	return (ok);
+}
+
+/* Creates the cache directory and its missing parents */
+static void	cfg_mkdirs(char *path)
+{
+	char	*p;
+
+	p = path;
+	while (*++p)
+	{
+		if (*p != '/')
+			continue ;
+		*p = '\0';
+		mkdir(path, 0700);
+		*p = '/';
+	}
+}
+
+/* Writes the cache through a temporary file and rename(2), so a
+ * concurrently starting shell never sees half of it */
+static void	cfg_write(char *cache, t_vector *b)
+{
+	char	tmp[PATH_MAX];
+	ssize_t	n;
+	size_t	done;
+	int		fd;
+
+	cfg_mkdirs(cache);
+	if (snprintf(tmp, sizeof(tmp), "%s.%d", cache, (int)getpid())
+		>= (int) sizeof(tmp))
+		return ;
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd == -1)
+		return ;
+	done = 0;
+	while (done < b->len)
+	{
+		n = write(fd, (char *)vec_data(b) + done, b->len - done);
+		if (n == -1 && errno == EINTR)
+			continue ;
+		if (n <= 0)
+			break ;
+		done += n;
+	}
+	if (close(fd) == -1 || done < b->len || rename(tmp, cache) == -1)
+		unlink(tmp);
+}
+
+void	cfg_cache_store(t_engine *eng, const char *path, const struct stat *st,
+	t_vector *steps)
+{
+	char		cache[PATH_MAX];
+	t_cfg_hdr	hdr;
+	t_vector	b;
+
+	if (!cfg_cache_path(eng, path, cache, sizeof(cache)))
+		return ;
+	cfg_hdr_fill(&hdr, path, st, steps->len);
+	vec_init(&b, 1);
+	if (cfg_encode(&b, &hdr, path, steps))
+		cfg_write(cache, &b);
+	vec_free(&b);
+}
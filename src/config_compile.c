@@ -0,0 +1,314 @@
+#include <string.h>
+
+#include "config.h"
+#include "heredoc.h"
+#include "lexer.h"
+
+/* Nothing in a literal word would ever be expanded or unquoted */
+static int	cfg_literal(const char *s)
+{
+	return (!s[strcspn(s, "\"'$\\`*?[~#")]);
+}
+
+/* Is the line `export NAME[=literal]...` or `unset NAME...`? */
+static int	cfg_is_state(t_token *tok)
+{
+	t_token	*t;
+	bool	export;
+	size_t	n;
+
+	if (!tok || tok->type != T_WORD || !tok->next)
+		return (0);
+	export = !strcmp(tok->value, "export");
+	if (!export && strcmp(tok->value, "unset"))
+		return (0);
+	t = tok->next;
+	while (t)
+	{
+		if (t->type != T_WORD || !cfg_literal(t->value))
+			return (0);
+		n = strcspn(t->value, "=");
+		if (!env_is_name(t->value, n) || (!export && t->value[n]))
+			return (0);
+		t = t->next;
+	}
+	return (1);
+}
+
+/* One step per argument. The words belong to the arena and are
+ * split on '=' in place */
+static int	cfg_push(t_vector *steps, t_token *tok)
+{
+	t_cfg_step	*st;
+	t_token		*t;
+	char		*eq;
+
+	if (!cfg_is_state(tok))
+	{
+		st = vec_emplace(steps);
+		if (!st)
+			return (0);
+		memset(st, 0, sizeof(*st));
+		st->tokens = tok;
+		return (1);
+	}
+	t = tok->next;
+	while (t)
+	{
+		st = vec_emplace(steps);
+		if (!st)
+			return (0);
+		memset(st, 0, sizeof(*st));
+		st->type = CFG_UNSET;
+		if (tok->value[0] == 'e')
+			st->type = CFG_EXPORT;
+		st->name = t->value;
+		eq = strchr(t->value, '=');
+		if (eq)
+		{
+			*eq = '\0';
+			st->val = eq + 1;
+		}
+		t = t->next;
+	}
+	return (1);
+}
+
+static int	cfg_blank(const char *p, const char *end)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		++p;
+	return (p == end || *p == '#');
+}
+
+/* Finds the line `doc->delim` from `text` on: the body is
+ * everything before it. Returns the end of the delimiter line */
+static const char	*cfg_body(const char *text, const char *end,
+	t_cfg_doc *doc)
+{
+	const char	*p;
+	const char	*nl;
+	size_t		dlen;
+
+	dlen = strlen(doc->delim);
+	p = text;
+	while (p < end)
+	{
+		nl = memchr(p, '\n', end - p);
+		if (!nl)
+			nl = end;
+		if ((size_t)(nl - p) == dlen && !memcmp(p, doc->delim, dlen))
+		{
+			doc->len = p - text;
+			return (nl);
+		}
+		p = nl + 1;
+	}
+	doc->len = end - text;
+	doc->eof = true;
+	return (end);
+}
+
+/* Takes the bodies of the here-documents among the tokens from `t`
+ * on from the lines after their end `*nl`, moving `*nl` to the end
+ * of the last delimiter line. Returns 0 when out of memory */
+static int	cfg_heredocs(t_arena *a, t_cfg_cmd *cmd, t_token *t,
+	const char **nl)
+{
+	t_cfg_doc	*doc;
+
+	while (t)
+	{
+		if (t->type == T_HEREDOC && t->next && t->next->type == T_WORD)
+		{
+			doc = arena_alloc(a, sizeof(t_cfg_doc));
+			if (!doc)
+				return (0);
+			memset(doc, 0, sizeof(t_cfg_doc));
+			doc->key = t->next->value;
+			doc->delim = heredoc_delim(a, t->next->value);
+			if (!doc->delim)
+				return (0);
+			if (*nl < cmd->end)
+				++*nl;
+			doc->body = *nl;
+			*nl = cfg_body(*nl, cmd->end, doc);
+			*cmd->tail_doc = doc;
+			cmd->tail_doc = &doc->next;
+		}
+		t = t->next;
+	}
+	return (1);
+}
+
+/* Adds `tok` and the tokens after it to the command */
+static void	cfg_append(t_cfg_cmd *cmd, t_token *tok)
+{
+	if (!tok)
+		return ;
+	tok->prev = cmd->tail;
+	if (cmd->tail)
+		cmd->tail->next = tok;
+	else
+		cmd->head = tok;
+	while (tok)
+	{
+		if (tok->type == T_LEFT_PAREN)
+			++cmd->depth;
+		else if (tok->type == T_RIGHT_PAREN && cmd->depth)
+			--cmd->depth;
+		cmd->tail = tok;
+		tok = tok->next;
+	}
+}
+
+/* Lexes the line at `*p` into the command, with the lines after it
+ * while it ends inside quotes or a `${`, then takes the bodies of
+ * its here-documents. Moves `*p` to the end of the last line.
+ * Returns 0 on a syntax error and -1 when out of memory */
+static int	cfg_line(t_arena *a, t_cfg_cmd *cmd, const char **p)
+{
+	const char	*text;
+	t_token		*tok;
+	int			ret;
+
+	text = *p;
+	cmd->line = text;
+	ret = -1;
+	while (ret == -1)
+	{
+		*p = memchr(*p, '\n', cmd->end - *p);
+		if (!*p)
+			*p = cmd->end;
+		if (text == *p || cfg_blank(text, *p))
+			return (1);
+		ret = lex_more(a, text, *p - text, &tok);
+		if (ret == -1 && *p == cmd->end)
+			ret = 0;
+		else if (ret == -1)
+			++*p;
+	}
+	if (!ret)
+		return (0);
+	cfg_append(cmd, tok);
+	if (!cfg_heredocs(a, cmd, tok, p))
+		return (-1);
+	return (1);
+}
+
+/* Whether the command goes on in the next line: it ends with `&&`,
+ * `||`, `|` or `(`, or a parenthesis is still open. There the
+ * newline ends a command like `;` does. Returns -1 when out of
+ * memory */
+static int	cfg_goes_on(t_arena *a, t_cfg_cmd *cmd)
+{
+	t_token			*semi;
+	t_token_type	type;
+
+	if (!cmd->tail)
+		return (0);
+	type = cmd->tail->type;
+	if (type == T_AND || type == T_OR || type == T_PIPE
+		|| type == T_LEFT_PAREN)
+		return (1);
+	if (!cmd->depth)
+		return (0);
+	if (type == T_WORD || type == T_RIGHT_PAREN)
+	{
+		semi = token_new(a, T_SEMI, ";", 1);
+		if (!semi)
+			return (-1);
+		cfg_append(cmd, semi);
+	}
+	return (1);
+}
+
+/* The text of the line that failed to lex, up to `end`, for the
+ * step pushed last */
+static int	cfg_error(t_arena *a, t_vector *steps, t_cfg_cmd *cmd,
+	const char *end)
+{
+	t_cfg_step	*st;
+
+	st = vec_at(steps, steps->len - 1);
+	st->val = arena_strndup(a, cmd->line, end - cmd->line);
+	return (st->val != NULL);
+}
+
+/* Compiles the command starting at `*p`, which may span several
+ * lines, into a step. Moves `*p` to the end of its last line. A
+ * command that fails to lex becomes a step without tokens. Returns
+ * 0 then, 1 otherwise and -1 when out of memory */
+static int	cfg_command(t_arena *a, t_vector *steps, t_cfg_cmd *cmd,
+	const char **p)
+{
+	t_cfg_step	*st;
+	const char	*text;
+	int			ret;
+	int			more;
+
+	text = *p;
+	ret = 1;
+	more = 1;
+	while (ret == 1 && more == 1)
+	{
+		ret = cfg_line(a, cmd, p);
+		if (ret == 1)
+			more = cfg_goes_on(a, cmd);
+		if (ret == 1 && more == 1 && *p == cmd->end)
+			more = 0;
+		else if (ret == 1 && more == 1)
+			++*p;
+	}
+	if (ret == -1 || more == -1)
+		return (-1);
+	if (!ret && (!cfg_push(steps, NULL) || !cfg_error(a, steps, cmd, *p)))
+		return (-1);
+	if (!ret)
+		return (0);
+	if (!cmd->head)
+		return (1);
+	if (!cfg_push(steps, cmd->head))
+		return (-1);
+	st = vec_at(steps, steps->len - 1);
+	st->docs = cmd->docs;
+	if (st->type == CFG_CMD)
+	{
+		st->text = text;
+		st->len = *p - text;
+	}
+	return (1);
+}
+
+/* Compiles a startup file or script, one step per command. A
+ * newline ends a command unless it is left open: see
+ * cfg_goes_on(). Returns 1 on success, 0 if the result must not
+ * be cached and -1 when out of memory. Not cached are files with
+ * a syntax error (reported, nothing after it is compiled: the
+ * shell stops there) and files with here-documents, whose bodies
+ * point into `text` */
+int	cfg_compile(t_arena *a, const char *text, size_t len, t_vector *steps)
+{
+	t_cfg_cmd	cmd;
+	const char	*p;
+	int			ok;
+	int			ret;
+
+	ok = 1;
+	p = text;
+	while (p < text + len)
+	{
+		memset(&cmd, 0, sizeof(cmd));
+		cmd.end = text + len;
+		cmd.tail_doc = &cmd.docs;
+		ret = cfg_command(a, steps, &cmd, &p);
+		if (ret == -1)
+			return (-1);
+		if (!ret)
+			return (0);
+		if (cmd.docs)
+			ok = 0;
+		++p;
+	}
+	return (ok);
+}
@@ -0,0 +1,108 @@
+#include <string.h>
+
+#include "config.h"
+
+static int	cfg_get(t_cfg_cur *c, void *dst, size_t n)
+{
+	if ((size_t)(c->end - c->p) < n)
+		return (0);
+	memcpy(dst, c->p, n);
+	c->p += n;
+	return (1);
+}
+
+static char	*cfg_get_str(t_arena *a, t_cfg_cur *c)
+{
+	uint32_t	n;
+	char		*s;
+
+	if (!cfg_get(c, &n, sizeof(n)) || (size_t)(c->end - c->p) < n)
+		return (NULL);
+	s = arena_strndup(a, c->p, n);
+	c->p += n;
+	return (s);
+}
+
+/* Rebuilds the token list of a CFG_CMD step */
+static int	cfg_get_tokens(t_arena *a, t_cfg_cur *c, t_cfg_step *st)
+{
+	t_token		*tail;
+	t_token		*t;
+	uint32_t	n;
+	uint8_t		type;
+	char		*s;
+
+	tail = NULL;
+	if (!cfg_get(c, &n, sizeof(n)))
+		return (0);
+	while (n--)
+	{
+		if (!cfg_get(c, &type, sizeof(type)) || type > T_SEMI)
+			return (0);
+		s = cfg_get_str(a, c);
+		t = arena_alloc(a, sizeof(*t));
+		if (!s || !t)
+			return (0);
+		t->type = type;
+		t->value = s;
+		t->next = NULL;
+		t->prev = tail;
+		if (tail)
+			tail->next = t;
+		else
+			st->tokens = t;
+		tail = t;
+	}
+	return (st->tokens != NULL);
+}
+
+static int	cfg_get_step(t_arena *a, t_cfg_cur *c, t_cfg_step *st)
+{
+	uint8_t		type;
+	uint32_t	has_val;
+
+	memset(st, 0, sizeof(*st));
+	if (!cfg_get(c, &type, sizeof(type)) || type > CFG_UNSET)
+		return (0);
+	st->type = type;
+	if (st->type == CFG_CMD)
+		return (cfg_get_tokens(a, c, st));
+	st->name = cfg_get_str(a, c);
+	if (!st->name)
+		return (0);
+	if (st->type == CFG_UNSET)
+		return (1);
+	if (!cfg_get(c, &has_val, sizeof(has_val)))
+		return (0);
+	if (has_val)
+		st->val = cfg_get_str(a, c);
+	return (!has_val || st->val);
+}
+
+/* Reads back what cfg_encode() wrote, provided it was written for
+ * the same startup file in the same state as `want` describes.
+ * Returns 0 for a stale, foreign or damaged cache */
+int	cfg_decode(t_arena *a, t_cfg_cur *c, const t_cfg_hdr *want,
+	const char *path, t_vector *steps)
+{
+	t_cfg_hdr	hdr;
+	t_cfg_step	*st;
+	uint32_t	i;
+
+	if (!cfg_get(c, &hdr, sizeof(hdr)))
+		return (0);
+	i = hdr.steps;
+	hdr.steps = want->steps;
+	if (memcmp(&hdr, want, sizeof(hdr))
+		|| (size_t)(c->end - c->p) < hdr.path_len
+		|| memcmp(c->p, path, hdr.path_len))
+		return (0);
+	c->p += hdr.path_len;
+	while (i--)
+	{
+		st = vec_emplace(steps);
+		if (!st || !cfg_get_step(a, c, st))
+			return (0);
+	}
+	return (c->p == c->end);
+}
@@ -0,0 +1,83 @@
+#include <string.h>
+
+#include "config.h"
+
+static int	cfg_put(t_vector *b, const void *p, size_t n)
+{
+	if (!vec_reserve(b, b->len + n))
+		return (0);
+	memcpy((unsigned char *)vec_data(b) + b->len, p, n);
+	b->len += n;
+	return (1);
+}
+
+/* u32 length followed by the bytes, no terminating '\0' */
+static int	cfg_put_str(t_vector *b, const char *s)
+{
+	uint32_t	n;
+
+	n = strlen(s);
+	return (cfg_put(b, &n, sizeof(n)) && cfg_put(b, s, n));
+}
+
+static int	cfg_put_state(t_vector *b, const t_cfg_step *st)
+{
+	uint32_t	has_val;
+
+	if (!cfg_put_str(b, st->name))
+		return (0);
+	if (st->type == CFG_UNSET)
+		return (1);
+	has_val = (st->val != NULL);
+	if (!cfg_put(b, &has_val, sizeof(has_val)))
+		return (0);
+	return (!has_val || cfg_put_str(b, st->val));
+}
+
+/* Step type, then the variable or the tokens (count, then the
+ * type and text of each) */
+static int	cfg_put_step(t_vector *b, const t_cfg_step *st)
+{
+	uint8_t		u8;
+	uint32_t	n;
+	t_token		*t;
+
+	u8 = st->type;
+	if (!cfg_put(b, &u8, sizeof(u8)))
+		return (0);
+	if (st->type != CFG_CMD)
+		return (cfg_put_state(b, st));
+	n = 0;
+	t = st->tokens;
+	while (t)
+	{
+		++n;
+		t = t->next;
+	}
+	if (!cfg_put(b, &n, sizeof(n)))
+		return (0);
+	t = st->tokens;
+	while (t)
+	{
+		u8 = t->type;
+		if (!cfg_put(b, &u8, sizeof(u8)) || !cfg_put_str(b, t->value))
+			return (0);
+		t = t->next;
+	}
+	return (1);
+}
+
+/* Serializes `steps` of the startup file `path` into `b` */
+int	cfg_encode(t_vector *b, const t_cfg_hdr *hdr, const char *path,
+	t_vector *steps)
+{
+	size_t	i;
+
+	if (!cfg_put(b, hdr, sizeof(*hdr)) || !cfg_put(b, path, hdr->path_len))
+		return (0);
+	i = 0;
+	while (i < steps->len)
+		if (!cfg_put_step(b, vec_at(steps, i++)))
+			return (0);
+	return (1);
+}
@@ -0,0 +1,184 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "aux.h"
+#include "htab.h"
+#include "dircache.h"
+
+void	dircache_init(t_dircache *dc)
+{
+	memset(dc, 0, sizeof(*dc));
+	dc->gen = 1;
+}
+
+/* Drops every listing, the prompt is done */
+void	dircache_clear(t_dircache *dc)
+{
+	size_t	i;
+
+	if (!dc->cnt)
+		return ;
+	i = 0;
+	while (i < dc->cap)
+	{
+		free(dc->tab[i].path);
+		free(dc->tab[i].ents);
+		++i;
+	}
+	memset(dc->tab, 0, dc->cap * sizeof(*dc->tab));
+	dc->cnt = 0;
+}
+
+void	dircache_free(t_dircache *dc)
+{
+	dircache_clear(dc);
+	free(dc->tab);
+	dc->tab = NULL;
+	dc->cap = 0;
+}
+
+/* Called before a command is expanded: the commands run since the
+ * listings were last checked may have changed the directories */
+void	dircache_tick(t_dircache *dc)
+{
+	++dc->gen;
+}
+
+/* Returns the slot holding `path` or the empty slot where it
+ * belongs. The table always has at least one empty slot */
+static t_dirlist	*dircache_slot(t_dircache *dc, const char *path,
+	uint64_t h)
+{
+	size_t	i;
+
+	i = h & (dc->cap - 1);
+	while (dc->tab[i].path && (dc->tab[i].hash != h
+			|| strcmp(dc->tab[i].path, path)))
+		i = (i + 1) & (dc->cap - 1);
+	return (&dc->tab[i]);
+}
+
+static size_t	dirlist_home(const void *slot, size_t mask)
+{
+	return (((const t_dirlist *)slot)->hash & mask);
+}
+
+static bool	dirlist_used(const void *slot)
+{
+	return (((const t_dirlist *)slot)->path != NULL);
+}
+
+static const t_htab	g_dircache_htab = {
+	sizeof(t_dirlist), DIRCACHE_INIT_CAP, dirlist_home, dirlist_used
+};
+
+/* See htab_grow() */
+static int	dircache_grow(t_dircache *dc)
+{
+	return (htab_grow(&g_dircache_htab, (void **)&dc->tab, &dc->cap,
+			dc->cnt));
+}
+
+/* Whether `dl` still is what `st` describes */
+static bool	dircache_same(const t_dirlist *dl, const struct stat *st)
+{
+	return (!dl->racy && dl->dev == st->st_dev && dl->ino == st->st_ino
+		&& dl->mtime.tv_sec == st->st_mtim.tv_sec
+		&& dl->mtime.tv_nsec == st->st_mtim.tv_nsec);
+}
+
+/* Reads the directory open on `fd` into `dl->ents` in bulk, with as
+ * few getdents64(2) calls as the buffer allows */
+bool	dircache_fill(t_dirlist *dl, int fd)
+{
+	char	*ents;
+	long	n;
+
+	dl->len = 0;
+	n = 1;
+	while (n > 0)
+	{
+		if (dl->cap - dl->len < DIRCACHE_READ_SIZE)
+		{
+			ents = realloc(dl->ents, dl->cap * 2 + DIRCACHE_READ_SIZE);
+			if (!ents)
+				return (false);
+			dl->ents = ents;
+			dl->cap = dl->cap * 2 + DIRCACHE_READ_SIZE;
+		}
+		n = syscall(SYS_getdents64, fd, dl->ents + dl->len,
+				dl->cap - dl->len);
+		if (n > 0)
+			dl->len += n;
+	}
+	return (n == 0);
+}
+
+/* Notes which directory is open on `fd` and when it changed, then
+ * reads it */
+static bool	dircache_read(t_dirlist *dl, int fd)
+{
+	struct timespec	now;
+	struct stat		st;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	if (fstat(fd, &st) == -1)
+		return (false);
+	dl->dev = st.st_dev;
+	dl->ino = st.st_ino;
+	dl->mtime = st.st_mtim;
+	dl->racy = (now.tv_sec - st.st_mtim.tv_sec) * 1000000000L
+		+ now.tv_nsec - st.st_mtim.tv_nsec < DIRCACHE_RACY_NS;
+	return (dircache_fill(dl, fd));
+}
+
+static bool	dircache_add(t_dircache *dc, t_dirlist *dl, const char *path)
+{
+	dl->path = strdup(path);
+	if (!dl->path)
+		return (false);
+	dl->hash = aux_hash(path, strlen(path));
+	++dc->cnt;
+	return (true);
+}
+
+/* The listing of the directory `path` ("" for the current one),
+ * read if it was not yet or has changed since. NULL when it cannot
+ * be read */
+t_dirlist	*dircache_get(t_dircache *dc, const char *path)
+{
+	t_dirlist	*dl;
+	struct stat	st;
+	const char	*dir;
+	int			fd;
+
+	if (!dircache_grow(dc))
+		return (NULL);
+	dl = dircache_slot(dc, path, aux_hash(path, strlen(path)));
+	dir = path;
+	if (!*dir)
+		dir = ".";
+	if (dl->path && dl->checked != dc->gen && dl->ok
+		&& stat(dir, &st) == 0 && dircache_same(dl, &st))
+		dl->checked = dc->gen;
+	if (dl->path && dl->checked == dc->gen && !dl->ok)
+		return (NULL);
+	if (dl->path && dl->checked == dc->gen)
+		return (dl);
+	if (!dl->path && !dircache_add(dc, dl, path))
+		return (NULL);
+	dl->checked = dc->gen;
+	fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	dl->ok = (fd != -1 && dircache_read(dl, fd));
+	if (fd != -1)
+		close(fd);
+	dc->reads += dl->ok;
+	if (!dl->ok)
+		return (NULL);
+	return (dl);
+}
@@ -0,0 +1,76 @@
+#ifndef DIRCACHE_H
+# define DIRCACHE_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <time.h>
+# include <sys/types.h>
+
+# define DIRCACHE_INIT_CAP	16
+/* Free room the listing buffer has before every getdents64(2):
+ * a directory of 200k files is read in a few hundred calls */
+# define DIRCACHE_READ_SIZE	65536
+/* File times come from a clock that only ticks every few ms. A
+ * directory that changed this close to when it was read may change
+ * again and keep its mtime: its listing is only used by the command
+ * that read it */
+# define DIRCACHE_RACY_NS	20000000L
+
+/* A record of getdents64(2), `reclen` bytes with the name */
+typedef struct s_dirent64
+{
+	uint64_t		ino;
+	int64_t			off;
+	unsigned short	reclen;
+	unsigned char	type;
+	char			name[];
+}	t_dirent64;
+
+/* A directory as it was read.
+ * path	   - as the pattern has it, "" for the current directory;
+ * ents	   - its t_dirent64 records, `len` bytes of `cap`;
+ * dev, ino, mtime - the directory that was read and when it last
+ *			 changed: if they differ later it is read again;
+ * checked - generation they were last compared in;
+ * racy	   - it changed too close to the read for `mtime` to tell;
+ * ok	   - the directory could be read. */
+typedef struct s_dirlist
+{
+	char			*path;
+	uint64_t		hash;
+	char			*ents;
+	size_t			len;
+	size_t			cap;
+	dev_t			dev;
+	ino_t			ino;
+	struct timespec	mtime;
+	unsigned long	checked;
+	bool			racy;
+	bool			ok;
+}	t_dirlist;
+
+/* The directories globbed by the running prompt, dropped when it
+ * is done: `*.log *.gz *.tmp` reads the directory once.
+ * tab	 - open addressing by path, `cap` is a power of 2;
+ * gen	 - bumped by dircache_tick() for every command expanded. A
+ *		   listing is compared to its directory once per command,
+ *		   since the commands before it may have changed it;
+ * reads - directories read since the shell started. */
+typedef struct s_dircache
+{
+	t_dirlist		*tab;
+	size_t			cap;
+	size_t			cnt;
+	unsigned long	gen;
+	size_t			reads;
+}	t_dircache;
+
+void		dircache_init(t_dircache *dc);
+void		dircache_clear(t_dircache *dc);
+void		dircache_free(t_dircache *dc);
+void		dircache_tick(t_dircache *dc);
+t_dirlist	*dircache_get(t_dircache *dc, const char *path);
+bool		dircache_fill(t_dirlist *dl, int fd);
+
+#endif
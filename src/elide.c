@@ -0,0 +1,118 @@
+#include <string.h>
+
+#include "builtins.h"
+#include "elide.h"
+#include "vector.h"
+
+/* Whether the expansion of `word` leaves the shell as it was: not
+ * when it assigns a variable (${x:=word}) or may end the shell
+ * (${x?word}) */
+static bool	elide_word_pure(const char *word)
+{
+	return (!strstr(word, "${") || !strpbrk(word, "=?"));
+}
+
+/* A command may change the state of the shell when it is a builtin
+ * that does, when its name is only known once expanded, or when
+ * one of its words or redirections is not pure. So may a subshell
+ * or group because of its redirections */
+static bool	elide_cmd_pure(const t_ast *cmd)
+{
+	const t_redi_node	*r;
+	size_t				i;
+
+	r = cmd->redirections;
+	while (r)
+	{
+		if (!elide_word_pure(r->filename))
+			return (false);
+		r = r->next;
+	}
+	if (cmd->type != NODE_CMD || !cmd->args || !cmd->args[0])
+		return (true);
+	if (strpbrk(cmd->args[0], "$'\"\\*?[") && strcmp(cmd->args[0], "["))
+		return (false);
+	i = 0;
+	while (cmd->args[i])
+		if (!elide_word_pure(cmd->args[i++]))
+			return (false);
+	return (builtin_pure(cmd->args[0]));
+}
+
+static int	elide_push(t_vector *stack, t_ast *node, size_t owner)
+{
+	t_elide_frame	*f;
+
+	if (!node)
+		return (1);
+	f = vec_emplace(stack);
+	if (!f)
+		return (0);
+	f->node = node;
+	f->owner = owner;
+	return (1);
+}
+
+/* Looks at one node: its children are pushed with the subshell
+ * their effects would be confined to */
+static int	elide_visit(t_vector *stack, t_vector *subs, t_elide_frame f)
+{
+	t_elide_sub	*sub;
+	bool		impure;
+
+	impure = !elide_cmd_pure(f.node) || f.node->type == NODE_BG;
+	if (impure && f.owner != ELIDE_NONE)
+		VEC_AT(subs, t_elide_sub, f.owner).pure = false;
+	if (f.node->type == NODE_SUBSHELL)
+	{
+		sub = vec_emplace(subs);
+		if (!sub)
+			return (0);
+		sub->node = f.node;
+		sub->pure = !impure;
+		return (elide_push(stack, f.node->left, subs->len - 1));
+	}
+	if (f.node->type == NODE_PIPE)
+		return (elide_push(stack, f.node->left, ELIDE_NONE)
+			&& elide_push(stack, f.node->right, ELIDE_NONE));
+	if (f.node->type == NODE_BG)
+		return (elide_push(stack, f.node->left, ELIDE_NONE)
+			&& elide_push(stack, f.node->right, f.owner));
+	return (elide_push(stack, f.node->left, f.owner)
+		&& elide_push(stack, f.node->right, f.owner));
+}
+
+/* Turns every subshell that changes nothing in the shell (no cd,
+ * export, unset, exit, wait, background job...) into a group, so
+ * that it runs without a fork of its own when it is not a stage
+ * of a pipeline. Parentheses only used to group && and || cost
+ * no process. Stages of a pipeline and background jobs run in
+ * children anyway, whatever they do. The walk uses an explicit
+ * stack, the tree is left as it was if memory runs out */
+void	elide_subshells(t_ast *root)
+{
+	t_vector		stack;
+	t_vector		subs;
+	t_elide_frame	f;
+	size_t			i;
+	int				ok;
+
+	vec_init(&stack, sizeof(t_elide_frame));
+	vec_init(&subs, sizeof(t_elide_sub));
+	ok = elide_push(&stack, root, ELIDE_NONE);
+	while (ok && stack.len)
+	{
+		f = VEC_LAST(&stack, t_elide_frame);
+		vec_pop(&stack);
+		ok = elide_visit(&stack, &subs, f);
+	}
+	i = 0;
+	while (ok && i < subs.len)
+	{
+		if (VEC_AT(&subs, t_elide_sub, i).pure)
+			VEC_AT(&subs, t_elide_sub, i).node->type = NODE_GROUP;
+		++i;
+	}
+	vec_free(&stack);
+	vec_free(&subs);
+}
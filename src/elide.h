@@ -0,0 +1,32 @@
+#ifndef ELIDE_H
+# define ELIDE_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "ast.h"
+
+/* Owner of a node no subshell can be blamed for */
+# define ELIDE_NONE	((size_t)-1)
+
+/* A node still to look at.
+ * owner - index of the closest subshell that runs it in its own
+ *		   process, ELIDE_NONE if its effects cannot reach the
+ *		   shell (top level, pipeline stage, background job). */
+typedef struct s_elide_frame
+{
+	t_ast	*node;
+	size_t	owner;
+}	t_elide_frame;
+
+/* A subshell of the tree, `pure` until something in it is found
+ * to change the state of the shell */
+typedef struct s_elide_sub
+{
+	t_ast	*node;
+	bool	pure;
+}	t_elide_sub;
+
+void	elide_subshells(t_ast *root);
+
+#endif
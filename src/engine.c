@@ -1,6 +1,254 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <readline/readline.h>
+
 #include "engine.h"
+#include "lexer.h"
+#include "parser.h"
+#include "exec.h"
+#include "config.h"
+#include "elide.h"
+#include "launch.h"
+
+/* Parses and executes one lexed command of a script, `len` bytes
+ * of `text` unless NULL. A command seen before runs the plan the
+ * parse cache holds for its text, otherwise the AST comes from
+ * `eng->arena` and is left there for the caller to reset.
+ * Returns 0 if the tokens do not parse */
+int	engine_exec(t_engine *eng, t_token *tokens, const char *text,
+	size_t len)
+{
+	t_ast	*ast;
+	int64_t	t0;
+	int		ok;
+
+	path_cache_tick(&eng->path);
+	ast = NULL;
+	if (text)
+		ast = pcache_get(&eng->plans, text, len);
+	ok = 1;
+	if (!ast)
+	{
+		t0 = prof_now(&eng->prof);
+		ok = parse(&eng->arena, tokens, &ast);
+		prof_span(&eng->prof, "parse", t0);
+		if (ok && ast)
+			elide_subshells(ast);
+		if (ok && ast && text)
+			pcache_put(&eng->plans, text, len, ast);
+	}
+	if (!ok)
+		eng->status = PARSE_SYNTAX_ERR;
+	else if (ast)
+		eng->status = exec_ast(eng, ast);
+	pcache_done(&eng->plans);
+	return (ok);
+}
+
+/* Lexes and parses a prompt that is not in the parse cache and
+ * caches its plan, subshells that need no fork already turned
+ * into groups. Returns NULL for an empty or invalid prompt */
+static t_ast	*engine_parse(t_engine *eng, const char *prompt, size_t len)
+{
+	t_token	*tokens;
+	t_ast	*ast;
+	int64_t	t0;
+	int		ok;
+
+	t0 = prof_now(&eng->prof);
+	ok = lex(&eng->arena, prompt, len, &tokens);
+	prof_span(&eng->prof, "lex", t0);
+	if (!ok)
+	{
+		eng->status = LEX_SYNTAX_ERR;
+		return (NULL);
+	}
+	t0 = prof_now(&eng->prof);
+	ok = parse(&eng->arena, tokens, &ast);
+	prof_span(&eng->prof, "parse", t0);
+	if (!ok)
+	{
+		eng->status = PARSE_SYNTAX_ERR;
+		return (NULL);
+	}
+	if (ast)
+	{
+		elide_subshells(ast);
+		pcache_put(&eng->plans, prompt, len, ast);
+	}
+	return (ast);
+}
+
+/* Executes one prompt. A prompt seen before runs its cached plan.
+ * Here-document bodies are read from the terminal first and are
+ * closed with the prompt. Everything else the prompt allocates
+ * comes from `eng->arena`, which is released in one go once the
+ * prompt has been executed */
+int	engine_run(t_engine *eng, char *prompt)
+{
+	t_ast	*ast;
+	size_t	len;
+
+	len = strlen(prompt);
+	ast = pcache_get(&eng->plans, prompt, len);
+	if (!ast)
+		ast = engine_parse(eng, prompt, len);
+	if (ast && !heredoc_read_tty(&eng->arena, &eng->heredocs, ast))
+		eng->status = EXIT_FAILURE;
+	else if (ast)
+	{
+		path_cache_tick(&eng->path);
+		eng->status = exec_ast(eng, ast);
+	}
+	heredoc_clear(&eng->heredocs);
+	dircache_clear(&eng->dirs);
+	pcache_done(&eng->plans);
+	arena_reset(&eng->arena);
+	return (eng->status);
+}
+
+/* PATH used to look commands up */
+const char	*engine_path_var(t_engine *eng)
+{
+	const char	*path;
+
+	path = env_get(&eng->env, "PATH");
+	if (!path)
+		path = DEF_PATH;
+	return (path);
+}
+
+/* The shell reads its commands from a user, and this process is
+ * the shell itself rather than a forked child */
+bool	engine_interactive(t_engine *eng)
+{
+	return (!eng->subshell && (eng->params->mode == INT_LOG
+			|| eng->params->mode == INT_NONLOG));
+}
+
+/* Interactive shells keep their history in
+ * DEF_MINISHL_HOME_HIST_PATH unless configured otherwise */
+static void	engine_hist_init(t_engine *eng)
+{
+	const char	*path;
+
+	path = NULL;
+	if (eng->params->mode == INT_LOG || eng->params->mode == INT_NONLOG)
+		path = DEF_MINISHL_HOME_HIST_PATH;
+	if (path && eng->params->settings
+		&& eng->params->settings->configs.home_hist_path)
+		path = eng->params->settings->configs.home_hist_path;
+	hist_init(&eng->hist, path, &eng->env);
+}
+
+static int	engine_loop(t_engine *eng)
+{
+	char	*line;
+	int64_t	t0;
+
+	engine_hist_init(eng);
+	while (1)
+	{
+		jobs_notify(&eng->jobs);
+		t0 = prof_now(&eng->prof);
+		line = readline(DEF_PS1);
+		prof_span(&eng->prof, "readline", t0);
+		if (!line)
+			break ;
+		if (*line)
+		{
+			hist_add(&eng->hist, line);
+			engine_run(eng, line);
+		}
+		free(line);
+		if (eng->exiting)
+			break ;
+	}
+	hist_close(&eng->hist);
+	return (eng->status);
+}
+
+static void	engine_script(t_engine *eng)
+{
+	if (config_source(eng, eng->params->script_path, false))
+		return ;
+	fprintf(stderr, "minishell: %s: %s\n", eng->params->script_path,
+		strerror(errno));
+	eng->status = LAUNCH_NOT_FOUND;
+}
 
 int	engine(t_engine_params *params)
 {
-	(void)params;
+	t_engine	eng;
+
+	eng.params = params;
+	eng.status = EXIT_SUCCESS;
+	eng.exiting = false;
+	eng.subshell = false;
+	eng.tail = false;
+	path_cache_init(&eng.path);
+	pcache_init(&eng.plans);
+	vec_init(&eng.heredocs, sizeof(t_heredoc));
+	aux_sb_init(&eng.words);
+	vec_init(&eng.fields, sizeof(char *));
+	dircache_init(&eng.dirs);
+	eng.undo = NULL;
+	eng.pid = getpid();
+	jobs_init(&eng.jobs);
+	prof_init(&eng.prof);
+	if (params->settings && params->settings->options.profile
+		&& prof_open(&eng.prof, params->settings->options.profile))
+		eng.jobs.prof = &eng.prof;
+	xtrace_init(&eng.xtrace);
+	if (params->settings && params->settings->options.xtrace
+		&& xtrace_open(&eng.xtrace, params->settings->options.xtrace))
+		eng.jobs.xtrace = &eng.xtrace;
+	if (!arena_init(&eng.arena) || !arena_init(&eng.script))
+	{
+		perror("minishell");
+		arena_destroy(&eng.arena);
+		return (EXIT_FAILURE);
+	}
+	if (!env_init(&eng.env, params->env))
+	{
+		perror("minishell");
+		arena_destroy(&eng.arena);
+		arena_destroy(&eng.script);
+		env_free(&eng.env);
+		return (EXIT_FAILURE);
+	}
+	if (params->mode == NONINT_CMD)
+	{
+		eng.tail = !params->settings || (!params->settings->options.f_verbose
+				&& !params->settings->options.profile
+				&& !params->settings->options.xtrace);
+		config_text(&eng, params->cmds, strlen(params->cmds));
+	}
+	else if (params->mode == NONINT_SCRIPT)
+		engine_script(&eng);
+	else
+	{
+		config_startup(&eng);
+		if (!eng.exiting)
+			engine_loop(&eng);
+	}
+	if (params->settings && params->settings->options.f_verbose)
+		arena_print_stats(&eng.arena, STDERR_FILENO);
+	arena_destroy(&eng.arena);
+	arena_destroy(&eng.script);
+	path_cache_free(&eng.path);
+	pcache_free(&eng.plans);
+	vec_free(&eng.heredocs);
+	aux_sb_free(&eng.words);
+	vec_free(&eng.fields);
+	dircache_free(&eng.dirs);
+	jobs_free(&eng.jobs);
+	prof_close(&eng.prof);
+	xtrace_close(&eng.xtrace);
+	env_free(&eng.env);
+	return (eng.status);
 }
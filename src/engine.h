@@ -2,6 +2,19 @@
 # define ENGINE_H
 
 # include "shell.h"
+# include "init.h"
+# include "arena.h"
+# include "aux.h"
+# include "ast.h"
+# include "dircache.h"
+# include "env.h"
+# include "heredoc.h"
+# include "hist.h"
+# include "jobs.h"
+# include "parse_cache.h"
+# include "path.h"
+# include "prof.h"
+# include "xtrace.h"
 
 # define SEARCH_DEPTH	20
 
@@ -41,6 +54,70 @@ typedef struct s_engine_params
 	t_shell_mode	mode;
 }	t_engine_params;
 
-int	engine(t_engine_params *params);
+/* Runtime state of the read-eval loop.
+ * params - how the shell was launched;
+ * arena  - per-prompt allocator: every token, AST node and
+ *			redirection of the current prompt comes from here
+ *			and is dropped at once when the prompt is done;
+ * script - the compiled steps of the startup file, script or -c
+ *			string being run, with their tokens: they outlive the
+ *			reset of `arena` after each of its commands;
+ * env	  - shell variables, imported from `params->env`;
+ * path	  - command name -> executable cache;
+ * hist	  - persistent history of the interactive shell;
+ * plans  - parsed prompts, reused when a prompt comes again;
+ * heredocs - bodies of the here-documents of the running prompt
+ *			  (t_heredoc);
+ * jobs	  - every child of the shell that has not been collected;
+ * prof	  - --profile trace, off unless asked for;
+ * xtrace - --xtrace trace, off unless asked for;
+ * words  - the word being expanded, reused (see expand.c);
+ * fields - the argv being expanded (char *), reused;
+ * dirs	  - directories read by the patterns of the running prompt;
+ * undo	  - while a stage that runs apart from the shell (in a
+ *			pipeline, in the background) is expanded, the variables
+ *			${x=word} assigns are saved there, and restored once it
+ *			has started; NULL otherwise;
+ * pid	  - pid of the shell ($$), the same in its subshells;
+ * status - exit status of the last prompt ($?);
+ * exiting  - `exit` was run, nothing more is executed;
+ * subshell - this process is a forked child running shell code;
+ * tail	  - the tree being run is the last thing this process
+ *			does: its last command may take the place of the
+ *			shell (execve(2) without a fork). */
+typedef struct s_engine
+{
+	t_engine_params	*params;
+	t_arena			arena;
+	t_arena			script;
+	t_env			env;
+	t_path_cache	path;
+	t_hist			hist;
+	t_parse_cache	plans;
+	t_vector		heredocs;
+	t_jobs			jobs;
+	t_prof			prof;
+	t_xtrace		xtrace;
+	t_strbuf		words;
+	t_vector		fields;
+	t_dircache		dirs;
+	t_vector		*undo;
+	pid_t			pid;
+	int				status;
+	bool			exiting;
+	bool			subshell;
+	bool			tail;
+}	t_engine;
+
+int			engine(t_engine_params *params);
+int			engine_run(t_engine *eng, char *prompt);
+int			engine_exec(t_engine *eng, t_token *tokens, const char *text,
+				size_t len);
+const char	*engine_path_var(t_engine *eng);
+bool		engine_interactive(t_engine *eng);
+
+/* init.c */
+int			init_settings(t_settings *s, t_engine_params *p, int argc,
+				char **argv);
 
 #endif
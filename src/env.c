@@ -0,0 +1,230 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aux.h"
+#include "env.h"
+
+/* Imports the inherited environment: every variable is exported */
+int	env_init(t_env *env, char **envp)
+{
+	char	*eq;
+	char	*name;
+	int		ok;
+
+	memset(env, 0, sizeof(*env));
+	env->dirty = true;
+	while (envp && *envp)
+	{
+		eq = strchr(*envp, '=');
+		if (eq && eq != *envp)
+		{
+			name = strndup(*envp, eq - *envp);
+			ok = name && env_set(env, name, eq + 1)
+				&& env_export(env, name, true);
+			free(name);
+			if (!ok)
+				return (0);
+		}
+		++envp;
+	}
+	return (1);
+}
+
+void	env_free(t_env *env)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < env->cap)
+		free(env->tab[i++].kv);
+	free(env->tab);
+	free(env->envp);
+	memset(env, 0, sizeof(*env));
+}
+
+/* Returns the variable `name`, creating an unset, unexported one
+ * when `create` is true. NULL if it does not exist (or on OOM) */
+static t_env_var	*env_find(t_env *env, const char *name, bool create)
+{
+	t_env_var	*v;
+	size_t		klen;
+	uint64_t	h;
+
+	klen = strlen(name);
+	h = aux_hash(name, klen);
+	if (create && !env_grow(env))
+		return (NULL);
+	if (!env->cap)
+		return (NULL);
+	v = env_slot(env, name, klen, h);
+	if (v->kv || !create)
+		return (v->kv ? v : NULL);
+	v->kv = strdup(name);
+	if (!v->kv)
+		return (NULL);
+	v->klen = klen;
+	v->hash = h;
+	++env->cnt;
+	return (v);
+}
+
+/* env_get() of the first `n` bytes of `name`, which need not be
+ * NUL-terminated: a name in the middle of a word */
+const char	*env_getn(const t_env *env, const char *name, size_t n)
+{
+	const t_env_var	*v;
+
+	if (!env->cap)
+		return (NULL);
+	v = env_slot(env, name, n, aux_hash(name, n));
+	if (!v->kv || !v->set)
+		return (NULL);
+	return (v->kv + v->klen + 1);
+}
+
+/* Value of `name`, NULL when it is unset */
+const char	*env_get(const t_env *env, const char *name)
+{
+	const t_env_var	*v;
+
+	v = env_find((t_env *)env, name, false);
+	if (!v || !v->set)
+		return (NULL);
+	return (v->kv + v->klen + 1);
+}
+
+/* name=val. The export attribute is kept as it is */
+int	env_set(t_env *env, const char *name, const char *val)
+{
+	t_env_var	*v;
+	char		*kv;
+	size_t		vlen;
+
+	v = env_find(env, name, true);
+	if (!v)
+		return (0);
+	vlen = strlen(val);
+	kv = malloc(v->klen + vlen + 2);
+	if (!kv)
+		return (0);
+	memcpy(kv, name, v->klen);
+	kv[v->klen] = '=';
+	memcpy(kv + v->klen + 1, val, vlen + 1);
+	free(v->kv);
+	v->kv = kv;
+	v->set = true;
+	env->dirty |= v->exported;
+	return (1);
+}
+
+/* `export name` (creating the variable without a value if
+ * needed) or `export -n name` */
+int	env_export(t_env *env, const char *name, bool exported)
+{
+	t_env_var	*v;
+
+	v = env_find(env, name, exported);
+	if (!v)
+		return (!exported);
+	env->dirty |= (v->set && v->exported != exported);
+	v->exported = exported;
+	return (1);
+}
+
+void	env_unset(t_env *env, const char *name)
+{
+	t_env_var	*v;
+
+	v = env_find(env, name, false);
+	if (!v)
+		return ;
+	env->dirty |= (v->set && v->exported);
+	env_remove(env, v);
+}
+
+/* Environment for execve(2). The array stays valid until the
+ * next change of a variable. NULL on OOM */
+char	**env_envp(t_env *env)
+{
+	char	**envp;
+	size_t	i;
+	size_t	n;
+
+	if (!env->dirty)
+		return (env->envp);
+	envp = malloc((env->cnt + 1) * sizeof(*envp));
+	if (!envp)
+		return (NULL);
+	n = 0;
+	i = 0;
+	while (i < env->cap)
+	{
+		if (env->tab[i].kv && env->tab[i].set && env->tab[i].exported)
+			envp[n++] = env->tab[i].kv;
+		++i;
+	}
+	envp[n] = NULL;
+	free(env->envp);
+	env->envp = envp;
+	env->dirty = false;
+	++env->builds;
+	return (envp);
+}
+
+/* Is the `n`-byte string `s` a valid variable name? */
+bool	env_is_name(const char *s, size_t n)
+{
+	size_t	i;
+
+	if (!n || (!isalpha((unsigned char)*s) && *s != '_'))
+		return (false);
+	i = 1;
+	while (i < n && (isalnum((unsigned char)s[i]) || s[i] == '_'))
+		++i;
+	return (i == n);
+}
+
+/* Saves `name` as it is to `saved` (t_env_saved), before a change
+ * that env_restore() undoes. Returns 0 on OOM */
+int	env_save(t_env *env, t_vector *saved, const char *name)
+{
+	t_env_saved	sv;
+	t_env_var	*v;
+
+	v = env_find(env, name, false);
+	sv.name = strdup(name);
+	sv.kv = NULL;
+	sv.exported = v && v->exported;
+	if (sv.name && v)
+		sv.kv = strdup(v->kv);
+	if (sv.name && (!v || sv.kv) && vec_push(saved, &sv))
+		return (1);
+	free(sv.name);
+	free(sv.kv);
+	return (0);
+}
+
+/* Puts the variables of `saved` back as they were, the last change
+ * undone first, and empties it */
+void	env_restore(t_env *env, t_vector *saved)
+{
+	t_env_saved	*sv;
+	char		*eq;
+
+	while (saved->len)
+	{
+		sv = &VEC_LAST(saved, t_env_saved);
+		env_unset(env, sv->name);
+		eq = NULL;
+		if (sv->kv)
+			eq = strchr(sv->kv, '=');
+		if (eq)
+			env_set(env, sv->name, eq + 1);
+		if (sv->kv)
+			env_export(env, sv->name, sv->exported);
+		free(sv->name);
+		free(sv->kv);
+		vec_pop(saved);
+	}
+}
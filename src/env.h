@@ -0,0 +1,73 @@
+#ifndef ENV_H
+# define ENV_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+
+# include "vector.h"
+
+# define ENV_INIT_CAP	64
+
+/* One shell variable.
+ * kv		- "name=value", or just "name" for a variable that was
+ *			  exported but never given a value; NULL for an empty slot;
+ * klen		- length of the name;
+ * set		- the variable has a value (kv[klen] == '=');
+ * exported	- the variable is passed to children. */
+typedef struct s_env_var
+{
+	char		*kv;
+	size_t		klen;
+	uint64_t	hash;
+	bool		set;
+	bool		exported;
+}	t_env_var;
+
+/* Shell variables and the environment built from them.
+ * tab		- open addressing table, `cap` is a power of 2;
+ * envp		- NULL-terminated snapshot of the exported variables
+ *			  handed to execve(2). It points into the `kv` strings
+ *			  and is rebuilt only after an exported variable has
+ *			  changed (`dirty`), so starting a command does not
+ *			  copy the environment;
+ * builds	- how many times `envp` has been rebuilt. */
+typedef struct s_env
+{
+	t_env_var	*tab;
+	size_t		cap;
+	size_t		cnt;
+	char		**envp;
+	bool		dirty;
+	size_t		builds;
+}	t_env;
+
+/* A variable as it was before a change to be undone.
+ * name	- malloc(3)ed;
+ * kv	- its `kv`, malloc(3)ed, NULL if it did not exist. */
+typedef struct s_env_saved
+{
+	char	*name;
+	char	*kv;
+	bool	exported;
+}	t_env_saved;
+
+int			env_init(t_env *env, char **envp);
+void		env_free(t_env *env);
+const char	*env_get(const t_env *env, const char *name);
+const char	*env_getn(const t_env *env, const char *name, size_t n);
+int			env_set(t_env *env, const char *name, const char *val);
+int			env_export(t_env *env, const char *name, bool exported);
+void		env_unset(t_env *env, const char *name);
+char		**env_envp(t_env *env);
+bool		env_is_name(const char *s, size_t n);
+int			env_save(t_env *env, t_vector *saved, const char *name);
+void		env_restore(t_env *env, t_vector *saved);
+
+/* env_store.c */
+t_env_var	*env_slot(const t_env *env, const char *name, size_t klen,
+				uint64_t h);
+int			env_grow(t_env *env);
+void		env_remove(t_env *env, t_env_var *v);
+
+#endif
@@ -0,0 +1,50 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "env.h"
+#include "htab.h"
+
+/* Returns the slot holding the variable `name` (`klen` bytes)
+ * or the empty slot where it belongs. The table always has at
+ * least one empty slot */
+t_env_var	*env_slot(const t_env *env, const char *name, size_t klen,
+	uint64_t h)
+{
+	size_t	i;
+
+	i = h & (env->cap - 1);
+	while (env->tab[i].kv && (env->tab[i].hash != h
+			|| env->tab[i].klen != klen
+			|| memcmp(env->tab[i].kv, name, klen)))
+		i = (i + 1) & (env->cap - 1);
+	return (&env->tab[i]);
+}
+
+static size_t	env_home(const void *slot, size_t mask)
+{
+	return (((const t_env_var *)slot)->hash & mask);
+}
+
+static bool	env_used(const void *slot)
+{
+	return (((const t_env_var *)slot)->kv != NULL);
+}
+
+static const t_htab	g_env_htab = {
+	sizeof(t_env_var), ENV_INIT_CAP, env_home, env_used
+};
+
+/* Makes room for one more variable, see htab_grow() */
+int	env_grow(t_env *env)
+{
+	return (htab_grow(&g_env_htab, (void **)&env->tab, &env->cap,
+			env->cnt));
+}
+
+/* Empties the slot of `v`, see htab_remove() */
+void	env_remove(t_env *env, t_env_var *v)
+{
+	free(v->kv);
+	htab_remove(&g_env_htab, env->tab, env->cap, v - env->tab);
+	--env->cnt;
+}
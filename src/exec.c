@@ -0,0 +1,514 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "builtins.h"
+#include "compile.h"
+#include "exec.h"
+#include "expand.h"
+#include "launch.h"
+#include "pipesz.h"
+#include "redir.h"
+
+/* In a forked child that goes on running shell code and exits
+ * right after it */
+static void	exec_child(t_engine *eng)
+{
+	eng->subshell = true;
+	eng->tail = true;
+	jobs_free(&eng->jobs);
+	prof_drop(&eng->prof);
+	xtrace_drop(&eng->xtrace);
+}
+
+/* A process was started (or not) for the stage: `t0` is when,
+ * `argv` what it runs, NULL for a subshell */
+static void	exec_started(t_engine *eng, t_stage *st, char **argv,
+	int64_t t0)
+{
+	prof_span(&eng->prof, "spawn", t0);
+	st->start = t0;
+	if (st->pid <= 0)
+		return ;
+	if (argv)
+		prof_proc(&eng->prof, st->pid, argv[0]);
+	else
+		prof_proc(&eng->prof, st->pid, "(subshell)");
+	xtrace_spawn(&eng->xtrace, st->pid, argv);
+}
+
+/* Redirections win over the pipe ends. The overridden pipe ends
+ * must not leak into the child: a leaked write end would hide
+ * EOF from the next stage */
+static void	stage_fds(t_stage *st, t_redir_fds *fds, t_launch *l,
+	int *close_fds)
+{
+	l->close_fds = close_fds;
+	l->close_cnt = 0;
+	close_fds[l->close_cnt++] = st->spare;
+	l->fd_in = st->in;
+	if (fds->in != -1)
+	{
+		close_fds[l->close_cnt++] = st->in;
+		l->fd_in = fds->in;
+	}
+	l->fd_out = st->out;
+	if (fds->out != -1)
+	{
+		close_fds[l->close_cnt++] = st->out;
+		l->fd_out = fds->out;
+	}
+}
+
+/* Finds the executable and environment of an external command.
+ * Returns 1, or 0 with the status to give up with in `*status` */
+static int	exec_resolve(t_engine *eng, t_launch *l, int *status)
+{
+	l->path = l->argv[0];
+	if (!strchr(l->argv[0], '/'))
+		l->path = path_lookup(&eng->path, l->argv[0], engine_path_var(eng));
+	if (!l->path)
+	{
+		fprintf(stderr, "minishell: %s: command not found\n", l->argv[0]);
+		*status = LAUNCH_NOT_FOUND;
+		return (0);
+	}
+	l->envp = env_envp(&eng->env);
+	if (!l->envp)
+	{
+		perror("minishell");
+		*status = EXIT_FAILURE;
+		return (0);
+	}
+	return (1);
+}
+
+static void	exec_command(t_engine *eng, t_stage *st, t_launch *l)
+{
+	int64_t	t0;
+
+	if (!exec_resolve(eng, l, &st->status))
+		return ;
+	t0 = prof_now(&eng->prof);
+	st->pid = launch_spawn(l);
+	exec_started(eng, st, l->argv, t0);
+	if (st->pid == -1)
+		st->status = launch_err_status(errno);
+}
+
+/* A builtin that is a whole pipeline runs in the shell itself,
+ * its redirections put on the shell's stdin/stdout for the call.
+ * As a stage of a longer pipeline it runs in a forked child,
+ * which just exits with its status: there is nothing to execve */
+static void	exec_builtin(t_engine *eng, const t_builtin *bi, t_stage *st,
+	t_launch *l)
+{
+	t_redir_fds	saved;
+	int64_t		t0;
+
+	t0 = prof_now(&eng->prof);
+	if (st->in == -1 && st->out == -1)
+	{
+		if (redir_apply(l->fd_in, l->fd_out, &saved))
+		{
+			st->status = bi->fn(eng, l->argv);
+			redir_restore(&saved);
+		}
+		prof_span(&eng->prof, bi->name, t0);
+		xtrace_builtin(&eng->xtrace, l->argv, st->status);
+		return ;
+	}
+	st->pid = launch_fork(l);
+	if (st->pid > 0)
+		exec_started(eng, st, l->argv, t0);
+	if (st->pid == 0)
+	{
+		exec_child(eng);
+		exit(bi->fn(eng, l->argv));
+	}
+}
+
+/* Opens the redirections of `node`, their file names expanded,
+ * see redir_open() */
+static int	exec_redir(t_engine *eng, t_ast *node, t_redir_fds *fds)
+{
+	t_redi_node	*redi;
+	int64_t		t0;
+	int			ok;
+
+	t0 = prof_now(&eng->prof);
+	fds->in = -1;
+	fds->out = -1;
+	redi = node->redirections;
+	ok = expand_redirs(eng, &redi) && redir_open(&eng->heredocs, redi, fds);
+	if (node->redirections)
+		prof_span(&eng->prof, "redir", t0);
+	return (ok);
+}
+
+/* The argv of a command as it runs, see expand_argv(). NULL
+ * after a message when it could not be expanded */
+static char	**exec_argv(t_engine *eng, t_ast *node)
+{
+	char	**argv;
+	int64_t	t0;
+
+	t0 = prof_now(&eng->prof);
+	argv = expand_argv(eng, node->args);
+	if (argv != node->args)
+		prof_span(&eng->prof, "expand", t0);
+	return (argv);
+}
+
+/* Starts the stage once its words are expanded and its file
+ * descriptors set up: external commands are spawned, only
+ * subshells and groups get a real fork() since they run shell
+ * code */
+static void	exec_launch(t_engine *eng, t_ast *node, t_stage *st,
+	t_launch *l)
+{
+	const t_builtin	*bi;
+	int64_t			t0;
+
+	l->envp = NULL;
+	bi = NULL;
+	if (node->type == NODE_CMD && l->argv[0])
+		bi = builtin_find(l->argv);
+	if (node->type == NODE_SUBSHELL || node->type == NODE_GROUP)
+	{
+		t0 = prof_now(&eng->prof);
+		st->pid = launch_fork(l);
+		if (st->pid > 0)
+			exec_started(eng, st, NULL, t0);
+		if (st->pid == 0)
+		{
+			exec_child(eng);
+			exit(exec_ast(eng, node->left));
+		}
+	}
+	else if (bi)
+		exec_builtin(eng, bi, st, l);
+	else if (l->argv[0])
+		exec_command(eng, st, l);
+	else
+		st->status = EXIT_SUCCESS;
+}
+
+/* Starts one stage. A subshell, or a stage of a longer pipeline or
+ * of a background job, runs apart from the shell: the variables
+ * its expansion assigns are put back once it has started (see
+ * t_engine), and an expansion error that ends the shell
+ * (${x?word}) only ends the stage */
+static void	exec_stage(t_engine *eng, t_ast *node, t_stage *st)
+{
+	t_redir_fds		fds;
+	t_launch		l;
+	t_vector		undo;
+	int				close_fds[3];
+	bool			exiting;
+
+	st->pid = -1;
+	st->status = EXIT_FAILURE;
+	exiting = eng->exiting;
+	vec_init(&undo, sizeof(t_env_saved));
+	if (st->in != -1 || st->out != -1 || node->type == NODE_SUBSHELL)
+		eng->undo = &undo;
+	l.argv = node->args;
+	if (node->type == NODE_CMD)
+		l.argv = exec_argv(eng, node);
+	if ((node->type != NODE_CMD || l.argv) && exec_redir(eng, node, &fds))
+	{
+		eng->undo = NULL;
+		stage_fds(st, &fds, &l, close_fds);
+		exec_launch(eng, node, st, &l);
+		redir_close(&fds);
+	}
+	else if (eng->undo)
+		eng->exiting = exiting;
+	eng->undo = NULL;
+	env_restore(&eng->env, &undo);
+	vec_free(&undo);
+}
+
+/* Pipe sizing of this pipeline: $PIPESIZE when it is set and
+ * valid, --pipe-size otherwise */
+static void	exec_pipesz(t_engine *eng, t_pipesz *ps)
+{
+	const char	*var;
+
+	ps->mode = PIPESZ_DEFAULT;
+	if (eng->params->settings)
+		*ps = eng->params->settings->options.pipe_size;
+	var = env_get(&eng->env, PIPESZ_VAR);
+	if (var)
+		pipesz_parse(var, ps);
+}
+
+/* Starts the stages left to right. The shell holds at most one
+ * pipe plus the read end of the previous one at any time. Pipes
+ * are close-on-exec: a stage only gets the two ends it is given,
+ * whatever the length of the pipeline */
+static size_t	exec_stages(t_engine *eng, t_ast **stages, t_stage *st,
+	size_t n)
+{
+	t_pipesz	ps;
+	size_t		i;
+	int			in;
+	int			pfd[2];
+
+	if (n > 1)
+		exec_pipesz(eng, &ps);
+	in = st[0].in;
+	i = 0;
+	while (i < n)
+	{
+		pfd[0] = -1;
+		pfd[1] = -1;
+		if (i + 1 < n && pipe2(pfd, O_CLOEXEC) == -1)
+		{
+			perror("minishell: pipe");
+			break ;
+		}
+		if (i + 1 < n)
+			pipesz_apply(pfd[1], pipesz_for(&ps, stages[i], stages[i + 1]));
+		st[i].in = in;
+		st[i].out = pfd[1];
+		st[i].spare = pfd[0];
+		exec_stage(eng, stages[i], &st[i]);
+		if (in != -1)
+			close(in);
+		if (pfd[1] != -1)
+			close(pfd[1]);
+		in = pfd[0];
+		++i;
+	}
+	if (i < n && in != -1)
+		close(in);
+	return (i);
+}
+
+static size_t	count_stages(t_ast *node)
+{
+	size_t	n;
+
+	n = 1;
+	while (node->type == NODE_PIPE)
+	{
+		node = node->left;
+		++n;
+	}
+	return (n);
+}
+
+/* Adds the processes of the `started` stages to `job`, which is
+ * complete once the last stage has been started too */
+static void	exec_job(t_engine *eng, size_t job, t_stage *st, size_t started)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < started)
+	{
+		if (st[i].pid != -1 && !jobs_add(&eng->jobs, job, st[i].pid))
+			perror("minishell");
+		else if (st[i].pid != -1)
+			jobs_proc(&eng->jobs, st[i].pid)->start = st[i].start;
+		++i;
+	}
+}
+
+/* Opens the stdin of the first stage: a background job reads
+ * /dev/null, the others the shell's stdin (-1) */
+static int	exec_stdin(bool bg)
+{
+	int	in;
+
+	if (!bg)
+		return (-1);
+	in = open("/dev/null", O_RDONLY | O_CLOEXEC);
+	if (in == -1)
+		perror("minishell: /dev/null");
+	return (in);
+}
+
+/* Starts a pipeline (a single command or subshell is a pipeline
+ * of one stage) as a new job. The left-leaning PIPE spine is
+ * flattened into an array of stages first. Returns the job,
+ * JOBS_NONE if the pipeline could not be started at all */
+static size_t	exec_start(t_engine *eng, t_ast *node, bool bg)
+{
+	t_ast	**stages;
+	t_stage	*st;
+	size_t	n;
+	size_t	i;
+	size_t	job;
+
+	n = count_stages(node);
+	stages = arena_alloc(&eng->arena, n * sizeof(*stages));
+	st = arena_alloc(&eng->arena, n * sizeof(*st));
+	job = JOBS_NONE;
+	if (stages && st)
+		job = jobs_new(&eng->jobs, bg);
+	if (job == JOBS_NONE)
+	{
+		perror("minishell");
+		return (JOBS_NONE);
+	}
+	i = n;
+	while (node->type == NODE_PIPE)
+	{
+		stages[--i] = node->right;
+		node = node->left;
+	}
+	stages[0] = node;
+	st[0].in = exec_stdin(bg);
+	i = exec_stages(eng, stages, st, n);
+	exec_job(eng, job, st, i);
+	if (i == n)
+		jobs_seal(&eng->jobs, job, st[n - 1].pid, st[n - 1].status);
+	else
+		jobs_seal(&eng->jobs, job, -1, EXIT_FAILURE);
+	return (job);
+}
+
+/* A group that is a whole pipeline runs in the shell itself, its
+ * redirections put on the shell's stdin/stdout meanwhile. With
+ * `tail` the group is in tail position (see t_engine), and so is
+ * its own last command unless there are redirections to undo */
+static int	exec_group(t_engine *eng, t_ast *node, bool tail)
+{
+	t_redir_fds	fds;
+	t_redir_fds	saved;
+	bool		was_tail;
+	int			status;
+
+	status = EXIT_FAILURE;
+	if (exec_redir(eng, node, &fds))
+	{
+		if (redir_apply(fds.in, fds.out, &saved))
+		{
+			was_tail = eng->tail;
+			eng->tail = tail && !node->redirections;
+			status = exec_ast(eng, node->left);
+			eng->tail = was_tail;
+			redir_restore(&saved);
+		}
+		redir_close(&fds);
+	}
+	eng->status = status;
+	return (status);
+}
+
+/* Runs a pipeline in the foreground and collects it. Returns the
+ * status of its last stage */
+static int	exec_pipeline(t_engine *eng, t_ast *node)
+{
+	size_t	job;
+	int		status;
+
+	if (node->type == NODE_GROUP)
+		return (exec_group(eng, node, false));
+	job = exec_start(eng, node, false);
+	status = EXIT_FAILURE;
+	if (job != JOBS_NONE)
+	{
+		status = jobs_wait(&eng->jobs, job);
+		jobs_drop(&eng->jobs, job);
+	}
+	eng->status = status;
+	return (status);
+}
+
+/* `node &`: a pipeline is started as it is, an && / || list in a
+ * subshell of its own. Nothing waits for it */
+static int	exec_bg(t_engine *eng, t_ast *node)
+{
+	size_t	job;
+
+	if (node->type == NODE_AND || node->type == NODE_OR)
+		node = ast_new(&eng->arena, NODE_SUBSHELL, node, NULL);
+	if (!node)
+	{
+		perror("minishell");
+		return (EXIT_FAILURE);
+	}
+	job = exec_start(eng, node, true);
+	if (job != JOBS_NONE && engine_interactive(eng))
+		dprintf(STDERR_FILENO, "[%zu] %d\n", job,
+			jobs_at(&eng->jobs, job)->last);
+	eng->status = EXIT_SUCCESS;
+	return (EXIT_SUCCESS);
+}
+
+/* A command in tail position (see t_engine) replaces the shell,
+ * its redirections put on the shell's own stdin/stdout. Builtins,
+ * pipelines and subshells run as usual, a group passes the tail
+ * position on to its own last command. A command whose name only
+ * turns out to be a builtin (or nothing) once expanded runs as
+ * usual too, expanded again. Returns only if there was nothing
+ * to execve or it failed, with the status of the command */
+static int	exec_tail(t_engine *eng, t_ast *node)
+{
+	t_redir_fds	fds;
+	t_redir_fds	saved;
+	t_launch	l;
+	int			status;
+
+	if (node->type == NODE_GROUP)
+		return (exec_group(eng, node, true));
+	if (node->type != NODE_CMD || !node->args[0] || builtin_find(node->args))
+		return (exec_pipeline(eng, node));
+	l.argv = exec_argv(eng, node);
+	if (l.argv && (!l.argv[0] || builtin_find(l.argv)))
+		return (exec_pipeline(eng, node));
+	status = EXIT_FAILURE;
+	if (l.argv && exec_redir(eng, node, &fds))
+	{
+		if (exec_resolve(eng, &l, &status)
+			&& redir_apply(fds.in, fds.out, &saved))
+		{
+			launch_exec(&l);
+			status = launch_err_status(errno);
+			redir_restore(&saved);
+		}
+		redir_close(&fds);
+	}
+	eng->status = status;
+	return (status);
+}
+
+/* Executes a whole tree and returns its exit status. The tree is
+ * compiled into a flat program first, && and || become jumps: the
+ * loop below never recurses, however deep the tree */
+int	exec_ast(t_engine *eng, t_ast *node)
+{
+	t_prog	prog;
+	t_insn	*in;
+	size_t	pc;
+	int		status;
+
+	if (!compile_ast(&eng->arena, node, &prog))
+	{
+		perror("minishell");
+		return (EXIT_FAILURE);
+	}
+	status = EXIT_SUCCESS;
+	pc = 0;
+	while (pc < prog.len && !eng->exiting)
+	{
+		in = &prog.code[pc++];
+		if (in->op == OP_RUN && eng->tail && pc == prog.len)
+			status = exec_tail(eng, in->node);
+		else if (in->op == OP_RUN)
+			status = exec_pipeline(eng, in->node);
+		else if (in->op == OP_BG)
+			status = exec_bg(eng, in->node);
+		else if ((in->op == OP_JMP_FAIL) == (status != EXIT_SUCCESS))
+			pc = in->target;
+	}
+	return (status);
+}
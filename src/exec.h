@@ -0,0 +1,29 @@
+#ifndef EXEC_H
+# define EXEC_H
+
+# include <stdint.h>
+# include <sys/types.h>
+
+# include "ast.h"
+# include "engine.h"
+
+/* One command of a pipeline.
+ * in, out - pipe ends connected to its stdin/stdout (-1: none);
+ * spare   - read end of the pipe to the next stage, which
+ *			 this stage must not inherit (-1: none);
+ * pid	   - started process, -1 if nothing was started;
+ * status  - exit status when nothing was started;
+ * start   - when `pid` was started, see prof_now(). */
+typedef struct s_stage
+{
+	int		in;
+	int		out;
+	int		spare;
+	pid_t	pid;
+	int		status;
+	int64_t	start;
+}	t_stage;
+
+int	exec_ast(t_engine *eng, t_ast *node);
+
+#endif
@@ -0,0 +1,299 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "expand.h"
+#include "pattern.h"
+
+/* Prints "minishell: what: msg" (once) and stops the expansion */
+void	expand_fail(t_expand *ex, const char *what, const char *msg)
+{
+	if (!ex->err)
+		fprintf(stderr, "minishell: %s: %s\n", what, msg);
+	ex->err = true;
+}
+
+/* Ends the field being built: a copy goes to `fields` when it
+ * exists, or the paths it matches when it is a pattern that does.
+ * Without `fields` the word is one field, kept in `sb` */
+void	expand_field(t_expand *ex)
+{
+	char	*f;
+	bool	glob;
+
+	if (ex->mute || !ex->fields || !ex->have)
+		return ;
+	glob = ex->glob && expand_glob(ex);
+	if (!glob && ex->esc)
+		aux_sb_cut(ex->sb, pattern_unescape(ex->sb->buf, ex->sb->buf,
+				ex->sb->len));
+	f = NULL;
+	if (!glob && ex->sb->len)
+		f = arena_strndup(&ex->eng->arena, ex->sb->buf, ex->sb->len);
+	else if (!glob)
+		f = arena_strndup(&ex->eng->arena, "", 0);
+	if (!glob && (!f || !vec_push(ex->fields, &f)))
+		expand_fail(ex, "expansion", strerror(ENOMEM));
+	aux_sb_cut(ex->sb, 0);
+	ex->have = false;
+	ex->glob = false;
+	ex->esc = false;
+}
+
+/* Appends `n` bytes of `s` to the field, which is written as a
+ * pattern: a quoted `*`, `?`, `[`, `]`, and any `\`, get a backslash
+ * before them. An unquoted `*`, `?` or `[` makes the field one */
+static void	expand_copy(t_expand *ex, const char *s, size_t n)
+{
+	size_t	i;
+	bool	plain;
+	bool	esc;
+
+	plain = ex->dq || ex->quoted;
+	while (n)
+	{
+		i = 0;
+		while (i < n && !strchr("*?[]\\", s[i]))
+			++i;
+		if (i && !aux_sb_put(ex->sb, s, i))
+			expand_fail(ex, "expansion", strerror(ENOMEM));
+		if (i == n)
+			return ;
+		esc = plain || s[i] == '\\';
+		ex->esc = ex->esc || esc;
+		ex->glob = ex->glob || (!esc && s[i] != ']');
+		if ((esc && !aux_sb_putc(ex->sb, '\\'))
+			|| !aux_sb_putc(ex->sb, s[i]))
+			expand_fail(ex, "expansion", strerror(ENOMEM));
+		s += i + 1;
+		n -= i + 1;
+	}
+}
+
+/* Outputs `n` bytes of `s`. The result of an unquoted expansion
+ * (`split`) is cut into fields at blanks */
+void	expand_put(t_expand *ex, const char *s, size_t n, bool split)
+{
+	size_t	i;
+
+	if (ex->mute || ex->err)
+		return ;
+	split = split && !ex->dq && ex->fields;
+	while (n)
+	{
+		i = n;
+		if (split)
+			i = strcspn(s, EXPAND_IFS);
+		if (i > n)
+			i = n;
+		if (i && ex->fields)
+			expand_copy(ex, s, i);
+		else if (i && !aux_sb_put(ex->sb, s, i))
+			expand_fail(ex, "expansion", strerror(ENOMEM));
+		ex->have = ex->have || i;
+		if (i < n)
+			expand_field(ex);
+		while (i < n && strchr(EXPAND_IFS, s[i]))
+			++i;
+		s += i;
+		n -= i;
+	}
+}
+
+/* 'text': all of it as it is */
+static const char	*expand_squote(t_expand *ex, const char *p)
+{
+	const char	*end;
+
+	end = strchr(p + 1, '\'');
+	if (!end)
+		end = p + strlen(p);
+	ex->quoted = true;
+	expand_put(ex, p + 1, end - p - 1, false);
+	ex->quoted = false;
+	if (!ex->mute)
+		ex->have = true;
+	if (*end)
+		++end;
+	return (end);
+}
+
+/* "text": an argument even if empty, expanded but not split */
+static const char	*expand_dquote(t_expand *ex, const char *p)
+{
+	if (!ex->mute)
+		ex->have = true;
+	ex->dq = !ex->dq;
+	return (p + 1);
+}
+
+/* A backslash quotes the next byte. In double quotes only before
+ * $ ` " \ } or a newline, in a here-document before $ ` \ or a
+ * newline, otherwise it stays */
+static const char	*expand_escape(t_expand *ex, const char *p)
+{
+	const char	*quotes;
+
+	quotes = "$`\"\\}\n";
+	if (ex->doc)
+		quotes = "$`\\\n";
+	if (!p[1] || (ex->dq && !strchr(quotes, p[1])))
+	{
+		expand_put(ex, p, 1, false);
+		return (p + 1);
+	}
+	ex->quoted = true;
+	if (p[1] != '\n')
+		expand_put(ex, p + 1, 1, false);
+	ex->quoted = false;
+	return (p + 2);
+}
+
+/* Expands the text from `p` until a byte of `stop` that is not
+ * quoted (the end of the string with ""). Returns where it
+ * stopped */
+const char	*expand_text(t_expand *ex, const char *p, const char *stop)
+{
+	char	set[16];
+	bool	dq;
+	size_t	n;
+
+	dq = ex->dq;
+	strcpy(set, EXPAND_SPECIAL);
+	strncat(set, stop, sizeof(set) - strlen(set) - 1);
+	while (*p && !ex->err && (ex->dq != dq || !strchr(stop, *p)))
+	{
+		n = strcspn(p, set);
+		if (n)
+			expand_put(ex, p, n, ex->split);
+		p += n;
+		if (*p == '"' && !ex->doc)
+			p = expand_dquote(ex, p);
+		else if (*p == '\'' && !ex->dq)
+			p = expand_squote(ex, p);
+		else if (*p == '\\')
+			p = expand_escape(ex, p);
+		else if (*p == '$')
+			p = expand_dollar(ex, p + 1);
+		else if (*p && (ex->dq != dq || !strchr(stop, *p)))
+			expand_put(ex, p++, 1, ex->split);
+	}
+	return (p);
+}
+
+/* Expands `word` into `ex->fields`, or into `ex->sb` alone */
+static int	expand_word(t_expand *ex, const char *word)
+{
+	ex->have = false;
+	ex->glob = false;
+	ex->esc = false;
+	ex->dq = false;
+	ex->mute = 0;
+	ex->split = false;
+	aux_sb_cut(ex->sb, 0);
+	expand_text(ex, word, "");
+	expand_field(ex);
+	return (!ex->err);
+}
+
+/* The argv of a command as it runs: every word expanded, split
+ * into fields, matched against file names and its quotes removed.
+ * Plain words are used as they are: a command without $, quotes,
+ * backslashes or patterns costs no copy at all. Returns NULL
+ * after printing a message */
+char	**expand_argv(t_engine *eng, char **args)
+{
+	t_expand	ex;
+	char		**argv;
+	size_t		i;
+
+	i = 0;
+	while (args[i] && !strpbrk(args[i], EXPAND_SPECIAL))
+		++i;
+	if (!args[i])
+		return (args);
+	memset(&ex, 0, sizeof(ex));
+	ex.eng = eng;
+	ex.sb = &eng->words;
+	ex.fields = &eng->fields;
+	vec_clear(ex.fields);
+	dircache_tick(&eng->dirs);
+	i = 0;
+	while (args[i] && !ex.err)
+	{
+		if (strpbrk(args[i], EXPAND_SPECIAL))
+			expand_word(&ex, args[i]);
+		else if (!vec_push(ex.fields, &args[i]))
+			expand_fail(&ex, "expansion", strerror(ENOMEM));
+		++i;
+	}
+	argv = arena_alloc(&eng->arena, (ex.fields->len + 1) * sizeof(*argv));
+	if (!argv && !ex.err)
+		expand_fail(&ex, "expansion", strerror(ENOMEM));
+	if (ex.err)
+		return (NULL);
+	memcpy(argv, vec_data(ex.fields), ex.fields->len * sizeof(*argv));
+	argv[ex.fields->len] = NULL;
+	return (argv);
+}
+
+/* The file name of a redirection must stay one field */
+static char	*expand_target(t_engine *eng, const char *word)
+{
+	t_expand	ex;
+
+	memset(&ex, 0, sizeof(ex));
+	ex.eng = eng;
+	ex.sb = &eng->words;
+	ex.fields = &eng->fields;
+	vec_clear(ex.fields);
+	if (!expand_word(&ex, word))
+		return (NULL);
+	if (ex.fields->len != 1)
+	{
+		expand_fail(&ex, word, "ambiguous redirect");
+		return (NULL);
+	}
+	return (VEC_AT(ex.fields, char *, 0));
+}
+
+/* Replaces `*list` by a copy with the file names expanded, when
+ * one needs it. The delimiter of a here-document stays: it is the
+ * key of its body, which is expanded instead. Returns 0 after
+ * printing a message */
+int	expand_redirs(t_engine *eng, t_redi_node **list)
+{
+	t_redi_node	*r;
+	t_redi_node	*head;
+	t_redi_node	**tail;
+
+	if (!expand_heredocs(eng, *list))
+		return (0);
+	r = *list;
+	while (r && (r->type == T_HEREDOC || !strpbrk(r->filename,
+				EXPAND_SPECIAL)))
+		r = r->next;
+	if (!r)
+		return (1);
+	dircache_tick(&eng->dirs);
+	head = NULL;
+	tail = &head;
+	r = *list;
+	while (r)
+	{
+		*tail = redi_new(&eng->arena, r->type, r->filename);
+		if (!*tail)
+		{
+			perror("minishell");
+			return (0);
+		}
+		if (r->type != T_HEREDOC && strpbrk(r->filename, EXPAND_SPECIAL))
+			(*tail)->filename = expand_target(eng, r->filename);
+		if (!(*tail)->filename)
+			return (0);
+		tail = &(*tail)->next;
+		r = r->next;
+	}
+	*list = head;
+	return (1);
+}
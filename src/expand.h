@@ -0,0 +1,79 @@
+#ifndef EXPAND_H
+# define EXPAND_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "ast.h"
+# include "engine.h"
+
+/* Bytes that make a word need expanding, or matching against file
+ * names: without any of them the word is used as it was written */
+# define EXPAND_SPECIAL	"$'\"\\*?["
+/* Room for a numeric parameter ($?, $$, ${#x}...) */
+# define EXPAND_NUM_MAX	24
+/* Blanks that split the result of an unquoted expansion */
+# define EXPAND_IFS		" \t\n"
+
+/* The expansion of one word, in a single pass over its text:
+ * parameters are expanded, quotes removed and fields split as
+ * the word is walked, straight into `sb`.
+ * eng	  - variables and special parameters;
+ * sb	  - the field being built, the engine's buffer;
+ * fields - finished fields (char * in the arena), NULL when the
+ *			word stays one field;
+ * have	  - the field being built exists even if it is empty: it
+ *			had text or quotes ("" is an argument, $EMPTY is not);
+ * dq	  - inside double quotes: no splitting, `'` is plain;
+ * quoted - the bytes being output are quoted ('...', \x);
+ * glob	  - the field has a `*`, `?` or `[` that is not quoted: it is
+ *			a pattern, expanded to the paths it matches;
+ * esc	  - a quoted byte of the field has a backslash before it,
+ *			so that it stays plain if the field is a pattern;
+ * mute	  - above 0, the text is only walked over (the word of
+ *			${x:-word} when x is set): nothing is output, nothing
+ *			assigned;
+ * split  - the text is the word of ${x:-word} or ${x:+word} in
+ *			use: unquoted, it is split like a value;
+ * doc	  - the text is the body of a here-document: quotes are
+ *			plain bytes, a backslash only quotes $ ` \ and a newline;
+ * err	  - a message was printed, the command does not run. */
+typedef struct s_expand
+{
+	t_engine	*eng;
+	t_strbuf	*sb;
+	t_vector	*fields;
+	bool		have;
+	bool		dq;
+	bool		quoted;
+	bool		glob;
+	bool		esc;
+	int			mute;
+	bool		split;
+	bool		doc;
+	bool		err;
+}	t_expand;
+
+char		**expand_argv(t_engine *eng, char **args);
+int			expand_redirs(t_engine *eng, t_redi_node **list);
+const char	*expand_text(t_expand *ex, const char *p, const char *stop);
+void		expand_put(t_expand *ex, const char *s, size_t n, bool split);
+void		expand_field(t_expand *ex);
+void		expand_fail(t_expand *ex, const char *what, const char *msg);
+
+/* expand_param.c */
+size_t		expand_name_len(const char *p, bool braces);
+const char	*expand_value(t_engine *eng, const char *p, size_t n, char *num);
+void		expand_all(t_expand *ex, char c);
+const char	*expand_dollar(t_expand *ex, const char *p);
+
+/* expand_brace.c */
+const char	*expand_brace(t_expand *ex, const char *p);
+
+/* expand_doc.c */
+int			expand_heredocs(t_engine *eng, t_redi_node *redi);
+
+/* expand_glob.c */
+size_t		expand_glob(t_expand *ex);
+
+#endif
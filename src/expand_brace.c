@@ -0,0 +1,318 @@
+#include <errno.h>
+#include <fnmatch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "expand.h"
+
+/* A ${...} being expanded.
+ * start - its `$`, for messages;
+ * name  - the `n` bytes of the parameter name;
+ * val	 - its value, NULL when it is unset;
+ * num	 - where a numeric value is written. */
+typedef struct s_brace
+{
+	const char	*start;
+	const char	*name;
+	size_t		n;
+	const char	*val;
+	char		num[EXPAND_NUM_MAX];
+}	t_brace;
+
+/* Prints "minishell: <the ${...}>: msg" and stops the expansion.
+ * Returns the end of the word */
+static const char	*expand_bad(t_expand *ex, const t_brace *b,
+	const char *msg)
+{
+	const char	*end;
+
+	end = strchr(b->start, '}');
+	if (!end)
+		end = b->start + strlen(b->start) - 1;
+	if (!ex->err)
+		fprintf(stderr, "minishell: %.*s: %s\n",
+			(int)(end - b->start + 1), b->start, msg);
+	ex->err = true;
+	return (b->start + strlen(b->start));
+}
+
+/* Expands the text from `p` to a byte of `stop` as one string,
+ * not split, at the end of `sb` from `*mark` on: the word of
+ * ${x:=word}, a pattern, an offset. The caller cuts it off */
+static const char	*expand_raw(t_expand *ex, const char *p,
+	const char *stop, size_t *mark)
+{
+	t_vector	*fields;
+	bool		have;
+
+	fields = ex->fields;
+	have = ex->have;
+	*mark = ex->sb->len;
+	ex->fields = NULL;
+	p = expand_text(ex, p, stop);
+	ex->fields = fields;
+	ex->have = have;
+	if (!ex->sb->buf && !aux_sb_put(ex->sb, "", 0))
+		expand_fail(ex, "expansion", strerror(ENOMEM));
+	return (p);
+}
+
+/* ${x:=word}: x is set to the word first, see t_engine `undo` */
+static const char	*expand_assign(t_expand *ex, t_brace *b, const char *p)
+{
+	size_t	mark;
+	char	*name;
+
+	if (!ex->mute && !env_is_name(b->name, b->n))
+		return (expand_bad(ex, b, "cannot assign in this way"));
+	p = expand_raw(ex, p, "}", &mark);
+	if (!ex->mute && !ex->err)
+	{
+		name = arena_strndup(&ex->eng->arena, b->name, b->n);
+		if (!name || (ex->eng->undo
+				&& !env_save(&ex->eng->env, ex->eng->undo, name))
+			|| !env_set(&ex->eng->env, name, ex->sb->buf + mark))
+			expand_fail(ex, "expansion", strerror(ENOMEM));
+	}
+	aux_sb_cut(ex->sb, mark);
+	b->val = env_getn(&ex->eng->env, b->name, b->n);
+	if (b->val)
+		expand_put(ex, b->val, strlen(b->val), true);
+	return (p + (*p == '}'));
+}
+
+/* ${x:?word}: the command fails, with the word as the message. A
+ * shell that is not interactive exits after it */
+static const char	*expand_unset(t_expand *ex, t_brace *b, const char *p)
+{
+	size_t		mark;
+	const char	*msg;
+
+	p = expand_raw(ex, p, "}", &mark);
+	if (!ex->mute && !ex->err)
+	{
+		msg = ex->sb->buf + mark;
+		if (!*msg)
+			msg = "parameter null or not set";
+		fprintf(stderr, "minishell: %.*s: %s\n", (int)b->n, b->name, msg);
+		ex->err = true;
+		if (!engine_interactive(ex->eng))
+			ex->eng->exiting = true;
+	}
+	aux_sb_cut(ex->sb, mark);
+	return (p + (*p == '}'));
+}
+
+/* ${x-word} ${x=word} ${x+word} ${x?word}, and with `colon` the
+ * same forms with `:`, for which an empty x counts as unset. `p`
+ * is at the operator. The word that is not used is walked over,
+ * the one that is is split where it is not quoted */
+static const char	*expand_alt(t_expand *ex, t_brace *b, const char *p,
+	bool colon)
+{
+	char	op;
+	bool	use;
+	bool	split;
+
+	op = *p++;
+	use = !b->val || (colon && !*b->val);
+	if (op == '+')
+		use = !use;
+	if (!use && op != '+')
+		expand_put(ex, b->val, strlen(b->val), true);
+	if (use && op == '=')
+		return (expand_assign(ex, b, p));
+	if (use && op == '?')
+		return (expand_unset(ex, b, p));
+	split = ex->split;
+	ex->split = use;
+	if (!use)
+		++ex->mute;
+	p = expand_text(ex, p, "}");
+	if (!use)
+		--ex->mute;
+	ex->split = split;
+	return (p + (*p == '}'));
+}
+
+/* The number written from `mark` on in `sb`, blanks around it
+ * allowed, 0 when there is nothing. Returns 0 if it is not one */
+static int	expand_number(t_expand *ex, size_t mark, long *n)
+{
+	const char	*s;
+	char		*end;
+
+	s = ex->sb->buf + mark;
+	errno = 0;
+	*n = strtol(s, &end, 10);
+	while (*end && strchr(EXPAND_IFS, *end))
+		++end;
+	aux_sb_cut(ex->sb, mark);
+	return (!errno && !*end);
+}
+
+/* ${x:offset} and ${x:offset:length}. A negative offset counts
+ * from the end (it needs a blank after the `:`), so does a
+ * negative length for the end of the substring */
+static const char	*expand_sub(t_expand *ex, t_brace *b, const char *p)
+{
+	size_t	mark;
+	long	off;
+	long	len;
+	long	vlen;
+	int		ok;
+
+	p = expand_raw(ex, p, ":}", &mark);
+	ok = expand_number(ex, mark, &off);
+	vlen = 0;
+	if (b->val)
+		vlen = strlen(b->val);
+	len = vlen;
+	if (ok && *p == ':')
+	{
+		p = expand_raw(ex, p + 1, "}", &mark);
+		ok = expand_number(ex, mark, &len);
+	}
+	if (!ok && !ex->mute)
+		return (expand_bad(ex, b, "bad substitution"));
+	if (off < 0)
+		off += vlen;
+	if (off < 0 || off > vlen)
+		off = vlen;
+	if (len < 0)
+		len += vlen - off;
+	if (len > vlen - off)
+		len = vlen - off;
+	if (len > 0)
+		expand_put(ex, b->val + off, len, true);
+	return (p + (*p == '}'));
+}
+
+/* Where the part of `val` matching `pat` starts (`op` '%': the
+ * suffix) or ends ('#': the prefix), the shortest one or with
+ * `longest` the longest one; -1 if none. `val` is a copy that is
+ * cut in place for fnmatch(3) */
+static long	expand_match(char *val, const char *pat, char op, bool longest)
+{
+	long	vlen;
+	long	i;
+	long	k;
+	int		match;
+	char	c;
+
+	vlen = strlen(val);
+	k = 0;
+	while (k <= vlen)
+	{
+		i = k;
+		if ((op == '#') == longest)
+			i = vlen - k;
+		c = val[i];
+		if (op == '#')
+			val[i] = '\0';
+		match = !fnmatch(pat, val + (op == '%') * i, 0);
+		val[i] = c;
+		if (match)
+			return (i);
+		++k;
+	}
+	return (-1);
+}
+
+/* ${x#pattern} ${x##pattern} ${x%pattern} ${x%%pattern}: x without
+ * its shortest (longest) prefix (suffix) matching the pattern. The
+ * pattern and a copy of x to match it against go after the field
+ * in `sb` for the time being */
+static const char	*expand_trim(t_expand *ex, t_brace *b, const char *p)
+{
+	size_t	mark;
+	size_t	vlen;
+	long	i;
+	char	op;
+	bool	longest;
+
+	op = *p;
+	longest = (p[1] == op);
+	p = expand_raw(ex, p + 1 + longest, "}", &mark);
+	if (!b->val)
+		b->val = "";
+	vlen = strlen(b->val);
+	if (!ex->mute && !ex->err && (!aux_sb_putc(ex->sb, '\0')
+			|| !aux_sb_put(ex->sb, b->val, vlen)))
+		expand_fail(ex, "expansion", strerror(ENOMEM));
+	i = -1;
+	if (!ex->mute && !ex->err)
+		i = expand_match(ex->sb->buf + ex->sb->len - vlen,
+				ex->sb->buf + mark, op, longest);
+	aux_sb_cut(ex->sb, mark);
+	if (op == '#' && i > 0)
+		expand_put(ex, b->val + i, vlen - i, true);
+	else if (op == '%' && i >= 0)
+		expand_put(ex, b->val, i, true);
+	else
+		expand_put(ex, b->val, vlen, true);
+	return (p + (*p == '}'));
+}
+
+/* ${#x}: the length of x, ${#} ${#@} ${#*} the number of
+ * positional parameters */
+static const char	*expand_length(t_expand *ex, t_brace *b, const char *p)
+{
+	size_t	argc;
+	size_t	n;
+
+	if (*p != '}')
+		return (expand_bad(ex, b, "bad substitution"));
+	argc = ex->eng->params->pos_argc;
+	n = argc - (argc > 0);
+	if (*b->name != '@' && *b->name != '*')
+	{
+		b->val = expand_value(ex->eng, b->name, b->n, b->num);
+		n = 0;
+		if (b->val)
+			n = strlen(b->val);
+	}
+	snprintf(b->num, sizeof(b->num), "%zu", n);
+	expand_put(ex, b->num, strlen(b->num), false);
+	return (p + 1);
+}
+
+/* ${...}, `p` just after the brace: the parameter, then what is
+ * done with it. Returns the end of the ${...} */
+const char	*expand_brace(t_expand *ex, const char *p)
+{
+	t_brace	b;
+	bool	length;
+
+	b.start = p - 2;
+	length = (*p == '#' && p[1] != '}');
+	p += length;
+	b.name = p;
+	b.n = expand_name_len(p, true);
+	p += b.n;
+	if (!b.n)
+		return (expand_bad(ex, &b, "bad substitution"));
+	if (length)
+		return (expand_length(ex, &b, p));
+	if ((*b.name == '@' || *b.name == '*') && *p != '}')
+		return (expand_bad(ex, &b, "bad substitution"));
+	if (*b.name == '@' || *b.name == '*')
+		expand_all(ex, *b.name);
+	if (*b.name == '@' || *b.name == '*')
+		return (p + 1);
+	b.val = expand_value(ex->eng, b.name, b.n, b.num);
+	if (*p == '}' && b.val)
+		expand_put(ex, b.val, strlen(b.val), true);
+	if (*p == '}')
+		return (p + 1);
+	if (*p == ':' && p[1] && strchr("-=+?", p[1]))
+		return (expand_alt(ex, &b, p + 1, true));
+	if (*p && strchr("-=+?", *p))
+		return (expand_alt(ex, &b, p, false));
+	if (*p == ':')
+		return (expand_sub(ex, &b, p + 1));
+	if (*p == '#' || *p == '%')
+		return (expand_trim(ex, &b, p));
+	return (expand_bad(ex, &b, "bad substitution"));
+}
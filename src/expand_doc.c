@@ -0,0 +1,70 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "expand.h"
+#include "heredoc.h"
+
+/* Reads what is left of the body on `fd` into `sb` */
+static int	doc_read(int fd, t_strbuf *sb)
+{
+	char	buf[4096];
+	ssize_t	n;
+
+	n = 1;
+	while (n)
+	{
+		n = read(fd, buf, sizeof(buf));
+		if (n == -1 && errno != EINTR)
+			return (0);
+		if (n > 0 && !aux_sb_put(sb, buf, n))
+			return (0);
+	}
+	return (1);
+}
+
+/* Expands the body of `hd` like a word in double quotes, but
+ * where quotes are plain bytes, and puts the result in its
+ * place. Returns 0 after printing a message */
+static int	doc_expand(t_engine *eng, t_heredoc *hd)
+{
+	t_strbuf	body;
+	t_expand	ex;
+
+	memset(&ex, 0, sizeof(ex));
+	ex.eng = eng;
+	ex.sb = &eng->words;
+	ex.dq = true;
+	ex.doc = true;
+	aux_sb_cut(ex.sb, 0);
+	aux_sb_init(&body);
+	if (!doc_read(hd->fd, &body))
+		expand_fail(&ex, "here-document", strerror(errno));
+	else if (body.buf)
+		expand_text(&ex, body.buf, "");
+	aux_sb_free(&body);
+	if (!ex.err && (!aux_sb_put(ex.sb, "", 0)
+			|| !heredoc_replace(hd, ex.sb->buf, ex.sb->len)))
+		expand_fail(&ex, "here-document", strerror(errno));
+	return (!ex.err);
+}
+
+/* Expands the bodies of the here-documents among `redi` whose
+ * delimiter is unquoted, see t_heredoc. A body is read before the
+ * prompt runs, but expanded only when its command starts, as
+ * bash does. Returns 0 after printing a message */
+int	expand_heredocs(t_engine *eng, t_redi_node *redi)
+{
+	t_heredoc	*hd;
+
+	while (redi)
+	{
+		hd = NULL;
+		if (redi->type == T_HEREDOC)
+			hd = heredoc_find(&eng->heredocs, redi->filename);
+		if (hd && hd->expand && !doc_expand(eng, hd))
+			return (0);
+		redi = redi->next;
+	}
+	return (1);
+}
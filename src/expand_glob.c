@@ -0,0 +1,281 @@
+#include <dirent.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "expand.h"
+#include "globwalk.h"
+
+/* comps - the `n` components;
+ * rec	 - the first `**` among them, the walk stops there;
+ * roots - the directories to match it in (char *);
+ * found - paths added to the fields so far. */
+typedef struct s_glob
+{
+	t_expand	*ex;
+	t_glob_comp	*comps;
+	size_t		n;
+	size_t		rec;
+	t_vector	roots;
+	size_t		found;
+}	t_glob;
+
+static int	glob_cmp(const void *a, const void *b)
+{
+	return (strcmp(*(char *const *)a, *(char *const *)b));
+}
+
+/* `prefix`, `name` and `slash` one after the other, in the arena */
+static char	*glob_path(t_glob *g, const char *prefix, const char *name,
+	const char *slash)
+{
+	size_t	plen;
+	size_t	nlen;
+	size_t	slen;
+	char	*path;
+
+	plen = strlen(prefix);
+	nlen = strlen(name);
+	slen = strlen(slash);
+	path = arena_alloc(&g->ex->eng->arena, plen + nlen + slen + 1);
+	if (!path)
+	{
+		expand_fail(g->ex, "expansion", strerror(ENOMEM));
+		return (NULL);
+	}
+	memcpy(path, prefix, plen);
+	memcpy(path + plen, name, nlen);
+	memcpy(path + plen + nlen, slash, slen + 1);
+	return (path);
+}
+
+static void	glob_walk(t_glob *g, size_t i, const char *prefix);
+
+/* `name` in the directory `prefix` matched component `i` */
+static void	glob_found(t_glob *g, size_t i, const char *prefix,
+	const char *name)
+{
+	char		*path;
+	struct stat	st;
+
+	if (i + 1 < g->n)
+		path = glob_path(g, prefix, name, "/");
+	else
+		path = glob_path(g, prefix, name, "");
+	if (!path)
+		return ;
+	if (i + 1 < g->n)
+		glob_walk(g, i + 1, path);
+	else if (!g->comps[i].pat && lstat(path, &st) == -1)
+		return ;
+	else if (!vec_push(g->ex->fields, &path))
+		expand_fail(g->ex, "expansion", strerror(ENOMEM));
+	else
+		++g->found;
+}
+
+/* Whether the entry `e` of `prefix` is a directory, or a link to
+ * one: only those are looked into */
+static bool	glob_is_dir(t_glob *g, const char *prefix, const t_dirent64 *e)
+{
+	struct stat	st;
+	char		*path;
+
+	if (e->type == DT_DIR)
+		return (true);
+	if (e->type != DT_LNK && e->type != DT_UNKNOWN)
+		return (false);
+	path = glob_path(g, prefix, e->name, "");
+	return (path && stat(path, &st) == 0 && S_ISDIR(st.st_mode));
+}
+
+/* Whether `name` is `.` or `..`, which no pattern matches */
+static bool	glob_dots(const char *name)
+{
+	return (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])));
+}
+
+/* Matches component `i` and the ones after it in the directory
+ * `prefix` ("" or ending with `/`). The listing comes from the
+ * cache, a directory is read once per command however many
+ * patterns look into it. A `**` is left to glob_rec() */
+static void	glob_walk(t_glob *g, size_t i, const char *prefix)
+{
+	t_dirlist	*dl;
+	t_dirent64	*e;
+	const char	*ents;
+	size_t		len;
+	size_t		off;
+
+	if (g->comps[i].rec)
+	{
+		g->rec = i;
+		if (!vec_push(&g->roots, &prefix))
+			expand_fail(g->ex, "expansion", strerror(ENOMEM));
+		return ;
+	}
+	if (!g->comps[i].pat)
+	{
+		glob_found(g, i, prefix, g->comps[i].text);
+		return ;
+	}
+	dl = dircache_get(&g->ex->eng->dirs, prefix);
+	if (!dl)
+		return ;
+	ents = dl->ents;
+	len = dl->len;
+	off = 0;
+	while (off < len && !g->ex->err)
+	{
+		e = (t_dirent64 *)(ents + off);
+		off += e->reclen;
+		if (!glob_dots(e->name) && pattern_match(g->comps[i].pat, e->name)
+			&& (i + 1 == g->n || glob_is_dir(g, prefix, e)))
+			glob_found(g, i, prefix, e->name);
+	}
+}
+
+/* Adds the component of the `n` bytes at `p`. `**` after `**` is
+ * the same as one */
+static int	glob_comp(t_glob *g, const char *p, size_t n)
+{
+	t_glob_comp	*c;
+	bool		literal;
+	bool		rec;
+
+	rec = (n == 2 && p[0] == '*' && p[1] == '*');
+	if (rec && g->n && g->comps[g->n - 1].rec)
+		return (1);
+	literal = rec || pattern_is_literal(p, n);
+	c = g->comps + g->n++;
+	c->text = arena_strndup(&g->ex->eng->arena, p, n);
+	c->pat = NULL;
+	c->rec = rec;
+	if (c->text && !literal)
+		c->pat = arena_alloc(&g->ex->eng->arena, sizeof(*c->pat));
+	if (!c->text || (!literal && !c->pat))
+	{
+		expand_fail(g->ex, "expansion", strerror(ENOMEM));
+		return (0);
+	}
+	if (literal && !rec)
+		c->text[pattern_unescape(c->text, c->text, n)] = '\0';
+	else if (!rec)
+		pattern_compile(c->pat, c->text, n);
+	return (1);
+}
+
+/* Cuts the field into components, compiling the ones that are
+ * patterns. A trailing `/` leaves an empty last one: only
+ * directories match. Returns 0 if no component is a pattern */
+static int	glob_split(t_glob *g, const char *p, size_t n)
+{
+	size_t	k;
+	size_t	i;
+	bool	last;
+
+	last = false;
+	while (!last)
+	{
+		k = 0;
+		while (k < n && p[k] != '/')
+			k += 1 + (p[k] == '\\' && k + 1 < n);
+		if (!glob_comp(g, p, k))
+			return (0);
+		last = (k >= n);
+		p += k + !last;
+		n -= k + !last;
+	}
+	i = 0;
+	while (i < g->n && !g->comps[i].pat && !g->comps[i].rec)
+		++i;
+	return (i < g->n);
+}
+
+/* Walkers for a `**`: --glob-threads, by default one per CPU */
+static size_t	glob_threads(t_engine *eng)
+{
+	long	n;
+
+	n = 0;
+	if (eng->params->settings)
+		n = eng->params->settings->options.glob_threads;
+	if (n <= 0)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n > GLOBWALK_THREADS_MAX)
+		n = GLOBWALK_THREADS_MAX;
+	if (n < 1)
+		n = 1;
+	return (n);
+}
+
+/* The `**` of the pattern, from each of `roots`, walked by as many
+ * threads as there are CPUs. What they found is added to the
+ * fields, to be sorted with the rest */
+static void	glob_rec(t_glob *g)
+{
+	t_globwalk	gw;
+	const char	*p;
+	char		*f;
+	size_t		i;
+	size_t		k;
+
+	memset(&gw, 0, sizeof(gw));
+	gw.comps = g->comps;
+	gw.n = g->n;
+	gw.nworkers = glob_threads(g->ex->eng);
+	if (!globwalk(&gw, vec_data(&g->roots), g->roots.len, g->rec))
+		expand_fail(g->ex, "expansion", strerror(ENOMEM));
+	i = 0;
+	while (!g->ex->err && i < gw.nworkers)
+	{
+		p = gw.workers[i].found.buf;
+		k = 0;
+		while (!g->ex->err && k++ < gw.workers[i].nfound)
+		{
+			f = arena_strndup(&g->ex->eng->arena, p, strlen(p));
+			if (!f || !vec_push(g->ex->fields, &f))
+				expand_fail(g->ex, "expansion", strerror(ENOMEM));
+			p += strlen(p) + 1;
+			++g->found;
+		}
+		++i;
+	}
+	globwalk_free(&gw);
+}
+
+/* Pathname expansion of the field in `sb`, a pattern whose quoted
+ * bytes have a backslash before them. The paths it matches are
+ * added to the fields, sorted. Returns how many, 0 if none: the
+ * field is then kept as it is */
+size_t	expand_glob(t_expand *ex)
+{
+	t_glob	g;
+	size_t	start;
+	size_t	slashes;
+	size_t	i;
+
+	slashes = 0;
+	i = 0;
+	while (i < ex->sb->len)
+		slashes += (ex->sb->buf[i++] == '/');
+	memset(&g, 0, sizeof(g));
+	g.ex = ex;
+	vec_init(&g.roots, sizeof(char *));
+	g.comps = arena_alloc(&ex->eng->arena, (slashes + 1) * sizeof(*g.comps));
+	if (!g.comps)
+		expand_fail(ex, "expansion", strerror(ENOMEM));
+	if (!g.comps || !glob_split(&g, ex->sb->buf, ex->sb->len))
+		return (0);
+	start = ex->fields->len;
+	glob_walk(&g, 0, "");
+	if (g.roots.len && !ex->err)
+		glob_rec(&g);
+	vec_free(&g.roots);
+	if (g.found > 1)
+		qsort((char **)vec_data(ex->fields) + start, g.found,
+			sizeof(char *), glob_cmp);
+	return (g.found);
+}
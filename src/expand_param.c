@@ -0,0 +1,118 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "expand.h"
+
+/* Length of the parameter name at `p`: a variable name, one digit
+ * (a run of digits with `braces`, ${10}) or a special parameter.
+ * 0 if there is none */
+size_t	expand_name_len(const char *p, bool braces)
+{
+	size_t	n;
+
+	if (isalpha((unsigned char)*p) || *p == '_')
+	{
+		n = 1;
+		while (isalnum((unsigned char)p[n]) || p[n] == '_')
+			++n;
+		return (n);
+	}
+	if (!isdigit((unsigned char)*p))
+		return (*p && strchr("?!$#@*", *p));
+	n = 1;
+	while (braces && isdigit((unsigned char)p[n]))
+		++n;
+	return (n);
+}
+
+/* $0, $1...: pos_argv[0] is $0, the script or the name given
+ * after -c */
+static const char	*expand_positional(t_engine *eng, const char *p,
+	size_t n)
+{
+	size_t	i;
+
+	i = 0;
+	while (n--)
+		i = i * 10 + (*p++ - '0');
+	if (i < eng->params->pos_argc)
+		return (eng->params->pos_argv[i]);
+	if (!i)
+		return ("minishell");
+	return (NULL);
+}
+
+/* Value of the parameter of `n` bytes at `p`, NULL when it is
+ * unset. Numbers are written to `num` */
+const char	*expand_value(t_engine *eng, const char *p, size_t n, char *num)
+{
+	size_t	argc;
+
+	argc = eng->params->pos_argc;
+	if (isdigit((unsigned char)*p))
+		return (expand_positional(eng, p, n));
+	if (*p == '?')
+		snprintf(num, EXPAND_NUM_MAX, "%d", eng->status);
+	else if (*p == '$')
+		snprintf(num, EXPAND_NUM_MAX, "%d", (int)eng->pid);
+	else if (*p == '!' && eng->jobs.last_bg > 0)
+		snprintf(num, EXPAND_NUM_MAX, "%d", (int)eng->jobs.last_bg);
+	else if (*p == '#')
+		snprintf(num, EXPAND_NUM_MAX, "%zu", argc - (argc > 0));
+	else if (*p == '!')
+		return (NULL);
+	else
+		return (env_getn(&eng->env, p, n));
+	return (num);
+}
+
+/* $@ and $*: the positional parameters from $1. In double quotes
+ * "$@" makes one field of each, "$*" one field of them all */
+void	expand_all(t_expand *ex, char c)
+{
+	size_t	i;
+	char	**argv;
+
+	argv = ex->eng->params->pos_argv;
+	i = 1;
+	while (i < ex->eng->params->pos_argc)
+	{
+		if (i > 1 && c == '@' && ex->dq && ex->fields && !ex->mute)
+		{
+			ex->have = true;
+			expand_field(ex);
+		}
+		else if (i > 1)
+			expand_put(ex, " ", 1, true);
+		expand_put(ex, argv[i], strlen(argv[i]), true);
+		++i;
+	}
+}
+
+/* The parameter after a `$` at `p - 1`. A `$` that does not start
+ * one is kept. Returns the end of the parameter */
+const char	*expand_dollar(t_expand *ex, const char *p)
+{
+	const char	*val;
+	char		num[EXPAND_NUM_MAX];
+	size_t		n;
+
+	if (*p == '{')
+		return (expand_brace(ex, p + 1));
+	n = expand_name_len(p, false);
+	if (!n)
+	{
+		expand_put(ex, "$", 1, false);
+		return (p);
+	}
+	if (*p == '@' || *p == '*')
+		expand_all(ex, *p);
+	else
+	{
+		val = expand_value(ex->eng, p, n, num);
+		if (val)
+			expand_put(ex, val, strlen(val), true);
+	}
+	return (p + n);
+}
@@ -0,0 +1,102 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+#include "fdcopy.h"
+
+typedef enum e_fdcopy_how
+{
+	FDCOPY_RANGE,
+	FDCOPY_SPLICE,
+	FDCOPY_SENDFILE
+}	t_fdcopy_how;
+
+/* errno values meaning "this kind of descriptor is not supported
+ * by that system call": the next method is tried */
+static int	fdcopy_unsupported(int err)
+{
+	return (err == EINVAL || err == EXDEV || err == ENOSYS
+		|| err == EOPNOTSUPP || err == EBADF || err == ESPIPE);
+}
+
+/* One zero-copy method until EOF. Returns 1 when done, 0 if the
+ * method does not apply (from the current offsets on), -1 on error */
+static int	fdcopy_kernel(int in, int out, t_fdcopy_how how)
+{
+	ssize_t	n;
+
+	while (1)
+	{
+		if (how == FDCOPY_RANGE)
+			n = copy_file_range(in, NULL, out, NULL, FDCOPY_CHUNK, 0);
+		else if (how == FDCOPY_SPLICE)
+			n = splice(in, NULL, out, NULL, FDCOPY_CHUNK, SPLICE_F_MOVE);
+		else
+			n = sendfile(out, in, NULL, FDCOPY_CHUNK);
+		if (n == 0)
+			return (1);
+		if (n > 0 || errno == EINTR)
+			continue ;
+		if (fdcopy_unsupported(errno))
+			return (0);
+		return (-1);
+	}
+}
+
+/* Returns 0 at EOF, -1 on error */
+static int	fdcopy_rw(int in, int out)
+{
+	char	buf[FDCOPY_BUF];
+	ssize_t	n;
+	ssize_t	w;
+	ssize_t	done;
+
+	while (1)
+	{
+		n = read(in, buf, sizeof(buf));
+		if (n == -1 && errno == EINTR)
+			continue ;
+		if (n <= 0)
+			return (n);
+		done = 0;
+		while (done < n)
+		{
+			w = write(out, buf + done, n - done);
+			if (w == -1 && errno != EINTR)
+				return (-1);
+			if (w > 0)
+				done += w;
+		}
+	}
+}
+
+/* Moves everything readable from `in` to `out`. The bytes do not
+ * go through user space whenever the kernel can avoid it:
+ * copy_file_range(2) between regular files (reflinks or in-kernel
+ * copy), splice(2) when either side is a pipe, sendfile(2) from a
+ * regular file to anything else. read/write is the last resort.
+ * Returns 0, or -1 with errno set */
+int	fdcopy(int in, int out)
+{
+	struct stat	si;
+	struct stat	so;
+	int			ret;
+
+	if (fstat(in, &si) == -1 || fstat(out, &so) == -1)
+		return (-1);
+	ret = 0;
+	if (S_ISREG(si.st_mode) && S_ISREG(so.st_mode))
+		ret = fdcopy_kernel(in, out, FDCOPY_RANGE);
+	if (!ret && (S_ISFIFO(si.st_mode) || S_ISFIFO(so.st_mode)))
+		ret = fdcopy_kernel(in, out, FDCOPY_SPLICE);
+	if (!ret && S_ISREG(si.st_mode))
+		ret = fdcopy_kernel(in, out, FDCOPY_SENDFILE);
+	if (!ret)
+		return (fdcopy_rw(in, out));
+	if (ret == -1)
+		return (-1);
+	return (0);
+}
@@ -0,0 +1,11 @@
+#ifndef FDCOPY_H
+# define FDCOPY_H
+
+/* Largest request passed to one copy_file_range/sendfile/splice call */
+# define FDCOPY_CHUNK	(1L << 30)
+/* Buffer of the read/write fallback */
+# define FDCOPY_BUF		65536
+
+int	fdcopy(int in, int out);
+
+#endif
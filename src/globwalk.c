@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "globwalk.h"
+
+/* A task is done. The last one ends the walk: the idle workers
+ * are woken to leave */
+static void	gw_done(t_globwalk *gw)
+{
+	if (atomic_fetch_sub(&gw->pending, 1) != 1)
+		return ;
+	pthread_mutex_lock(&gw->park);
+	pthread_cond_broadcast(&gw->wake);
+	pthread_mutex_unlock(&gw->park);
+}
+
+/* Adds the task of matching component `comp` in `path` at the back
+ * of the deque of `w`, and wakes an idle worker to steal it. `path`
+ * is taken over: freed if the task cannot be added, NULL means
+ * malloc(3) failed */
+bool	gw_push(t_gw_worker *w, char *path, size_t comp, bool top)
+{
+	t_gw_task	t;
+	bool		ok;
+
+	t.path = path;
+	t.comp = comp;
+	t.top = top;
+	ok = (path != NULL);
+	atomic_fetch_add(&w->gw->pending, 1);
+	pthread_mutex_lock(&w->lock);
+	ok = ok && vec_push(&w->tasks, &t);
+	if (ok)
+		atomic_fetch_add(&w->gw->queued, 1);
+	pthread_mutex_unlock(&w->lock);
+	if (ok && atomic_load(&w->gw->sleepers))
+	{
+		pthread_mutex_lock(&w->gw->park);
+		pthread_cond_signal(&w->gw->wake);
+		pthread_mutex_unlock(&w->gw->park);
+	}
+	if (ok)
+		return (true);
+	free(path);
+	atomic_store(&w->gw->failed, true);
+	gw_done(w->gw);
+	return (false);
+}
+
+/* Takes the newest task of `w`, or with `steal` its oldest one.
+ * Returns false if it has none */
+static bool	gw_take(t_gw_worker *w, t_gw_task *t, bool steal)
+{
+	bool	ok;
+
+	pthread_mutex_lock(&w->lock);
+	ok = (w->head < w->tasks.len);
+	if (ok && steal)
+		*t = VEC_AT(&w->tasks, t_gw_task, w->head++);
+	else if (ok)
+	{
+		*t = VEC_LAST(&w->tasks, t_gw_task);
+		vec_pop(&w->tasks);
+	}
+	if (ok)
+		atomic_fetch_sub(&w->gw->queued, 1);
+	if (w->head == w->tasks.len)
+	{
+		w->tasks.len = 0;
+		w->head = 0;
+	}
+	pthread_mutex_unlock(&w->lock);
+	return (ok);
+}
+
+/* Sleeps while no task is queued anywhere and the walk goes on:
+ * a task being run may still push more. `sleepers` is raised
+ * before `queued` is read, and a push reads it after raising
+ * `queued`: either the push signals or the worker sees the task.
+ * Returns false once the walk is over */
+static bool	gw_park(t_globwalk *gw)
+{
+	bool	more;
+
+	pthread_mutex_lock(&gw->park);
+	atomic_fetch_add(&gw->sleepers, 1);
+	while (!atomic_load(&gw->queued) && atomic_load(&gw->pending))
+		pthread_cond_wait(&gw->wake, &gw->park);
+	atomic_fetch_sub(&gw->sleepers, 1);
+	more = (atomic_load(&gw->pending) != 0);
+	pthread_mutex_unlock(&gw->park);
+	return (more);
+}
+
+/* The next task for `w`: its own newest one, or else the oldest one
+ * of another worker. Returns false once the walk is over */
+static bool	gw_next(t_gw_worker *w, t_gw_task *t)
+{
+	t_globwalk	*gw;
+	size_t		self;
+	size_t		i;
+
+	gw = w->gw;
+	self = w - gw->workers;
+	while (1)
+	{
+		if (gw_take(w, t, false))
+			return (true);
+		i = 1;
+		while (i < gw->nworkers)
+		{
+			if (gw_take(gw->workers + (self + i) % gw->nworkers, t, true))
+				return (true);
+			++i;
+		}
+		if (!gw_park(gw))
+			return (false);
+	}
+}
+
+/* Runs tasks until none is left anywhere. After a failure they are
+ * only dropped */
+static void	*gw_run(void *arg)
+{
+	t_gw_worker	*w;
+	t_gw_task	t;
+
+	w = arg;
+	while (gw_next(w, &t))
+	{
+		if (!atomic_load(&w->gw->failed))
+			gw_task(w, &t);
+		free(t.path);
+		gw_done(w->gw);
+	}
+	return (NULL);
+}
+
+/* Matches component `comp` in every directory of `roots` and below.
+ * `gw` comes with its pattern and `nworkers` set, the shell is the
+ * first worker. It goes alone while there is one directory to read
+ * at a time: the other threads are only started once the tree
+ * branches, a `**` over a flat directory starts none. Returns 0 if
+ * it ran out of memory */
+int	globwalk(t_globwalk *gw, char **roots, size_t nroots, size_t comp)
+{
+	t_gw_task	t;
+	size_t		i;
+
+	gw->workers = calloc(gw->nworkers, sizeof(*gw->workers));
+	if (!gw->workers)
+		return (0);
+	gw->first = comp;
+	gw->literal = true;
+	i = 0;
+	while (i < comp)
+		gw->literal = gw->literal && !gw->comps[i++].pat;
+	atomic_init(&gw->pending, 0);
+	atomic_init(&gw->queued, 0);
+	atomic_init(&gw->sleepers, 0);
+	atomic_init(&gw->failed, false);
+	pthread_mutex_init(&gw->park, NULL);
+	pthread_cond_init(&gw->wake, NULL);
+	i = 0;
+	while (i < gw->nworkers)
+	{
+		gw->workers[i].gw = gw;
+		pthread_mutex_init(&gw->workers[i].lock, NULL);
+		vec_init(&gw->workers[i].tasks, sizeof(t_gw_task));
+		aux_sb_init(&gw->workers[i++].found);
+	}
+	i = 0;
+	while (i < nroots)
+		gw_push(gw->workers, strdup(roots[i++]), comp, true);
+	while (atomic_load(&gw->pending) == 1 && gw_take(gw->workers, &t, false))
+	{
+		gw_task(gw->workers, &t);
+		free(t.path);
+		gw_done(gw);
+	}
+	gw->started = 1;
+	while (gw->started < gw->nworkers && atomic_load(&gw->pending)
+		&& !pthread_create(&gw->workers[gw->started].thread, NULL, gw_run,
+			gw->workers + gw->started))
+		++gw->started;
+	gw_run(gw->workers);
+	i = 1;
+	while (i < gw->started)
+		pthread_join(gw->workers[i++].thread, NULL);
+	return (!atomic_load(&gw->failed));
+}
+
+void	globwalk_free(t_globwalk *gw)
+{
+	size_t	i;
+
+	i = 0;
+	while (gw->workers && i < gw->nworkers)
+	{
+		pthread_mutex_destroy(&gw->workers[i].lock);
+		vec_free(&gw->workers[i].tasks);
+		free(gw->workers[i].dir.ents);
+		aux_sb_free(&gw->workers[i++].found);
+	}
+	if (gw->workers)
+	{
+		pthread_mutex_destroy(&gw->park);
+		pthread_cond_destroy(&gw->wake);
+	}
+	free(gw->workers);
+	gw->workers = NULL;
+}
@@ -0,0 +1,105 @@
+#ifndef GLOBWALK_H
+# define GLOBWALK_H
+
+# include <pthread.h>
+# include <stdatomic.h>
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "aux.h"
+# include "dircache.h"
+# include "pattern.h"
+# include "vector.h"
+
+/* Walkers of a `**` when --glob-threads is not given: one per
+ * online CPU, at most this many */
+# define GLOBWALK_THREADS_MAX	16
+
+/* A component of a pattern, between two `/`.
+ * text - NUL-terminated: with its backslashes removed when it is
+ *		  literal, as written otherwise;
+ * pat	- compiled, NULL when the component is literal: it is then
+ *		  used as it is, without reading the directory;
+ * rec	- the component is `**`: any number of directories, the
+ *		  directory itself included. Directories whose name starts
+ *		  with `.` are not entered, nor links to directories. */
+typedef struct s_glob_comp
+{
+	char		*text;
+	t_pattern	*pat;
+	bool		rec;
+}	t_glob_comp;
+
+/* A directory to match component `comp` in.
+ * path - malloc(3)ed, "" or ending with `/`;
+ * top	- `comp` is a `**` entered here: the directory matched the
+ *		  components before it, it is one of the paths it stands
+ *		  for. The directories below are not. */
+typedef struct s_gw_task
+{
+	char	*path;
+	size_t	comp;
+	bool	top;
+}	t_gw_task;
+
+/* One thread of a walk. Its tasks are a deque: it pushes and pops
+ * at the back, depth first, while idle workers steal from the
+ * front the oldest task, the top of the largest subtree left.
+ * lock	  - guards `tasks` and `head`;
+ * tasks  - t_gw_task, those before `head` are taken;
+ * dir	  - the listing being matched, its buffer reused;
+ * found  - the paths matched, each followed by a NUL;
+ * nfound - how many. */
+typedef struct s_gw_worker
+{
+	struct s_globwalk	*gw;
+	pthread_t			thread;
+	pthread_mutex_t		lock;
+	t_vector			tasks;
+	size_t				head;
+	t_dirlist			dir;
+	t_strbuf			found;
+	size_t				nfound;
+}	t_gw_worker;
+
+/* A parallel walk of the directories under a `**`, with work
+ * stealing. Whichever worker finds a path, the caller sorts them
+ * all: the result is the same as that of a walk in one thread.
+ * comps	- the pattern, `n` components;
+ * first	- the first `**` among them, where the walk starts;
+ * literal	- the components before it are names, not patterns: the
+ *			  directories where it is entered are given as written,
+ *			  with their `/`, as bash does;
+ * workers	- `started` of them run, the first one is the shell;
+ * pending	- tasks pushed and not done, 0 ends the walk;
+ * queued	- tasks pushed and not taken yet;
+ * park		- guards the sleep of idle workers on `wake`, signaled
+ *			  when a task is pushed while `sleepers` is not 0 and
+ *			  broadcast when the walk ends;
+ * failed	- a malloc(3) failed: the walk stops. */
+typedef struct s_globwalk
+{
+	const t_glob_comp	*comps;
+	size_t				n;
+	size_t				first;
+	bool				literal;
+	t_gw_worker			*workers;
+	size_t				nworkers;
+	size_t				started;
+	atomic_size_t		pending;
+	atomic_size_t		queued;
+	atomic_size_t		sleepers;
+	pthread_mutex_t		park;
+	pthread_cond_t		wake;
+	atomic_bool			failed;
+}	t_globwalk;
+
+int		globwalk(t_globwalk *gw, char **roots, size_t nroots,
+			size_t comp);
+void	globwalk_free(t_globwalk *gw);
+bool	gw_push(t_gw_worker *w, char *path, size_t comp, bool top);
+
+/* globwalk_dir.c */
+void	gw_task(t_gw_worker *w, t_gw_task *t);
+
+#endif
@@ -0,0 +1,196 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "globwalk.h"
+
+/* `dir`, `name` and `slash` one after the other, malloc(3)ed */
+static char	*gw_path(const char *dir, const char *name, const char *slash)
+{
+	size_t	dlen;
+	size_t	nlen;
+	size_t	slen;
+	char	*path;
+
+	dlen = strlen(dir);
+	nlen = strlen(name);
+	slen = strlen(slash);
+	path = malloc(dlen + nlen + slen + 1);
+	if (!path)
+		return (NULL);
+	memcpy(path, dir, dlen);
+	memcpy(path + dlen, name, nlen);
+	memcpy(path + dlen + nlen, slash, slen + 1);
+	return (path);
+}
+
+/* `dir`, `name` and `slash` matched the whole pattern */
+static void	gw_found(t_gw_worker *w, const char *dir, const char *name,
+	const char *slash)
+{
+	if (!aux_sb_put(&w->found, dir, strlen(dir))
+		|| !aux_sb_put(&w->found, name, strlen(name))
+		|| !aux_sb_put(&w->found, slash, strlen(slash))
+		|| !aux_sb_putc(&w->found, '\0'))
+		atomic_store(&w->gw->failed, true);
+	else
+		++w->nfound;
+}
+
+/* The directory `path` where the `**` of `t` is entered is one of
+ * the paths it stands for. It is written without its `/` when it
+ * was matched by a pattern and not followed by one */
+static void	gw_found_top(t_gw_worker *w, t_gw_task *t, bool slash)
+{
+	size_t	len;
+
+	len = strlen(t->path);
+	if (!slash && (t->comp != w->gw->first || !w->gw->literal))
+		--len;
+	if (!aux_sb_put(&w->found, t->path, len)
+		|| !aux_sb_putc(&w->found, '\0'))
+		atomic_store(&w->gw->failed, true);
+	else
+		++w->nfound;
+}
+
+/* Whether the entry `e` of `dir` is a directory. With `follow` a
+ * link to one is too */
+static bool	gw_is_dir(const char *dir, const t_dirent64 *e, bool follow)
+{
+	struct stat	st;
+	char		*path;
+	int			ret;
+
+	if (e->type == DT_DIR)
+		return (true);
+	if (e->type != DT_UNKNOWN && (e->type != DT_LNK || !follow))
+		return (false);
+	path = gw_path(dir, e->name, "");
+	if (!path)
+		return (false);
+	if (follow)
+		ret = stat(path, &st);
+	else
+		ret = lstat(path, &st);
+	free(path);
+	return (ret == 0 && S_ISDIR(st.st_mode));
+}
+
+/* Component `c`, a pattern or a name, against the listing of `dir`:
+ * what matches is found if `c` is the last component, otherwise
+ * looked into for the next one. A `**` next is entered there */
+static void	gw_apply(t_gw_worker *w, const char *dir, size_t c)
+{
+	const t_glob_comp	*comp;
+	t_dirent64			*e;
+	size_t				off;
+	bool				match;
+
+	comp = w->gw->comps + c;
+	off = 0;
+	while (off < w->dir.len)
+	{
+		e = (t_dirent64 *)(w->dir.ents + off);
+		off += e->reclen;
+		if (comp->pat)
+			match = pattern_match(comp->pat, e->name);
+		else
+			match = !strcmp(e->name, comp->text);
+		if (e->name[0] == '.' && (!e->name[1]
+				|| (e->name[1] == '.' && !e->name[2])))
+			match = false;
+		if (match && c + 1 == w->gw->n)
+			gw_found(w, dir, e->name, "");
+		else if (match && gw_is_dir(dir, e, true))
+			gw_push(w, gw_path(dir, e->name, "/"), c + 1,
+				w->gw->comps[c + 1].rec);
+	}
+}
+
+/* `**` in the directory of `t`: each directory in it is a task for
+ * the same component, and the directory itself is matched against
+ * the next one. As in bash, `**` last gives every path below, the
+ * directory where it is entered included, and `**` followed by a
+ * `/` every directory */
+static void	gw_rec(t_gw_worker *w, t_gw_task *t)
+{
+	t_dirent64	*e;
+	size_t		off;
+	bool		last;
+	bool		slash;
+
+	last = (t->comp + 1 == w->gw->n);
+	slash = (t->comp + 2 == w->gw->n && !w->gw->comps[t->comp + 1].pat
+			&& !*w->gw->comps[t->comp + 1].text);
+	if (t->top && *t->path && (last || slash))
+		gw_found_top(w, t, slash);
+	off = 0;
+	while (off < w->dir.len)
+	{
+		e = (t_dirent64 *)(w->dir.ents + off);
+		off += e->reclen;
+		if (e->name[0] != '.' && last)
+			gw_found(w, t->path, e->name, "");
+		if (e->name[0] != '.' && slash && gw_is_dir(t->path, e, true))
+			gw_found(w, t->path, e->name, "/");
+		if (e->name[0] != '.' && gw_is_dir(t->path, e, false))
+			gw_push(w, gw_path(t->path, e->name, "/"), t->comp, false);
+	}
+	if (!last && !slash)
+		gw_apply(w, t->path, t->comp + 1);
+}
+
+/* A literal component needs no listing: the path is looked into
+ * for the next component, or must exist if it was the last one */
+static void	gw_literal(t_gw_worker *w, t_gw_task *t)
+{
+	const char	*text;
+	struct stat	st;
+	char		*path;
+
+	text = w->gw->comps[t->comp].text;
+	if (t->comp + 1 < w->gw->n)
+	{
+		gw_push(w, gw_path(t->path, text, "/"), t->comp + 1,
+			w->gw->comps[t->comp + 1].rec);
+		return ;
+	}
+	path = gw_path(t->path, text, "");
+	if (path && lstat(path, &st) == 0)
+		gw_found(w, t->path, text, "");
+	free(path);
+}
+
+/* Runs the task `t`: the directory is read with getdents64(2) into
+ * the buffer of the worker, then matched */
+void	gw_task(t_gw_worker *w, t_gw_task *t)
+{
+	const t_glob_comp	*comp;
+	const char			*dir;
+	int					fd;
+	bool				ok;
+
+	comp = w->gw->comps + t->comp;
+	if (!comp->pat && !comp->rec)
+	{
+		gw_literal(w, t);
+		return ;
+	}
+	dir = t->path;
+	if (!*dir)
+		dir = ".";
+	fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd == -1)
+		return ;
+	ok = dircache_fill(&w->dir, fd);
+	close(fd);
+	if (ok && comp->rec)
+		gw_rec(w, t);
+	else if (ok)
+		gw_apply(w, t->path, t->comp);
+}
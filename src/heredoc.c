@@ -0,0 +1,91 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "fdcopy.h"
+#include "heredoc.h"
+
+int	hd_sink_open(t_hd_sink *s)
+{
+	int	pfd[2];
+	int	cap;
+
+	s->memfd = false;
+	s->special = false;
+	s->size = 0;
+	if (pipe2(pfd, O_CLOEXEC) == -1)
+		return (0);
+	s->rd = pfd[0];
+	s->wr = pfd[1];
+	cap = fcntl(s->wr, F_GETPIPE_SZ);
+	s->cap = 4096;
+	if (cap > 0)
+		s->cap = cap;
+	return (1);
+}
+
+/* The body outgrew the pipe: what is in the pipe moves into a
+ * new memfd, which takes the place of both ends */
+static int	hd_sink_spill(t_hd_sink *s)
+{
+	int	fd;
+
+	fd = memfd_create("heredoc", MFD_CLOEXEC);
+	if (fd == -1)
+		return (0);
+	close(s->wr);
+	s->wr = -1;
+	if (fdcopy(s->rd, fd) == -1)
+	{
+		close(fd);
+		return (0);
+	}
+	close(s->rd);
+	s->rd = fd;
+	s->wr = fd;
+	s->memfd = true;
+	return (1);
+}
+
+int	hd_sink_write(t_hd_sink *s, const char *p, size_t n)
+{
+	ssize_t	w;
+
+	if (!s->memfd && s->size + n > s->cap && !hd_sink_spill(s))
+		return (0);
+	s->special = s->special || memchr(p, '$', n) || memchr(p, '\\', n);
+	s->size += n;
+	while (n)
+	{
+		w = write(s->wr, p, n);
+		if (w == -1 && errno != EINTR)
+			return (0);
+		if (w > 0)
+		{
+			p += w;
+			n -= w;
+		}
+	}
+	return (1);
+}
+
+/* Ends the body. Returns the descriptor to read it from, or -1
+ * (the sink is closed either way) */
+int	hd_sink_close(t_hd_sink *s)
+{
+	if (!s->memfd)
+	{
+		if (s->wr != -1)
+			close(s->wr);
+		return (s->rd);
+	}
+	if (lseek(s->rd, 0, SEEK_SET) == -1)
+	{
+		close(s->rd);
+		return (-1);
+	}
+	return (s->rd);
+}
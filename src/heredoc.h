@@ -0,0 +1,61 @@
+#ifndef HEREDOC_H
+# define HEREDOC_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "ast.h"
+# include "vector.h"
+
+# define HEREDOC_PS2	"> "
+
+/* A here-document that has been read.
+ * key		- the `filename` of its redirection, that is the delimiter
+ *			  word: the token and the tree share the same pointer;
+ * fd		- descriptor to read the body from;
+ * expand	- the delimiter is unquoted and the body has a `$` or a
+ *			  `\`: it is expanded before the command reads it, see
+ *			  expand_heredocs(). */
+typedef struct s_heredoc
+{
+	const char	*key;
+	int			fd;
+	bool		expand;
+}	t_heredoc;
+
+/* Where a body goes while it is being read. It starts in a pipe;
+ * once it would not fit into the pipe buffer (nobody drains the
+ * pipe until the command starts) the pipe is moved into a memfd
+ * and the rest of the body is appended there. Nothing touches
+ * the disk and the shell never holds the whole body.
+ * rd, wr	- the pipe ends, or the memfd twice;
+ * size		- bytes written so far;
+ * cap		- capacity of the pipe;
+ * special	- a `$` or a `\` was written. */
+typedef struct s_hd_sink
+{
+	int		rd;
+	int		wr;
+	size_t	size;
+	size_t	cap;
+	bool	memfd;
+	bool	special;
+}	t_hd_sink;
+
+int		hd_sink_open(t_hd_sink *s);
+int		hd_sink_write(t_hd_sink *s, const char *p, size_t n);
+int		hd_sink_close(t_hd_sink *s);
+
+/* heredoc_docs.c */
+char	*heredoc_delim(t_arena *a, const char *word);
+int		heredoc_add(t_vector *docs, const char *key, t_hd_sink *s);
+t_heredoc	*heredoc_find(t_vector *docs, const char *key);
+int		heredoc_fd(t_vector *docs, const char *key);
+void	heredoc_clear(t_vector *docs);
+int		heredoc_read_tty(t_arena *a, t_vector *docs, t_ast *root);
+void	heredoc_eof_warning(const char *delim);
+int		heredoc_add_body(t_vector *docs, const char *key,
+			const char *body, size_t len);
+int		heredoc_replace(t_heredoc *hd, const char *body, size_t len);
+
+#endif
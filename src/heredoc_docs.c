@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <readline/readline.h>
+
+#include "heredoc.h"
+
+/* Frame of the walk in heredoc_read_tty() */
+typedef struct s_hd_frame
+{
+	t_ast	*node;
+	bool	after;
+}	t_hd_frame;
+
+/* Gives up a sink whose body could not be completed */
+static void	hd_drop(t_hd_sink *s)
+{
+	int	fd;
+
+	fd = hd_sink_close(s);
+	if (fd != -1)
+		close(fd);
+}
+
+/* The delimiter is the word with its quotes removed */
+char	*heredoc_delim(t_arena *a, const char *word)
+{
+	char	*delim;
+	size_t	n;
+
+	delim = arena_alloc(a, strlen(word) + 1);
+	if (!delim)
+		return (NULL);
+	n = 0;
+	while (*word)
+	{
+		if (*word != '\'' && *word != '"')
+			delim[n++] = *word;
+		++word;
+	}
+	delim[n] = '\0';
+	return (delim);
+}
+
+/* Ends the body in `s` and files it under `key` */
+int	heredoc_add(t_vector *docs, const char *key, t_hd_sink *s)
+{
+	t_heredoc	*hd;
+	int			fd;
+
+	fd = hd_sink_close(s);
+	if (fd == -1)
+		return (0);
+	hd = vec_emplace(docs);
+	if (!hd)
+	{
+		close(fd);
+		return (0);
+	}
+	hd->key = key;
+	hd->fd = fd;
+	hd->expand = s->special && !strpbrk(key, "'\"\\");
+	return (1);
+}
+
+/* The body read for the redirection `key`, or NULL */
+t_heredoc	*heredoc_find(t_vector *docs, const char *key)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < docs->len)
+	{
+		if (VEC_AT(docs, t_heredoc, i).key == key)
+			return (vec_at(docs, i));
+		++i;
+	}
+	return (NULL);
+}
+
+/* Descriptor of the body read for the redirection `key`, or -1 */
+int	heredoc_fd(t_vector *docs, const char *key)
+{
+	t_heredoc	*hd;
+
+	hd = heredoc_find(docs, key);
+	if (!hd)
+		return (-1);
+	return (hd->fd);
+}
+
+/* Closes the bodies of the prompt that has just been executed */
+void	heredoc_clear(t_vector *docs)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < docs->len)
+		close(VEC_AT(docs, t_heredoc, i++).fd);
+	vec_clear(docs);
+}
+
+void	heredoc_eof_warning(const char *delim)
+{
+	fprintf(stderr, "minishell: warning: here-document delimited by "
+		"end-of-file (wanted `%s')\n", delim);
+}
+
+/* Stores a body that is already in memory */
+int	heredoc_add_body(t_vector *docs, const char *key, const char *body,
+	size_t len)
+{
+	t_hd_sink	s;
+
+	if (!hd_sink_open(&s))
+		return (0);
+	if (!hd_sink_write(&s, body, len))
+	{
+		hd_drop(&s);
+		return (0);
+	}
+	return (heredoc_add(docs, key, &s));
+}
+
+/* Replaces the body of `hd` by `len` bytes of `body`, its
+ * expansion */
+int	heredoc_replace(t_heredoc *hd, const char *body, size_t len)
+{
+	t_hd_sink	s;
+	int			fd;
+
+	if (!hd_sink_open(&s))
+		return (0);
+	if (!hd_sink_write(&s, body, len))
+	{
+		hd_drop(&s);
+		return (0);
+	}
+	fd = hd_sink_close(&s);
+	if (fd == -1)
+		return (0);
+	close(hd->fd);
+	hd->fd = fd;
+	hd->expand = false;
+	return (1);
+}
+
+/* Reads one body from the terminal, line by line, into a sink */
+static int	heredoc_read_one(t_arena *a, t_vector *docs, t_redi_node *redi)
+{
+	t_hd_sink	s;
+	char		*delim;
+	char		*line;
+	int			ok;
+
+	delim = heredoc_delim(a, redi->filename);
+	if (!delim || !hd_sink_open(&s))
+		return (0);
+	ok = 1;
+	line = readline(HEREDOC_PS2);
+	while (ok && line && strcmp(line, delim))
+	{
+		ok = hd_sink_write(&s, line, strlen(line))
+			&& hd_sink_write(&s, "\n", 1);
+		free(line);
+		line = NULL;
+		if (ok)
+			line = readline(HEREDOC_PS2);
+	}
+	if (ok && !line)
+		heredoc_eof_warning(delim);
+	free(line);
+	if (!ok)
+	{
+		hd_drop(&s);
+		return (0);
+	}
+	return (heredoc_add(docs, redi->filename, &s));
+}
+
+static int	heredoc_read_redis(t_arena *a, t_vector *docs, t_redi_node *redi)
+{
+	while (redi)
+	{
+		if (redi->type == T_HEREDOC && !heredoc_read_one(a, docs, redi))
+			return (0);
+		redi = redi->next;
+	}
+	return (1);
+}
+
+static int	hd_push(t_vector *stack, t_ast *node, bool after)
+{
+	t_hd_frame	*f;
+
+	if (!node)
+		return (1);
+	f = vec_emplace(stack);
+	if (!f)
+		return (0);
+	f->node = node;
+	f->after = after;
+	return (1);
+}
+
+/* Reads the bodies of every here-document of the tree, in the
+ * order they were written, before anything is executed. The
+ * redirections of a subshell or group come after its body: a frame with
+ * `after` set stands for them */
+int	heredoc_read_tty(t_arena *a, t_vector *docs, t_ast *root)
+{
+	t_vector	stack;
+	t_hd_frame	f;
+	int			ok;
+
+	vec_init(&stack, sizeof(t_hd_frame));
+	ok = hd_push(&stack, root, false);
+	while (ok && stack.len)
+	{
+		f = VEC_LAST(&stack, t_hd_frame);
+		vec_pop(&stack);
+		if (f.after || f.node->type == NODE_CMD)
+			ok = heredoc_read_redis(a, docs, f.node->redirections);
+		else if (f.node->type == NODE_SUBSHELL
+			|| f.node->type == NODE_GROUP)
+			ok = hd_push(&stack, f.node, true)
+				&& hd_push(&stack, f.node->left, false);
+		else
+			ok = hd_push(&stack, f.node->right, false)
+				&& hd_push(&stack, f.node->left, false);
+	}
+	vec_free(&stack);
+	if (!ok)
+		perror("minishell: here-document");
+	return (ok);
+}
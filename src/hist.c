@@ -0,0 +1,227 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <readline/readline.h>
+#include <readline/history.h>
+
+#include "aux.h"
+#include "hist.h"
+
+/* Start of the last `max` lines of [map, end) */
+static const char	*hist_tail(const char *map, const char *end, size_t max)
+{
+	const char	*p;
+	size_t		n;
+
+	if (end > map && end[-1] == '\n')
+		--end;
+	p = end;
+	n = 0;
+	while (p > map)
+	{
+		if (p[-1] == '\n' && ++n == max)
+			break ;
+		--p;
+	}
+	return (p);
+}
+
+/* Feeds the last HIST_LOAD_MAX lines of the mapped file to
+ * readline. Only the tail is touched, so startup costs the same
+ * for a 100-line and a 500k-line history */
+static void	hist_load(t_hist *h, const char *map, size_t size)
+{
+	const char	*end;
+	const char	*p;
+	const char	*nl;
+	char		*line;
+
+	end = map + size;
+	p = hist_tail(map, end, HIST_LOAD_MAX);
+	while (p < end)
+	{
+		nl = memchr(p, '\n', end - p);
+		if (!nl)
+			nl = end;
+		if (nl > p)
+		{
+			line = strndup(p, nl - p);
+			if (!line)
+				return ;
+			add_history(line);
+			free(line);
+			++h->loaded;
+		}
+		p = nl + 1;
+	}
+}
+
+/* Opens the history file and loads its tail. A NULL `path` or
+ * any failure leaves the shell without persistent history */
+void	hist_init(t_hist *h, const char *path, const t_env *env)
+{
+	char		buf[PATH_MAX];
+	struct stat	st;
+	void		*map;
+
+	memset(h, 0, sizeof(*h));
+	h->fd = -1;
+	if (!path
+		|| !aux_tilde(buf, sizeof(buf), path, env_get(env, "HOME")))
+		return ;
+	h->path = strdup(buf);
+	if (h->path)
+		h->fd = open(buf, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+	if (h->fd == -1 || fstat(h->fd, &st) == -1)
+	{
+		hist_close(h);
+		return ;
+	}
+	h->size = st.st_size;
+	if (!h->size)
+		return ;
+	map = mmap(NULL, h->size, PROT_READ, MAP_PRIVATE, h->fd, 0);
+	if (map == MAP_FAILED)
+		return ;
+	hist_load(h, map, h->size);
+	munmap(map, h->size);
+}
+
+/* Locks the file with `op`. Another shell may have compacted it
+ * in the meantime: `fd` is then the file it replaced, and the one
+ * now at `path` is opened and locked instead */
+static bool	hist_lock(t_hist *h, int op)
+{
+	struct stat	cur;
+	struct stat	st;
+	int			fd;
+
+	while (flock(h->fd, op) == 0)
+	{
+		if (fstat(h->fd, &cur) == -1 || stat(h->path, &st) == -1
+			|| (cur.st_dev == st.st_dev && cur.st_ino == st.st_ino))
+			return (true);
+		flock(h->fd, LOCK_UN);
+		fd = open(h->path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+		if (fd == -1)
+			return (false);
+		close(h->fd);
+		h->fd = fd;
+		h->size = st.st_size;
+	}
+	return (false);
+}
+
+/* Remembers a command in readline and appends it to the file
+ * with a single write. O_APPEND keeps the lines of several shells
+ * sharing the file from overwriting each other, the shared lock
+ * keeps them from landing while another shell compacts it */
+void	hist_add(t_hist *h, const char *line)
+{
+	struct iovec	iov[2];
+	ssize_t			n;
+
+	add_history(line);
+	if (h->fd == -1)
+		return ;
+	iov[0].iov_base = (void *)line;
+	iov[0].iov_len = strlen(line);
+	iov[1].iov_base = "\n";
+	iov[1].iov_len = 1;
+	if (!hist_lock(h, LOCK_SH))
+		return ;
+	n = writev(h->fd, iov, 2);
+	flock(h->fd, LOCK_UN);
+	if (n > 0)
+		h->size += n;
+}
+
+/* Writes [p, end) to `fd`. Returns 0 on failure */
+static int	hist_write(int fd, const char *p, const char *end)
+{
+	ssize_t	n;
+
+	while (p < end)
+	{
+		n = write(fd, p, end - p);
+		if (n == -1 && errno == EINTR)
+			continue ;
+		if (n <= 0)
+			return (0);
+		p += n;
+	}
+	return (1);
+}
+
+/* Puts the last HIST_FILE_KEEP bytes (from a line boundary) of
+ * the mapped file in a new file next to it, then renames that
+ * over `path`: whatever happens, the history at `path` is either
+ * the old one or the whole new one */
+static void	hist_replace(t_hist *h, const char *map, size_t size)
+{
+	char		tmp[PATH_MAX];
+	const char	*start;
+	int			fd;
+	int			ok;
+
+	start = memchr(map + size - HIST_FILE_KEEP, '\n', HIST_FILE_KEEP);
+	if (!start || snprintf(tmp, sizeof(tmp), "%s.%d", h->path,
+			(int)getpid()) >= (int) sizeof(tmp))
+		return ;
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd == -1)
+	{
+		perror("minishell: history");
+		return ;
+	}
+	ok = hist_write(fd, start + 1, map + size) && fsync(fd) == 0;
+	if (close(fd) == -1 || !ok || rename(tmp, h->path) == -1)
+	{
+		perror("minishell: history");
+		unlink(tmp);
+	}
+}
+
+/* Cuts the file down once it has grown past HIST_FILE_MAX. Runs
+ * when the shell exits, never while a prompt is waiting. The lock
+ * keeps two exiting shells from compacting the file at once, and
+ * the other shells from appending to it meanwhile: they find the
+ * new file once they get the lock, see hist_lock() */
+static void	hist_compact(t_hist *h)
+{
+	struct stat	st;
+	char		*map;
+
+	if (!hist_lock(h, LOCK_EX))
+		return ;
+	if (fstat(h->fd, &st) == 0 && st.st_size > HIST_FILE_MAX)
+	{
+		map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, h->fd, 0);
+		if (map != MAP_FAILED)
+		{
+			hist_replace(h, map, st.st_size);
+			munmap(map, st.st_size);
+		}
+	}
+	flock(h->fd, LOCK_UN);
+}
+
+void	hist_close(t_hist *h)
+{
+	if (h->fd != -1 && h->size > HIST_FILE_MAX)
+		hist_compact(h);
+	if (h->fd != -1)
+		close(h->fd);
+	h->fd = -1;
+	free(h->path);
+	h->path = NULL;
+}
@@ -0,0 +1,34 @@
+#ifndef HIST_H
+# define HIST_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <sys/types.h>
+
+# include "env.h"
+
+/* How many of the latest commands are loaded into readline */
+# define HIST_LOAD_MAX	1000
+/* Once the file grows past HIST_FILE_MAX bytes it is replaced by
+ * one holding its last HIST_FILE_KEEP bytes (on whole lines) */
+# define HIST_FILE_MAX	(16L << 20)
+# define HIST_FILE_KEEP	(8L << 20)
+
+/* Persistent history, an append-only file of one command per line.
+ * path		- where the file is;
+ * fd		- the file opened with O_APPEND, -1 if history is off;
+ * size		- its size as far as this shell knows;
+ * loaded	- commands read from it at startup. */
+typedef struct s_hist
+{
+	char	*path;
+	int		fd;
+	off_t	size;
+	size_t	loaded;
+}	t_hist;
+
+void	hist_init(t_hist *h, const char *path, const t_env *env);
+void	hist_add(t_hist *h, const char *line);
+void	hist_close(t_hist *h);
+
+#endif
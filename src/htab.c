@@ -0,0 +1,74 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "htab.h"
+
+/* Makes room for one more element keeping the load factor under
+ * 70%: the table of `cnt` elements is doubled (allocated with
+ * `h->init` slots the first time) and its elements put back at
+ * their home. Returns 0 on OOM, the table is then left as it is */
+int	htab_grow(const t_htab *h, void **tab, size_t *cap, size_t cnt)
+{
+	unsigned char	*old;
+	unsigned char	*new;
+	size_t			new_cap;
+	size_t			i;
+	size_t			k;
+
+	if (*cap && (cnt + 1) * 10 < *cap * 7)
+		return (1);
+	new_cap = h->init;
+	if (*cap)
+		new_cap = *cap * 2;
+	new = calloc(new_cap, h->size);
+	if (!new)
+		return (0);
+	old = *tab;
+	i = 0;
+	while (i < *cap)
+	{
+		if (h->used(old + i * h->size))
+		{
+			k = h->home(old + i * h->size, new_cap - 1);
+			while (h->used(new + k * h->size))
+				k = (k + 1) & (new_cap - 1);
+			memcpy(new + k * h->size, old + i * h->size, h->size);
+		}
+		++i;
+	}
+	free(old);
+	*tab = new;
+	*cap = new_cap;
+	return (1);
+}
+
+/* Is slot `i` between `home` and `hole` on the probe sequence,
+ * i.e. must its element stay where it is? */
+static bool	htab_stays(size_t home, size_t hole, size_t i)
+{
+	if (hole <= i)
+		return (hole < home && home <= i);
+	return (hole < home || home <= i);
+}
+
+/* Empties slot `hole` and shifts the rest of its cluster back so
+ * lookups never need tombstones. What the slot held is the
+ * caller's to free first */
+void	htab_remove(const t_htab *h, void *tab, size_t cap, size_t hole)
+{
+	unsigned char	*t;
+	size_t			i;
+
+	t = tab;
+	i = (hole + 1) & (cap - 1);
+	while (h->used(t + i * h->size))
+	{
+		if (!htab_stays(h->home(t + i * h->size, cap - 1), hole, i))
+		{
+			memcpy(t + hole * h->size, t + i * h->size, h->size);
+			hole = i;
+		}
+		i = (i + 1) & (cap - 1);
+	}
+	memset(t + hole * h->size, 0, h->size);
+}
@@ -0,0 +1,28 @@
+#ifndef HTAB_H
+# define HTAB_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+/* The shape of an open addressing table with linear probing: an
+ * array of `cap` slots, `cap` a power of 2, an empty slot all
+ * zero. The tables of the shell (variables, commands, plans,
+ * listings, children) each describe theirs once with this and
+ * share how it grows and how an element leaves it.
+ * size	- bytes of a slot;
+ * init	- slots of the table when it is first allocated;
+ * home	- the slot the element in `slot` hashes to, `mask` being
+ *		  `cap` - 1;
+ * used	- whether `slot` holds an element. */
+typedef struct s_htab
+{
+	size_t	size;
+	size_t	init;
+	size_t	(*home)(const void *slot, size_t mask);
+	bool	(*used)(const void *slot);
+}	t_htab;
+
+int		htab_grow(const t_htab *h, void **tab, size_t *cap, size_t cnt);
+void	htab_remove(const t_htab *h, void *tab, size_t cap, size_t hole);
+
+#endif
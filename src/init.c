@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "globwalk.h"
+
+/* Fills `configs` with the default startup files of minishell,
+ * or of bash with `--bash-compliant` */
+static void	init_configs(t_settings *s)
+{
+	t_configs	*c;
+
+	c = &s->configs;
+	c->etc_prof_path = DEF_MINISHL_ETC_PROF_PATH;
+	c->home_prof_path = DEF_MINISHL_HOME_PROF_PATH;
+	c->home_login_path = DEF_MINISHL_HOME_LOGIN_PATH;
+	c->home_cmn_prof_path = DEF_MINISHL_HOME_CMN_PROF_PATH;
+	c->home_logout_path = DEF_MINISHL_HOME_LOGOUT_PATH;
+	c->etc_logout_path = DEF_MINISHL_ETC_LOGOUT_PATH;
+	c->home_hist_path = DEF_MINISHL_HOME_HIST_PATH;
+	c->etc_rc_path = DEF_MINISHL_ETC_RC_PATH;
+	c->home_rc_path = DEF_MINISHL_HOME_RC_PATH;
+	if (!s->options.f_bashcompl)
+		return ;
+	c->etc_prof_path = DEF_BASH_ETC_PROF_PATH;
+	c->home_prof_path = DEF_BASH_HOME_PROF_PATH;
+	c->home_login_path = DEF_BASH_HOME_LOGIN_PATH;
+	c->home_cmn_prof_path = DEF_BASH_HOME_CMN_PROF_PATH;
+	c->home_logout_path = DEF_BASH_HOME_LOGOUT_PATH;
+	c->etc_logout_path = DEF_BASH_ETC_LOGOUT_PATH;
+	c->home_hist_path = DEF_BASH_HOME_HIST_PATH;
+	c->etc_rc_path = DEF_BASH_ETC_RC_PATH;
+	c->home_rc_path = DEF_BASH_HOME_RC_PATH;
+}
+
+/* --glob-threads N or --glob-threads=N, from 1 to
+ * GLOBWALK_THREADS_MAX, `used` argv entries */
+static int	init_threads(t_options *o, const char *arg, int used)
+{
+	char	*end;
+	long	n;
+
+	n = strtol(arg, &end, 10);
+	if (*arg >= '0' && *arg <= '9' && !*end && n >= 1
+		&& n <= GLOBWALK_THREADS_MAX)
+	{
+		o->glob_threads = n;
+		return (used);
+	}
+	fprintf(stderr, "minishell: --glob-threads: %s: invalid number\n", arg);
+	return (-1);
+}
+
+/* --pipe-size SIZE or --pipe-size=SIZE, `used` argv entries */
+static int	init_pipe_size(t_options *o, const char *arg, int used)
+{
+	if (pipesz_parse(arg, &o->pipe_size))
+		return (used);
+	fprintf(stderr, "minishell: --pipe-size: %s: invalid size\n", arg);
+	return (-1);
+}
+
+/* GNU long options. Returns the number of argv entries used,
+ * 0 for an unknown option and -1 for an invalid argument */
+static int	init_long_opt(t_settings *s, char **argv, char **rc_file)
+{
+	t_options	*o;
+
+	o = &s->options;
+	if (!strcmp(*argv, "--login"))
+		o->f_login = true;
+	else if (!strcmp(*argv, "--verbose"))
+		o->f_verbose = true;
+	else if (!strcmp(*argv, "--bash-compliant"))
+		o->f_bashcompl = true;
+	else if (!strcmp(*argv, "--noprofile"))
+		o->f_noprofile = true;
+	else if (!strcmp(*argv, "--norc"))
+		o->f_norc = true;
+	else if ((!strcmp(*argv, "--init-file") || !strcmp(*argv, "--rcfile"))
+		&& argv[1])
+	{
+		o->f_initfile = true;
+		*rc_file = argv[1];
+		return (2);
+	}
+	else if (!strncmp(*argv, "--profile=", 10) && (*argv)[10])
+		o->profile = *argv + 10;
+	else if (!strcmp(*argv, "--profile") && argv[1])
+	{
+		o->profile = argv[1];
+		return (2);
+	}
+	else if (!strncmp(*argv, "--xtrace=", 9) && (*argv)[9])
+		o->xtrace = *argv + 9;
+	else if (!strcmp(*argv, "--xtrace") && argv[1])
+	{
+		o->xtrace = argv[1];
+		return (2);
+	}
+	else if (!strncmp(*argv, "--pipe-size=", 12) && (*argv)[12])
+		return (init_pipe_size(o, *argv + 12, 1));
+	else if (!strcmp(*argv, "--pipe-size") && argv[1])
+		return (init_pipe_size(o, argv[1], 2));
+	else if (!strncmp(*argv, "--glob-threads=", 15) && (*argv)[15])
+		return (init_threads(o, *argv + 15, 1));
+	else if (!strcmp(*argv, "--glob-threads") && argv[1])
+		return (init_threads(o, argv[1], 2));
+	else
+		return (0);
+	return (1);
+}
+
+/* Single-letter options: -c, -l, -v. Returns 0 for an unknown one */
+static int	init_short_opt(t_settings *s, t_engine_params *p, const char *opt)
+{
+	while (*++opt)
+	{
+		if (*opt == 'c')
+			p->mode = NONINT_CMD;
+		else if (*opt == 'l')
+			s->options.f_login = true;
+		else if (*opt == 'v')
+			s->options.f_verbose = true;
+		else
+			return (0);
+	}
+	return (1);
+}
+
+/* Positional arguments: the command string for -c or the script,
+ * followed by $0, $1... */
+static int	init_operands(t_engine_params *p, int argc, char **argv)
+{
+	if (p->mode == NONINT_CMD)
+	{
+		if (!argc)
+		{
+			fprintf(stderr, "minishell: -c: option requires an argument\n");
+			return (0);
+		}
+		p->cmds = *argv++;
+		--argc;
+	}
+	else if (argc)
+	{
+		p->mode = NONINT_SCRIPT;
+		p->script_path = *argv;
+	}
+	p->pos_argv = argv;
+	p->pos_argc = argc;
+	return (1);
+}
+
+/* Parses the command line into `s` and `p`. Returns 0 after
+ * printing a message when it is invalid */
+int	init_settings(t_settings *s, t_engine_params *p, int argc, char **argv)
+{
+	char	*rc_file;
+	int		i;
+	int		n;
+
+	rc_file = NULL;
+	p->settings = s;
+	p->mode = INT_NONLOG;
+	s->options.f_login = (argv[0] && argv[0][0] == '-');
+	i = 1;
+	while (i < argc && argv[i][0] == '-' && argv[i][1])
+	{
+		if (!strcmp(argv[i++], "--"))
+			break ;
+		n = 1;
+		if (argv[i - 1][1] == '-')
+			n = init_long_opt(s, &argv[i - 1], &rc_file);
+		else if (!init_short_opt(s, p, argv[i - 1]))
+			n = 0;
+		if (!n)
+			fprintf(stderr, "minishell: %s: invalid option\n", argv[i - 1]);
+		if (n <= 0)
+			return (0);
+		i += n - 1;
+	}
+	init_configs(s);
+	if (rc_file)
+		s->configs.home_rc_path = rc_file;
+	if (!init_operands(p, argc - i, argv + i))
+		return (0);
+	if (p->mode == INT_NONLOG && s->options.f_login)
+		p->mode = INT_LOG;
+	return (1);
+}
@@ -4,21 +4,31 @@
 
 # include <stdbool.h>
 
+# include "pipesz.h"
+
 /* minishell options 
  * f_login:		-l, --login;
  * f_verbose:	-v, --verbose;
  * f_bashcompl:	--bash-compliant;
  * f_noprofile:	--noprofile;
  * f_norc:		--norc;
- * f_initfile:	--init-file, --rc-file. */
+ * f_initfile:	--init-file, --rc-file;
+ * pipe_size:	--pipe-size SIZE, see pipesz_parse();
+ * glob_threads: --glob-threads N, walkers of a `**`, 0 if not given;
+ * profile:		--profile=FILE, NULL if not given, see t_prof;
+ * xtrace:		--xtrace=FILE, NULL if not given, see t_xtrace. */
 typedef struct s_options
 {
-	bool	f_login;
-	bool	f_verbose;
-	bool	f_bashcompl;
-	bool	f_noprofile;
-	bool	f_norc;
-	bool	f_initfile;
+	bool		f_login;
+	bool		f_verbose;
+	bool		f_bashcompl;
+	bool		f_noprofile;
+	bool		f_norc;
+	bool		f_initfile;
+	t_pipesz	pipe_size;
+	int			glob_threads;
+	char		*profile;
+	char		*xtrace;
 }	t_options;
 
 /* minishell config files
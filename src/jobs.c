@@ -0,0 +1,197 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "htab.h"
+#include "jobs.h"
+
+void	jobs_init(t_jobs *j)
+{
+	j->tab = NULL;
+	j->cap = 0;
+	j->cnt = 0;
+	vec_init(&j->jobs, sizeof(t_job));
+	j->gen = 0;
+	vec_init(&j->done, sizeof(t_jobref));
+	j->head = 0;
+	j->running = 0;
+	j->last_bg = -1;
+	j->prof = NULL;
+	j->xtrace = NULL;
+}
+
+/* Forgets every job and leaves `j` empty. A forked child starts
+ * this way: the jobs of its parent are not its children */
+void	jobs_free(t_jobs *j)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < j->jobs.len)
+		vec_free(&VEC_AT(&j->jobs, t_job, i++).pids);
+	vec_free(&j->jobs);
+	vec_free(&j->done);
+	free(j->tab);
+	jobs_init(j);
+}
+
+t_job	*jobs_at(t_jobs *j, size_t job)
+{
+	return (vec_at(&j->jobs, job));
+}
+
+/* Slot 0 for the foreground, a new last slot for `bg` */
+size_t	jobs_new(t_jobs *j, bool bg)
+{
+	t_job	*jb;
+	size_t	job;
+
+	job = 0;
+	if (bg || !j->jobs.len)
+	{
+		jb = vec_emplace(&j->jobs);
+		if (!jb)
+			return (JOBS_NONE);
+		memset(jb, 0, sizeof(*jb));
+		vec_init(&jb->pids, sizeof(pid_t));
+		job = j->jobs.len - 1;
+	}
+	if (bg && !job)
+		return (jobs_new(j, bg));
+	jb = jobs_at(j, job);
+	jb->gen = ++j->gen;
+	jb->left = 0;
+	jb->last = -1;
+	jb->status = 0;
+	jb->bg = bg;
+	jb->used = true;
+	memset(&jb->ru, 0, sizeof(jb->ru));
+	vec_clear(&jb->pids);
+	return (job);
+}
+
+/* Fibonacci hashing: pids are mostly consecutive numbers */
+static size_t	jobs_home(pid_t pid, size_t mask)
+{
+	return (((uint32_t)pid * 2654435761U) & mask);
+}
+
+static size_t	jproc_home(const void *slot, size_t mask)
+{
+	return (jobs_home(((const t_jproc *)slot)->pid, mask));
+}
+
+static bool	jproc_used(const void *slot)
+{
+	return (((const t_jproc *)slot)->pid != 0);
+}
+
+static const t_htab	g_jobs_htab = {
+	sizeof(t_jproc), JOBS_INIT_CAP, jproc_home, jproc_used
+};
+
+/* The slot holding `pid` or the empty one where it belongs */
+static t_jproc	*jobs_slot(const t_jobs *j, pid_t pid)
+{
+	size_t	i;
+
+	i = jobs_home(pid, j->cap - 1);
+	while (j->tab[i].pid && j->tab[i].pid != pid)
+		i = (i + 1) & (j->cap - 1);
+	return (&j->tab[i]);
+}
+
+t_jproc	*jobs_proc(const t_jobs *j, pid_t pid)
+{
+	t_jproc	*p;
+
+	if (!j->cap)
+		return (NULL);
+	p = jobs_slot(j, pid);
+	if (!p->pid)
+		return (NULL);
+	return (p);
+}
+
+/* See htab_grow() */
+static int	jobs_grow(t_jobs *j)
+{
+	return (htab_grow(&g_jobs_htab, (void **)&j->tab, &j->cap, j->cnt));
+}
+
+/* Records that `pid` runs as part of `job` */
+int	jobs_add(t_jobs *j, size_t job, pid_t pid)
+{
+	t_job	*jb;
+	t_jproc	*p;
+
+	jb = jobs_at(j, job);
+	if (!vec_push(&jb->pids, &pid))
+		return (0);
+	if (!jobs_grow(j))
+	{
+		vec_pop(&jb->pids);
+		return (0);
+	}
+	p = jobs_slot(j, pid);
+	memset(p, 0, sizeof(*p));
+	p->pid = pid;
+	p->job = job;
+	++j->cnt;
+	++jb->left;
+	return (1);
+}
+
+/* Every process of `job` has been started. `status` is the status
+ * of the job when its last stage could not be started (`last` is
+ * -1 then) */
+void	jobs_seal(t_jobs *j, size_t job, pid_t last, int status)
+{
+	t_job	*jb;
+
+	jb = jobs_at(j, job);
+	jb->last = last;
+	jb->status = status;
+	if (jb->bg)
+	{
+		++j->running;
+		if (last != -1)
+			j->last_bg = last;
+	}
+	if (!jb->left)
+		jobs_finished(j, job);
+}
+
+/* Empties the slot of `p`, see htab_remove() */
+static void	jobs_remove(t_jobs *j, t_jproc *p)
+{
+	htab_remove(&g_jobs_htab, j->tab, j->cap, p - j->tab);
+	--j->cnt;
+}
+
+/* Forgets `job` and its processes. The number is reused once
+ * no higher one is in use */
+void	jobs_drop(t_jobs *j, size_t job)
+{
+	t_job	*jb;
+	t_jproc	*p;
+	size_t	i;
+
+	jb = jobs_at(j, job);
+	i = 0;
+	while (i < jb->pids.len)
+	{
+		p = jobs_proc(j, VEC_AT(&jb->pids, pid_t, i++));
+		if (p)
+			jobs_remove(j, p);
+	}
+	if (jb->bg && jb->left)
+		--j->running;
+	vec_clear(&jb->pids);
+	jb->used = false;
+	while (j->jobs.len > 1 && !VEC_LAST(&j->jobs, t_job).used)
+	{
+		vec_free(&VEC_LAST(&j->jobs, t_job).pids);
+		vec_pop(&j->jobs);
+	}
+}
@@ -0,0 +1,106 @@
+#ifndef JOBS_H
+# define JOBS_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <sys/resource.h>
+# include <sys/types.h>
+
+# include "vector.h"
+
+# define JOBS_INIT_CAP	64
+
+/* Returned by jobs_new() when out of memory */
+# define JOBS_NONE		((size_t)-1)
+
+/* A process started by the shell.
+ * pid	  - 0 for an empty slot;
+ * job	  - index of its job;
+ * status - exit status once `done` (128 + signal when killed);
+ * ru	  - resources it used, from wait4(2);
+ * start  - when it was started, see prof_now(). */
+typedef struct s_jproc
+{
+	pid_t			pid;
+	size_t			job;
+	int				status;
+	bool			done;
+	struct rusage	ru;
+	int64_t			start;
+}	t_jproc;
+
+/* A pipeline being run. Slot 0 is the foreground pipeline, a
+ * background job is numbered by its slot: like in bash the next
+ * one gets the highest number in use plus one.
+ * gen	  - tells this job from others that used the slot before;
+ * pids	  - its processes (pid_t);
+ * left	  - how many of them are still running;
+ * last	  - pid of the last stage, -1 if it had no process;
+ * status - exit status of the last stage;
+ * bg	  - started with `&`;
+ * used	  - the slot holds a job;
+ * ru	  - resources used by all its processes. */
+typedef struct s_job
+{
+	size_t			gen;
+	t_vector		pids;
+	size_t			left;
+	pid_t			last;
+	int				status;
+	bool			bg;
+	bool			used;
+	struct rusage	ru;
+}	t_job;
+
+/* A finished background job nobody has waited for yet */
+typedef struct s_jobref
+{
+	size_t	job;
+	size_t	gen;
+}	t_jobref;
+
+/* Every child of the shell, by pid and by job.
+ * tab		- pid -> process, open addressing, `cap` a power of 2:
+ *			  a child that exits is found in O(1) whatever the
+ *			  number of jobs;
+ * jobs		- t_job slots;
+ * gen		- generation of the last job created;
+ * done		- finished background jobs, oldest first from `head`;
+ * running	- background jobs still running;
+ * last_bg	- pid of the last background job ($!), -1 if none;
+ * prof		- the profiler reaped children are reported to, NULL
+ *			  in a forked child;
+ * xtrace	- the same for --xtrace. */
+typedef struct s_jobs
+{
+	t_jproc		*tab;
+	size_t		cap;
+	size_t		cnt;
+	t_vector	jobs;
+	size_t		gen;
+	t_vector	done;
+	size_t		head;
+	size_t		running;
+	pid_t		last_bg;
+	struct s_prof	*prof;
+	struct s_xtrace	*xtrace;
+}	t_jobs;
+
+void	jobs_init(t_jobs *j);
+void	jobs_free(t_jobs *j);
+t_job	*jobs_at(t_jobs *j, size_t job);
+size_t	jobs_new(t_jobs *j, bool bg);
+int		jobs_add(t_jobs *j, size_t job, pid_t pid);
+void	jobs_seal(t_jobs *j, size_t job, pid_t last, int status);
+t_jproc	*jobs_proc(const t_jobs *j, pid_t pid);
+void	jobs_drop(t_jobs *j, size_t job);
+
+/* jobs_wait.c */
+int		jobs_reap(t_jobs *j, bool block);
+int		jobs_wait(t_jobs *j, size_t job);
+size_t	jobs_next_done(t_jobs *j);
+void	jobs_finished(t_jobs *j, size_t job);
+void	jobs_notify(t_jobs *j);
+
+#endif
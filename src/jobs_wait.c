@@ -0,0 +1,141 @@
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "jobs.h"
+#include "prof.h"
+#include "xtrace.h"
+
+static void	jobs_ru_add(struct rusage *sum, const struct rusage *ru)
+{
+	timeradd(&sum->ru_utime, &ru->ru_utime, &sum->ru_utime);
+	timeradd(&sum->ru_stime, &ru->ru_stime, &sum->ru_stime);
+	if (ru->ru_maxrss > sum->ru_maxrss)
+		sum->ru_maxrss = ru->ru_maxrss;
+	sum->ru_minflt += ru->ru_minflt;
+	sum->ru_majflt += ru->ru_majflt;
+	sum->ru_inblock += ru->ru_inblock;
+	sum->ru_oublock += ru->ru_oublock;
+	sum->ru_nvcsw += ru->ru_nvcsw;
+	sum->ru_nivcsw += ru->ru_nivcsw;
+}
+
+/* Every process of `job` has exited. A background job waits in
+ * `done` for `wait` (or the next prompt) to collect it */
+void	jobs_finished(t_jobs *j, size_t job)
+{
+	t_job		*jb;
+	t_jobref	ref;
+
+	jb = jobs_at(j, job);
+	if (!jb->bg)
+		return ;
+	--j->running;
+	ref.job = job;
+	ref.gen = jb->gen;
+	vec_push(&j->done, &ref);
+}
+
+/* Collects one child, any of them, with wait4(2): the pid leads
+ * straight to its process and job. With `block` sleeps until a
+ * child exits. Returns 0 when nothing was collected (there is no
+ * child, or none has exited yet) */
+int	jobs_reap(t_jobs *j, bool block)
+{
+	struct rusage	ru;
+	t_jproc			*p;
+	t_job			*jb;
+	pid_t			pid;
+	int				ws;
+	int				flags;
+	int64_t			t0;
+
+	flags = 0;
+	if (!block)
+		flags = WNOHANG;
+	t0 = 0;
+	if (j->prof)
+		t0 = prof_now(j->prof);
+	pid = wait4(-1, &ws, flags, &ru);
+	while (pid == -1 && errno == EINTR)
+		pid = wait4(-1, &ws, flags, &ru);
+	if (pid <= 0)
+		return (0);
+	p = jobs_proc(j, pid);
+	if (!p || p->done)
+		return (1);
+	p->status = WEXITSTATUS(ws);
+	if (WIFSIGNALED(ws))
+		p->status = 128 + WTERMSIG(ws);
+	p->ru = ru;
+	p->done = true;
+	if (j->prof)
+	{
+		prof_span(j->prof, "reap", t0);
+		prof_run(j->prof, p);
+	}
+	if (j->xtrace)
+		xtrace_exit(j->xtrace, pid, p->status);
+	jb = jobs_at(j, p->job);
+	jobs_ru_add(&jb->ru, &ru);
+	if (pid == jb->last)
+		jb->status = p->status;
+	if (!--jb->left)
+		jobs_finished(j, p->job);
+	return (1);
+}
+
+/* Waits until every process of `job` has exited, returns the
+ * status of the job */
+int	jobs_wait(t_jobs *j, size_t job)
+{
+	t_job	*jb;
+
+	jb = jobs_at(j, job);
+	while (jb->left && jobs_reap(j, true))
+		;
+	return (jb->status);
+}
+
+/* The oldest finished background job nobody has collected, or
+ * JOBS_NONE. Jobs dropped meanwhile are skipped */
+size_t	jobs_next_done(t_jobs *j)
+{
+	t_jobref	ref;
+	t_job		*jb;
+
+	while (j->head < j->done.len)
+	{
+		ref = VEC_AT(&j->done, t_jobref, j->head++);
+		jb = jobs_at(j, ref.job);
+		if (jb->used && jb->gen == ref.gen && !jb->left)
+			return (ref.job);
+	}
+	vec_clear(&j->done);
+	j->head = 0;
+	return (JOBS_NONE);
+}
+
+/* Before a prompt: reports and forgets the background jobs that
+ * have finished since the previous one */
+void	jobs_notify(t_jobs *j)
+{
+	size_t	job;
+	int		status;
+
+	while (j->running && jobs_reap(j, false))
+		;
+	job = jobs_next_done(j);
+	while (job != JOBS_NONE)
+	{
+		status = jobs_at(j, job)->status;
+		if (status)
+			dprintf(STDERR_FILENO, "[%zu]  Exit %d\n", job, status);
+		else
+			dprintf(STDERR_FILENO, "[%zu]  Done\n", job);
+		jobs_drop(j, job);
+		job = jobs_next_done(j);
+	}
+}
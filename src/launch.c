@@ -0,0 +1,122 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "launch.h"
+
+/* The child gets its pipe ends on stdin/stdout. Every descriptor
+ * the shell opens is close-on-exec, so the command only gets those
+ * and the ones the shell inherited (a jobserver pipe, `3>file`
+ * around the shell). An end that already is stdin/stdout gets its
+ * close-on-exec flag cleared by the dup2 action */
+static int	launch_actions(posix_spawn_file_actions_t *fa, const t_launch *l)
+{
+	int	err;
+
+	err = 0;
+	if (l->fd_in != -1)
+		err = posix_spawn_file_actions_adddup2(fa, l->fd_in, STDIN_FILENO);
+	if (!err && l->fd_out != -1)
+		err = posix_spawn_file_actions_adddup2(fa, l->fd_out, STDOUT_FILENO);
+	return (err);
+}
+
+/* Returns the PID of the started command, or -1 with errno set
+ * (the error has already been reported) */
+pid_t	launch_spawn(const t_launch *l)
+{
+	posix_spawn_file_actions_t	fa;
+	const char					*path;
+	pid_t						pid;
+	int							err;
+
+	path = l->path;
+	if (!path)
+		path = l->argv[0];
+	err = posix_spawn_file_actions_init(&fa);
+	if (!err)
+	{
+		err = launch_actions(&fa, l);
+		if (!err)
+			err = posix_spawn(&pid, path, &fa, NULL, l->argv, l->envp);
+		posix_spawn_file_actions_destroy(&fa);
+	}
+	if (!err)
+		return (pid);
+	fprintf(stderr, "minishell: %s: %s\n", l->argv[0], strerror(err));
+	errno = err;
+	return (-1);
+}
+
+/* Replaces the shell with the command, on the shell's own
+ * descriptors. Returns only on failure, with errno set (the error
+ * has already been reported) */
+void	launch_exec(const t_launch *l)
+{
+	const char	*path;
+	int			err;
+
+	path = l->path;
+	if (!path)
+		path = l->argv[0];
+	fflush(NULL);
+	execve(path, l->argv, l->envp);
+	err = errno;
+	fprintf(stderr, "minishell: %s: %s\n", l->argv[0], strerror(err));
+	errno = err;
+}
+
+static int	launch_fds(const t_launch *l)
+{
+	size_t	i;
+
+	if (l->fd_in != -1 && l->fd_in != STDIN_FILENO
+		&& (dup2(l->fd_in, STDIN_FILENO) == -1 || close(l->fd_in) == -1))
+		return (0);
+	if (l->fd_out != -1 && l->fd_out != STDOUT_FILENO
+		&& (dup2(l->fd_out, STDOUT_FILENO) == -1 || close(l->fd_out) == -1))
+		return (0);
+	i = 0;
+	while (i < l->close_cnt)
+	{
+		if (l->close_fds[i] > STDERR_FILENO)
+			close(l->close_fds[i]);
+		++i;
+	}
+	return (1);
+}
+
+/* Forks a child that goes on running shell code. Returns 0 in
+ * the child (its stdin/stdout are already set up), the PID in
+ * the parent or -1 on error. `l->argv` and `l->envp` are unused.
+ * The child keeps the descriptors of the shell it still needs
+ * (here-document bodies), all of them close-on-exec */
+pid_t	launch_fork(const t_launch *l)
+{
+	pid_t	pid;
+
+	pid = fork();
+	if (pid == -1)
+	{
+		perror("minishell: fork");
+		return (-1);
+	}
+	if (pid == 0 && !launch_fds(l))
+	{
+		perror("minishell");
+		exit(EXIT_FAILURE);
+	}
+	return (pid);
+}
+
+/* Exit status of a command launch_spawn() failed to start */
+int	launch_err_status(int err)
+{
+	if (err == ENOENT)
+		return (LAUNCH_NOT_FOUND);
+	return (LAUNCH_NOT_EXEC);
+}
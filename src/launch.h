@@ -0,0 +1,41 @@
+#ifndef LAUNCH_H
+# define LAUNCH_H
+
+# include <stddef.h>
+# include <sys/types.h>
+
+/* Exit statuses of commands that could not be started (as in bash) */
+# define LAUNCH_NOT_FOUND	127
+# define LAUNCH_NOT_EXEC	126
+
+/* One process to start.
+ * path			- the executable, argv[0] is used when NULL;
+ * argv, envp	- as for execve(2);
+ * fd_in		- becomes the child's stdin, -1 keeps ours;
+ * fd_out		- becomes the child's stdout, -1 keeps ours;
+ * close_fds	- descriptors a forked child must close (the other
+ *				  ends of its pipes), those of a spawned command
+ *				  are close-on-exec;
+ * close_cnt	- number of `close_fds`. */
+typedef struct s_launch
+{
+	const char	*path;
+	char		**argv;
+	char		**envp;
+	int			fd_in;
+	int			fd_out;
+	const int	*close_fds;
+	size_t		close_cnt;
+}	t_launch;
+
+/* External commands are started with posix_spawn(3), which glibc
+ * implements with clone(CLONE_VM | CLONE_VFORK): no page tables
+ * are copied no matter how big the shell has grown. launch_fork()
+ * is only for children that keep running shell code (subshells),
+ * launch_exec() for a command that takes the place of the shell */
+pid_t	launch_spawn(const t_launch *l);
+void	launch_exec(const t_launch *l);
+pid_t	launch_fork(const t_launch *l);
+int		launch_err_status(int err);
+
+#endif
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lexer.h"
+
+static int	lex_push(t_lexer *lx, t_token_type type, size_t start, size_t n)
+{
+	t_token	*tok;
+
+	tok = token_new(lx->arena, type, lx->s + start, n);
+	if (!tok)
+	{
+		perror("minishell");
+		return (0);
+	}
+	tok->prev = lx->tail;
+	if (lx->tail)
+		lx->tail->next = tok;
+	else
+		lx->head = tok;
+	lx->tail = tok;
+	return (1);
+}
+
+static t_token_type	op_type(char c, size_t n)
+{
+	if (c == '|' && n == 2)
+		return (T_OR);
+	if (c == '|')
+		return (T_PIPE);
+	if (c == '<' && n == 2)
+		return (T_HEREDOC);
+	if (c == '<')
+		return (T_REDIR_IN);
+	if (c == '>' && n == 2)
+		return (T_APPEND);
+	if (c == '>')
+		return (T_REDIR_OUT);
+	if (c == '(')
+		return (T_LEFT_PAREN);
+	if (c == ')')
+		return (T_RIGHT_PAREN);
+	if (c == ';')
+		return (T_SEMI);
+	if (n == 1)
+		return (T_BG);
+	return (T_AND);
+}
+
+/* Operators are |, ||, &, &&, ;, (, ), <, <<, > and >>.
+ * A doubled character forms one token, except for ; ( and ) */
+static int	lex_operator(t_lexer *lx)
+{
+	char	c;
+	size_t	n;
+
+	c = lx->s[lx->pos];
+	n = 1;
+	if (lx->pos + 1 < lx->len && lx->s[lx->pos + 1] == c
+		&& c != '(' && c != ')' && c != ';')
+		n = 2;
+	lx->pos += n;
+	return (lex_push(lx, op_type(c, n), lx->pos - n, n));
+}
+
+/* Index after the quote closing the one at `pos`, 0 if it is not
+ * closed. In double quotes a backslash escapes the next byte */
+static size_t	lex_quote_end(const char *s, size_t len, size_t pos)
+{
+	char	q;
+
+	q = s[pos++];
+	while (pos < len && s[pos] != q)
+	{
+		if (q == '"' && s[pos] == '\\')
+			++pos;
+		++pos;
+	}
+	if (pos >= len)
+		return (0);
+	return (pos + 1);
+}
+
+/* Index after the `}` closing the `${` at `pos`, 0 if there is
+ * none. Braces nest, quotes and escapes inside are skipped whole:
+ * ${x:-a b} is one word */
+static size_t	lex_brace_end(const char *s, size_t len, size_t pos)
+{
+	size_t	depth;
+
+	depth = 0;
+	while (pos < len)
+	{
+		if (s[pos] == '\'' || s[pos] == '"')
+		{
+			pos = lex_quote_end(s, len, pos);
+			if (!pos)
+				return (0);
+			continue ;
+		}
+		if (s[pos] == '\\')
+			++pos;
+		else if (s[pos] == '{')
+			++depth;
+		else if (s[pos] == '}' && !--depth)
+			return (pos + 1);
+		++pos;
+	}
+	return (0);
+}
+
+/* A word runs until an unquoted blank or operator. Quotes, escapes
+ * and `$` stay in the word text, they are handled by the expansion
+ * (see expand.c) */
+static int	lex_word(t_lexer *lx)
+{
+	size_t	start;
+	size_t	end;
+	char	c;
+
+	start = lx->pos;
+	end = 1;
+	while (end)
+	{
+		lx->pos = lex_next_meta(lx->s, lx->len, lx->pos);
+		if (lx->pos == lx->len)
+			break ;
+		c = lx->s[lx->pos];
+		if (c == '\\')
+			end = lx->pos + 1 + (lx->pos + 1 < lx->len);
+		else if (c == '$' && lx->pos + 1 < lx->len && lx->s[lx->pos + 1] == '{')
+			end = lex_brace_end(lx->s, lx->len, lx->pos);
+		else if (c == '$')
+			end = lx->pos + 1;
+		else if (c == '\'' || c == '"')
+			end = lex_quote_end(lx->s, lx->len, lx->pos);
+		else
+			break ;
+		if (!end)
+			lx->open = lx->s + lx->pos;
+		lx->pos = end;
+	}
+	if (!end)
+		return (0);
+	return (lex_push(lx, T_WORD, start, lx->pos - start));
+}
+
+static int	lex_all(t_lexer *lx, t_arena *arena, const char *s, size_t len)
+{
+	char	c;
+	int		ok;
+
+	memset(lx, 0, sizeof(*lx));
+	lx->s = s;
+	lx->len = len;
+	lx->arena = arena;
+	ok = 1;
+	while (ok)
+	{
+		while (lx->pos < len && (s[lx->pos] == ' '
+				|| s[lx->pos] == '\t' || s[lx->pos] == '\n'))
+			++lx->pos;
+		if (lx->pos == len)
+			break ;
+		c = s[lx->pos];
+		if (lex_is_meta(c) && c != '\'' && c != '"' && c != '$'
+			&& c != '\\')
+			ok = lex_operator(lx);
+		else
+			ok = lex_word(lx);
+	}
+	return (ok);
+}
+
+/* Splits `len` bytes of `prompt` into a doubly linked list of
+ * tokens allocated from `arena`. Returns 0 on a syntax error */
+int	lex(t_arena *arena, const char *prompt, size_t len, t_token **out)
+{
+	t_lexer	lx;
+	int		ok;
+
+	ok = lex_all(&lx, arena, prompt, len);
+	if (lx.open)
+		fprintf(stderr, "minishell: syntax error: unclosed `%.*s'\n",
+			1 + (*lx.open == '$'), lx.open);
+	*out = lx.head;
+	return (ok);
+}
+
+/* lex() for a line of a script: when it ends inside a quote or a
+ * `${` nothing is reported and -1 is returned, the word goes on
+ * in the next line */
+int	lex_more(t_arena *arena, const char *text, size_t len, t_token **out)
+{
+	t_lexer	lx;
+	int		ok;
+
+	ok = lex_all(&lx, arena, text, len);
+	*out = lx.head;
+	if (lx.open)
+		return (-1);
+	return (ok);
+}
@@ -0,0 +1,47 @@
+#ifndef LEXER_H
+# define LEXER_H
+
+# include <stddef.h>
+
+# include "arena.h"
+# include "ast.h"
+
+/* The lexer looks at 32 (AVX2) or 16 (SSE2) bytes of the prompt
+ * at once when searching for the next metacharacter. Building
+ * with -mavx2 enables the wider variant, a plain scalar loop is
+ * used where neither instruction set is available */
+# if defined(__AVX2__)
+#  define LEX_SIMD_WIDTH	32
+# elif defined(__SSE2__)
+#  define LEX_SIMD_WIDTH	16
+# else
+#  define LEX_SIMD_WIDTH	1
+# endif
+
+/* Exit status of a prompt that failed to tokenize (as in bash) */
+# define LEX_SYNTAX_ERR		2
+
+/* s	 - the prompt (need not be NUL-terminated);
+ * len	 - its length, computed once by the caller;
+ * pos	 - index of the next byte to look at;
+ * arena - where tokens and their values are allocated;
+ * head, tail - the token list built so far;
+ * open	 - the quote or `${` the prompt ends inside, NULL if none. */
+typedef struct s_lexer
+{
+	const char	*s;
+	size_t		len;
+	size_t		pos;
+	t_arena		*arena;
+	t_token		*head;
+	t_token		*tail;
+	const char	*open;
+}	t_lexer;
+
+int		lex(t_arena *arena, const char *prompt, size_t len, t_token **out);
+int		lex_more(t_arena *arena, const char *text, size_t len,
+			t_token **out);
+size_t	lex_next_meta(const char *s, size_t len, size_t pos);
+int		lex_is_meta(unsigned char c);
+
+#endif
@@ -0,0 +1,79 @@
+#include "lexer.h"
+
+#if LEX_SIMD_WIDTH > 1
+# include <immintrin.h>
+#endif
+
+/* Bytes that end (or need special care inside) a word */
+static const unsigned char	g_meta[256] = {
+	[' '] = 1, ['\t'] = 1, ['\n'] = 1, ['|'] = 1, ['&'] = 1, ['('] = 1,
+	[')'] = 1, ['<'] = 1, ['>'] = 1, ['\''] = 1, ['"'] = 1, ['$'] = 1,
+	[';'] = 1, ['\\'] = 1
+};
+
+#if LEX_SIMD_WIDTH == 32
+typedef __m256i	t_lex_vec;
+# define LEX_LOAD(p)	_mm256_loadu_si256((const __m256i *)(p))
+# define LEX_EQ(v, c)	_mm256_cmpeq_epi8((v), _mm256_set1_epi8(c))
+# define LEX_OR(a, b)	_mm256_or_si256((a), (b))
+# define LEX_MASK(m)	((unsigned int)_mm256_movemask_epi8(m))
+#elif LEX_SIMD_WIDTH == 16
+typedef __m128i	t_lex_vec;
+# define LEX_LOAD(p)	_mm_loadu_si128((const __m128i *)(p))
+# define LEX_EQ(v, c)	_mm_cmpeq_epi8((v), _mm_set1_epi8(c))
+# define LEX_OR(a, b)	_mm_or_si128((a), (b))
+# define LEX_MASK(m)	((unsigned int)_mm_movemask_epi8(m))
+#endif
+
+int	lex_is_meta(unsigned char c)
+{
+	return (g_meta[c]);
+}
+
+#if LEX_SIMD_WIDTH > 1
+
+/* Returns a bit mask with bit i set when p[i] is a metacharacter */
+static unsigned int	meta_mask(const char *p)
+{
+	t_lex_vec	v;
+	t_lex_vec	m;
+
+	v = LEX_LOAD(p);
+	m = LEX_OR(LEX_EQ(v, ' '), LEX_EQ(v, '\t'));
+	m = LEX_OR(m, LEX_EQ(v, '\n'));
+	m = LEX_OR(m, LEX_EQ(v, '|'));
+	m = LEX_OR(m, LEX_EQ(v, '&'));
+	m = LEX_OR(m, LEX_EQ(v, ';'));
+	m = LEX_OR(m, LEX_EQ(v, '('));
+	m = LEX_OR(m, LEX_EQ(v, ')'));
+	m = LEX_OR(m, LEX_EQ(v, '<'));
+	m = LEX_OR(m, LEX_EQ(v, '>'));
+	m = LEX_OR(m, LEX_EQ(v, '\''));
+	m = LEX_OR(m, LEX_EQ(v, '"'));
+	m = LEX_OR(m, LEX_EQ(v, '$'));
+	m = LEX_OR(m, LEX_EQ(v, '\\'));
+	return (LEX_MASK(m));
+}
+
+#endif
+
+/* Returns the index of the first metacharacter at or after
+ * `pos`, or `len` if there is none. Whole SIMD blocks are
+ * checked while they fit, the tail is scanned byte by byte */
+size_t	lex_next_meta(const char *s, size_t len, size_t pos)
+{
+#if LEX_SIMD_WIDTH > 1
+	unsigned int	mask;
+
+	while (pos + LEX_SIMD_WIDTH <= len)
+	{
+		mask = meta_mask(s + pos);
+		if (mask)
+			return (pos + __builtin_ctz(mask));
+		pos += LEX_SIMD_WIDTH;
+	}
+#endif
+	while (pos < len && !g_meta[(unsigned char)s[pos]])
+		++pos;
+	return (pos);
+}
@@ -1,6 +1,17 @@
 #include <stdio.h>
+#include <string.h>
+
+#include "engine.h"
 
 int	main(int argc, char **argv, char **env)
 {
-	return (0);
+	t_settings		settings;
+	t_engine_params	params;
+
+	memset(&settings, 0, sizeof(settings));
+	memset(&params, 0, sizeof(params));
+	params.env = env;
+	if (!init_settings(&settings, &params, argc, argv))
+		return (EXIT_USAGE);
+	return (engine(&params));
 }
@@ -0,0 +1,186 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "aux.h"
+#include "htab.h"
+#include "parse_cache.h"
+
+void	pcache_init(t_parse_cache *pc)
+{
+	memset(pc, 0, sizeof(*pc));
+}
+
+/* Drops every plan. The one being executed (`parsecache -r`
+ * can flush the cache from inside a cached prompt) is kept
+ * until pcache_done() */
+void	pcache_flush(t_parse_cache *pc)
+{
+	t_pcache_entry	*e;
+
+	while (pc->newest)
+	{
+		e = pc->newest;
+		pc->newest = e->older;
+		if (e == pc->running)
+			pc->orphan = e;
+		else
+			free(e);
+	}
+	if (pc->cnt)
+		++pc->stats.flushes;
+	if (pc->tab)
+		memset(pc->tab, 0, PCACHE_TAB_CAP * sizeof(*pc->tab));
+	pc->oldest = NULL;
+	pc->cnt = 0;
+	pc->bytes = 0;
+}
+
+void	pcache_free(t_parse_cache *pc)
+{
+	pcache_done(pc);
+	pcache_flush(pc);
+	free(pc->tab);
+	pc->tab = NULL;
+}
+
+/* Returns the slot holding the prompt or the empty slot where it
+ * belongs. The table is never more than half full */
+static t_pcache_entry	**pcache_slot(t_parse_cache *pc, const char *prompt,
+	size_t len, uint64_t h)
+{
+	size_t	i;
+
+	i = h & (PCACHE_TAB_CAP - 1);
+	while (pc->tab[i] && (pc->tab[i]->hash != h || pc->tab[i]->len != len
+			|| memcmp(pc->tab[i]->prompt, prompt, len)))
+		i = (i + 1) & (PCACHE_TAB_CAP - 1);
+	return (&pc->tab[i]);
+}
+
+static void	lru_unlink(t_parse_cache *pc, t_pcache_entry *e)
+{
+	if (e->newer)
+		e->newer->older = e->older;
+	else
+		pc->newest = e->older;
+	if (e->older)
+		e->older->newer = e->newer;
+	else
+		pc->oldest = e->newer;
+}
+
+static void	lru_push(t_parse_cache *pc, t_pcache_entry *e)
+{
+	e->newer = NULL;
+	e->older = pc->newest;
+	if (pc->newest)
+		pc->newest->newer = e;
+	else
+		pc->oldest = e;
+	pc->newest = e;
+}
+
+/* Plan of `prompt` if it is cached, NULL otherwise */
+t_ast	*pcache_get(t_parse_cache *pc, const char *prompt, size_t len)
+{
+	t_pcache_entry	*e;
+
+	e = NULL;
+	if (pc->tab)
+		e = *pcache_slot(pc, prompt, len, aux_hash(prompt, len));
+	if (!e)
+	{
+		++pc->stats.misses;
+		return (NULL);
+	}
+	++pc->stats.hits;
+	lru_unlink(pc, e);
+	lru_push(pc, e);
+	pc->running = e;
+	return (e->ast);
+}
+
+/* The plan returned by the last pcache_get() is no longer used */
+void	pcache_done(t_parse_cache *pc)
+{
+	free(pc->orphan);
+	pc->orphan = NULL;
+	pc->running = NULL;
+}
+
+static size_t	pcache_home(const void *slot, size_t mask)
+{
+	return ((*(t_pcache_entry *const *)slot)->hash & mask);
+}
+
+static bool	pcache_used(const void *slot)
+{
+	return (*(t_pcache_entry *const *)slot != NULL);
+}
+
+static const t_htab	g_pcache_htab = {
+	sizeof(t_pcache_entry *), PCACHE_TAB_CAP, pcache_home, pcache_used
+};
+
+/* Drops the least recently used plan, see htab_remove() */
+static void	pcache_evict(t_parse_cache *pc)
+{
+	t_pcache_entry	*e;
+
+	e = pc->oldest;
+	htab_remove(&g_pcache_htab, pc->tab, PCACHE_TAB_CAP,
+		pcache_slot(pc, e->prompt, e->len, e->hash) - pc->tab);
+	lru_unlink(pc, e);
+	pc->bytes -= e->bytes;
+	--pc->cnt;
+	++pc->stats.evictions;
+	free(e);
+}
+
+/* Remembers the plan of a prompt that missed. The entry, the
+ * prompt text and a copy of the tree share one allocation. Long
+ * prompts are turned away before their tree is even measured */
+void	pcache_put(t_parse_cache *pc, const char *prompt, size_t len,
+	const t_ast *ast)
+{
+	t_pcache_entry	*e;
+	size_t			text;
+	size_t			bytes;
+	char			*mem;
+
+	if (len > PCACHE_MAX_PROMPT)
+		return ;
+	text = (len + sizeof(void *)) & ~(sizeof(void *) - 1);
+	bytes = ast_clone_size(ast);
+	if (bytes > PCACHE_MAX_BYTES)
+		return ;
+	bytes += sizeof(*e) + text;
+	if (bytes > PCACHE_MAX_BYTES)
+		return ;
+	if (!pc->tab)
+		pc->tab = calloc(PCACHE_TAB_CAP, sizeof(*pc->tab));
+	if (!pc->tab)
+		return ;
+	while (pc->cnt && (pc->cnt >= PCACHE_MAX_ENTRIES
+			|| pc->bytes + bytes > PCACHE_MAX_BYTES))
+		pcache_evict(pc);
+	e = malloc(bytes);
+	if (!e)
+		return ;
+	mem = (char *)(e + 1);
+	e->prompt = memcpy(mem, prompt, len);
+	mem += text;
+	e->ast = ast_clone(ast, &mem);
+	if (!e->ast)
+	{
+		free(e);
+		return ;
+	}
+	e->len = len;
+	e->hash = aux_hash(prompt, len);
+	e->bytes = bytes;
+	*pcache_slot(pc, prompt, len, e->hash) = e;
+	lru_push(pc, e);
+	pc->bytes += bytes;
+	++pc->cnt;
+}
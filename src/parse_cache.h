@@ -0,0 +1,76 @@
+#ifndef PARSE_CACHE_H
+# define PARSE_CACHE_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "ast.h"
+
+/* Bounds of the cache: least recently used plans are dropped
+ * first. Longer prompts are never cached */
+# define PCACHE_MAX_ENTRIES	256
+# define PCACHE_MAX_BYTES	(1L << 20)
+# define PCACHE_MAX_PROMPT	4096
+/* Slots of the hash table, twice PCACHE_MAX_ENTRIES */
+# define PCACHE_TAB_CAP		512
+
+/* One cached prompt, allocated as a single block that also holds
+ * the prompt text and the whole tree.
+ * prompt		- the raw prompt, `len` bytes, not terminated;
+ * ast			- its parsed plan, never modified by the executor;
+ * bytes		- size of the block;
+ * newer, older	- neighbours in the LRU list. */
+typedef struct s_pcache_entry
+{
+	const char				*prompt;
+	size_t					len;
+	uint64_t				hash;
+	t_ast					*ast;
+	size_t					bytes;
+	struct s_pcache_entry	*newer;
+	struct s_pcache_entry	*older;
+}	t_pcache_entry;
+
+typedef struct s_pcache_stats
+{
+	size_t	hits;
+	size_t	misses;
+	size_t	evictions;
+	size_t	flushes;
+}	t_pcache_stats;
+
+/* Raw prompt -> AST, so a prompt seen before is neither lexed nor
+ * parsed again. Parsing only depends on the prompt text; anything
+ * that would change how a text parses (aliases) must call
+ * pcache_flush(). Scripts and -c look their commands up by their
+ * text too, so a command repeated in a file is parsed once. Their
+ * texts may span lines, prompts never do.
+ * tab				- open addressing table of PCACHE_TAB_CAP slots,
+ *					  allocated on the first insertion;
+ * newest, oldest	- ends of the LRU list;
+ * bytes			- memory held by the entries;
+ * running			- entry returned by the last pcache_get(), whose
+ *					  tree may still be executing;
+ * orphan			- `running` after it was flushed: freed only by
+ *					  pcache_done(), once its tree is no longer used. */
+typedef struct s_parse_cache
+{
+	t_pcache_entry	**tab;
+	size_t			cnt;
+	size_t			bytes;
+	t_pcache_entry	*newest;
+	t_pcache_entry	*oldest;
+	t_pcache_entry	*running;
+	t_pcache_entry	*orphan;
+	t_pcache_stats	stats;
+}	t_parse_cache;
+
+void	pcache_init(t_parse_cache *pc);
+void	pcache_flush(t_parse_cache *pc);
+void	pcache_free(t_parse_cache *pc);
+t_ast	*pcache_get(t_parse_cache *pc, const char *prompt, size_t len);
+void	pcache_done(t_parse_cache *pc);
+void	pcache_put(t_parse_cache *pc, const char *prompt, size_t len,
+			const t_ast *ast);
+
+#endif
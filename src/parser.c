@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "parser.h"
+
+static void	*parse_error(t_parser *p)
+{
+	if (!p->err)
+	{
+		if (p->tok)
+			fprintf(stderr, "minishell: syntax error near unexpected "
+				"token `%s'\n", p->tok->value);
+		else
+			fprintf(stderr, "minishell: syntax error near unexpected "
+				"token `newline'\n");
+	}
+	p->err = 1;
+	return (NULL);
+}
+
+static void	*parse_nomem(t_parser *p)
+{
+	if (!p->err)
+		perror("minishell");
+	p->err = 1;
+	return (NULL);
+}
+
+static int	is_redir(t_token *tok)
+{
+	return (tok && (tok->type == T_REDIR_IN || tok->type == T_REDIR_OUT
+			|| tok->type == T_APPEND || tok->type == T_HEREDOC));
+}
+
+/* Appends the redirection at `p->tok` (operator and its word)
+ * to the list whose last `next` pointer is `*tail` */
+static int	parse_redir(t_parser *p, t_redi_node ***tail)
+{
+	t_token_type	type;
+
+	type = p->tok->type;
+	p->tok = p->tok->next;
+	if (!p->tok || p->tok->type != T_WORD)
+	{
+		parse_error(p);
+		return (0);
+	}
+	**tail = redi_new(p->arena, type, p->tok->value);
+	if (!**tail)
+	{
+		parse_nomem(p);
+		return (0);
+	}
+	*tail = &(**tail)->next;
+	p->tok = p->tok->next;
+	return (1);
+}
+
+static t_ast	*parse_simple(t_parser *p, t_ast *cmd)
+{
+	t_redi_node	**tail;
+	t_token		*tok;
+	size_t		argc;
+
+	argc = 0;
+	tok = p->tok;
+	while (tok && (tok->type == T_WORD || is_redir(tok)))
+	{
+		argc += (tok->type == T_WORD);
+		if (is_redir(tok) && tok->next)
+			tok = tok->next;
+		tok = tok->next;
+	}
+	cmd->args = arena_alloc(p->arena, (argc + 1) * sizeof(char *));
+	if (!cmd->args)
+		return (parse_nomem(p));
+	argc = 0;
+	tail = &cmd->redirections;
+	while (p->tok && (p->tok->type == T_WORD || is_redir(p->tok)))
+	{
+		if (p->tok->type == T_WORD)
+		{
+			cmd->args[argc++] = p->tok->value;
+			p->tok = p->tok->next;
+		}
+		else if (!parse_redir(p, &tail))
+			return (NULL);
+	}
+	cmd->args[argc] = NULL;
+	return (cmd);
+}
+
+/* The reserved word `word` ("{" or "}") where a command starts */
+static int	is_reserved(t_token *tok, const char *word)
+{
+	return (tok && tok->type == T_WORD && !strcmp(tok->value, word));
+}
+
+/* Opens a `(` or `{` level for each one where a command starts,
+ * then parses the simple command inside the innermost one */
+static t_ast	*parse_command(t_parser *p, t_vector *levels)
+{
+	t_parse_level	*lv;
+	t_ast			*node;
+
+	while ((p->tok && p->tok->type == T_LEFT_PAREN)
+		|| is_reserved(p->tok, "{"))
+	{
+		lv = vec_emplace(levels);
+		if (!lv)
+			return (parse_nomem(p));
+		memset(lv, 0, sizeof(*lv));
+		lv->type = NODE_GROUP;
+		if (p->tok->type == T_LEFT_PAREN)
+			lv->type = NODE_SUBSHELL;
+		p->tok = p->tok->next;
+	}
+	if (!p->tok || (p->tok->type != T_WORD && !is_redir(p->tok))
+		|| is_reserved(p->tok, "}"))
+		return (parse_error(p));
+	node = ast_new(p->arena, NODE_CMD, NULL, NULL);
+	if (!node)
+		return (parse_nomem(p));
+	return (parse_simple(p, node));
+}
+
+/* Adds the and_or list that just ended to the list of `lv`. Each
+ * `&` or `;` makes a BG or SEQ node whose right side is the rest
+ * of the list. Returns 1 if another command follows */
+static int	parse_job(t_parser *p, t_parse_level *lv)
+{
+	t_ast		**tail;
+	t_node_type	type;
+
+	tail = &lv->list;
+	if (lv->last)
+		tail = &lv->last->right;
+	if (!p->tok || (p->tok->type != T_BG && p->tok->type != T_SEMI))
+	{
+		*tail = lv->and_or;
+		return (0);
+	}
+	type = NODE_SEQ;
+	if (p->tok->type == T_BG)
+		type = NODE_BG;
+	p->tok = p->tok->next;
+	*tail = ast_new(p->arena, type, lv->and_or, NULL);
+	lv->last = *tail;
+	lv->and_or = NULL;
+	if (!*tail)
+		return (parse_nomem(p) != NULL);
+	return (p->tok && p->tok->type != T_RIGHT_PAREN
+		&& !is_reserved(p->tok, "}"));
+}
+
+/* Adds the command `cmd` that just ended to the pipeline, and_or
+ * list and list of `lv`, left-leaning. Returns 1 if another
+ * command follows, 0 once the list of `lv` is over */
+static int	parse_operand(t_parser *p, t_parse_level *lv, t_ast *cmd)
+{
+	if (lv->pipe)
+		cmd = ast_new(p->arena, NODE_PIPE, lv->pipe, cmd);
+	lv->pipe = cmd;
+	if (cmd && p->tok && p->tok->type == T_PIPE)
+	{
+		p->tok = p->tok->next;
+		return (1);
+	}
+	if (cmd && lv->and_or)
+		cmd = ast_new(p->arena, lv->op, lv->and_or, cmd);
+	lv->and_or = cmd;
+	lv->pipe = NULL;
+	if (!cmd)
+		return (parse_nomem(p) != NULL);
+	if (!p->tok || (p->tok->type != T_AND && p->tok->type != T_OR))
+		return (parse_job(p, lv));
+	lv->op = NODE_OR;
+	if (p->tok->type == T_AND)
+		lv->op = NODE_AND;
+	p->tok = p->tok->next;
+	return (1);
+}
+
+/* The list of the innermost level is over: its `)` or `}` and the
+ * redirections after it end the compound command, which becomes a
+ * command of the level around it */
+static t_ast	*parse_close(t_parser *p, t_vector *levels)
+{
+	t_parse_level	lv;
+	t_ast			*node;
+	t_redi_node		**tail;
+
+	lv = VEC_LAST(levels, t_parse_level);
+	vec_pop(levels);
+	if ((lv.type == NODE_SUBSHELL && (!p->tok
+				|| p->tok->type != T_RIGHT_PAREN))
+		|| (lv.type == NODE_GROUP && !is_reserved(p->tok, "}")))
+		return (parse_error(p));
+	node = ast_new(p->arena, lv.type, lv.list, NULL);
+	if (!node)
+		return (parse_nomem(p));
+	p->tok = p->tok->next;
+	tail = &node->redirections;
+	while (is_redir(p->tok))
+		if (!parse_redir(p, &tail))
+			return (NULL);
+	return (node);
+}
+
+/* The whole grammar without recursion: a level on `levels` holds
+ * what is being built inside each `(` or `{` that is open, the
+ * first one is the prompt itself. However deep the nesting, the
+ * C stack does not grow */
+static t_ast	*parse_levels(t_parser *p, t_vector *levels)
+{
+	t_ast	*node;
+
+	while (!p->err)
+	{
+		node = parse_command(p, levels);
+		while (node && !p->err
+			&& !parse_operand(p, &VEC_LAST(levels, t_parse_level), node))
+		{
+			if (p->err)
+				return (NULL);
+			if (levels->len == 1)
+				return (VEC_AT(levels, t_parse_level, 0).list);
+			node = parse_close(p, levels);
+		}
+	}
+	return (NULL);
+}
+
+/* Builds the AST of a whole prompt. `*out` is NULL for an empty
+ * prompt. Returns 0 (the error has been reported) on bad syntax */
+int	parse(t_arena *arena, t_token *tokens, t_ast **out)
+{
+	t_parser	p;
+	t_vector	levels;
+
+	p.tok = tokens;
+	p.arena = arena;
+	p.err = 0;
+	*out = NULL;
+	if (!tokens)
+		return (1);
+	vec_init(&levels, sizeof(t_parse_level));
+	if (!vec_emplace(&levels))
+		parse_nomem(&p);
+	else
+	{
+		memset(vec_data(&levels), 0, sizeof(t_parse_level));
+		*out = parse_levels(&p, &levels);
+	}
+	vec_free(&levels);
+	if (!p.err && p.tok)
+		parse_error(&p);
+	return (!p.err);
+}
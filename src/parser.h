@@ -0,0 +1,51 @@
+#ifndef PARSER_H
+# define PARSER_H
+
+# include "arena.h"
+# include "ast.h"
+# include "vector.h"
+
+/* Exit status of a prompt with a syntax error (as in bash) */
+# define PARSE_SYNTAX_ERR	2
+
+/* tok	 - the next token to look at (NULL at the end of the prompt);
+ * arena - where the AST nodes and argv arrays are allocated;
+ * err	 - set once a syntax error has been reported. */
+typedef struct s_parser
+{
+	t_token	*tok;
+	t_arena	*arena;
+	int		err;
+}	t_parser;
+
+/* What is being built inside one `(` or `{` that is open.
+ * type	  - NODE_SUBSHELL or NODE_GROUP, the node it will make;
+ * list	  - its list so far, `last` the BG or SEQ node ending it;
+ * and_or - the && / || list being built, `op` the operator before
+ *			the pipeline being built;
+ * pipe	  - the pipeline being built. */
+typedef struct s_parse_level
+{
+	t_node_type	type;
+	t_ast		*list;
+	t_ast		*last;
+	t_ast		*and_or;
+	t_node_type	op;
+	t_ast		*pipe;
+}	t_parse_level;
+
+/* Grammar:
+ *     list     := and_or { sep and_or } [ sep ]
+ *     sep      := '&' | ';'
+ *     and_or   := pipeline { ('&&' | '||') pipeline }
+ *     pipeline := command { '|' command }
+ *     command  := ('(' list ')' | '{' list '}') { redir }
+ *               | { word | redir }+
+ *     redir    := ('<' | '>' | '>>' | '<<') word
+ * `{` and `}` are words, reserved only where a command starts, so
+ * `}` needs a separator before it as in bash: "{ a; b; }".
+ * Binary nodes lean to the left: "a | b | c" is PIPE(PIPE(a, b), c),
+ * except BG and SEQ: "a & b ; c" is BG(a, SEQ(b, c)) */
+int	parse(t_arena *arena, t_token *tokens, t_ast **out);
+
+#endif
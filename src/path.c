@@ -0,0 +1,183 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aux.h"
+#include "htab.h"
+#include "path.h"
+
+void	path_cache_init(t_path_cache *pc)
+{
+	memset(pc, 0, sizeof(*pc));
+	pc->gen = 1;
+}
+
+/* Forgets every command (`hash -r`, or PATH has changed) */
+void	path_cache_flush(t_path_cache *pc)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < pc->cap)
+	{
+		free(pc->tab[i].name);
+		free(pc->tab[i].path);
+		++i;
+	}
+	free(pc->tab);
+	pc->tab = NULL;
+	pc->cap = 0;
+	if (pc->cnt)
+		++pc->stats.flushes;
+	pc->cnt = 0;
+}
+
+void	path_cache_free(t_path_cache *pc)
+{
+	path_cache_flush(pc);
+	path_dirs_free(pc);
+}
+
+/* Called once per prompt: directory mtimes read
+ * during the previous prompt are no longer trusted */
+void	path_cache_tick(t_path_cache *pc)
+{
+	++pc->gen;
+}
+
+/* Called after a change of directory: commands found through
+ * relative PATH entries (such as an empty one) no longer apply */
+void	path_cache_chdir(t_path_cache *pc)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < pc->dir_cnt && pc->dirs[i].name[0] == '/')
+		++i;
+	if (i < pc->dir_cnt)
+		path_dirs_free(pc);
+}
+
+/* Returns the slot holding `name` or the empty slot where it
+ * belongs. The table always has at least one empty slot */
+static t_path_entry	*path_slot(t_path_cache *pc, const char *name,
+	uint64_t h)
+{
+	size_t	i;
+
+	i = h & (pc->cap - 1);
+	while (pc->tab[i].name && (pc->tab[i].hash != h
+			|| strcmp(pc->tab[i].name, name)))
+		i = (i + 1) & (pc->cap - 1);
+	return (&pc->tab[i]);
+}
+
+static size_t	path_home(const void *slot, size_t mask)
+{
+	return (((const t_path_entry *)slot)->hash & mask);
+}
+
+static bool	path_used(const void *slot)
+{
+	return (((const t_path_entry *)slot)->name != NULL);
+}
+
+static const t_htab	g_path_htab = {
+	sizeof(t_path_entry), PATH_CACHE_INIT_CAP, path_home, path_used
+};
+
+/* See htab_grow() */
+static int	path_grow(t_path_cache *pc)
+{
+	return (htab_grow(&g_path_htab, (void **)&pc->tab, &pc->cap,
+			pc->cnt));
+}
+
+/* Is a cached answer still right? A found command stays valid
+ * while its directory keeps the same mtime, "not found" is only
+ * trusted for PATH_NEG_TTL_MS */
+static int	path_fresh(t_path_cache *pc, t_path_entry *e)
+{
+	struct timespec	now;
+	t_path_dir		*d;
+
+	if (!e->path)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (now.tv_sec < e->expires.tv_sec
+			|| (now.tv_sec == e->expires.tv_sec
+				&& now.tv_nsec < e->expires.tv_nsec));
+	}
+	d = path_dir_stat(pc, e->dir);
+	return (d->exists && d->mtime.tv_sec == e->mtime.tv_sec
+		&& d->mtime.tv_nsec == e->mtime.tv_nsec);
+}
+
+static void	path_store(t_path_cache *pc, t_path_entry *e, char *path,
+	size_t dir)
+{
+	free(e->path);
+	e->path = path;
+	e->hits = 1;
+	if (path)
+	{
+		e->dir = dir;
+		e->mtime = pc->dirs[dir].mtime;
+		return ;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &e->expires);
+	e->expires.tv_sec += PATH_NEG_TTL_MS / 1000;
+	e->expires.tv_nsec += (PATH_NEG_TTL_MS % 1000) * 1000000L;
+	if (e->expires.tv_nsec >= 1000000000L)
+	{
+		e->expires.tv_nsec -= 1000000000L;
+		++e->expires.tv_sec;
+	}
+}
+
+/* Resolves a command name (without '/') to the absolute path of
+ * the executable using `path_var` as PATH. The returned string
+ * belongs to the cache. Returns NULL with errno set to ENOENT
+ * when the command is not found */
+const char	*path_lookup(t_path_cache *pc, const char *name,
+	const char *path_var)
+{
+	t_path_entry	*e;
+	uint64_t		h;
+	size_t			dir;
+
+	dir = 0;
+	if (!pc->path_var || strcmp(pc->path_var, path_var))
+	{
+		path_cache_flush(pc);
+		if (!path_dirs_set(pc, path_var))
+			return (NULL);
+	}
+	if (!path_grow(pc))
+		return (NULL);
+	h = aux_hash(name, strlen(name));
+	e = path_slot(pc, name, h);
+	if (e->name && path_fresh(pc, e))
+	{
+		pc->stats.hits += (e->path != NULL);
+		pc->stats.neg_hits += (e->path == NULL);
+		++e->hits;
+	}
+	else
+	{
+		pc->stats.invalidations += (e->name != NULL);
+		++pc->stats.misses;
+		if (!e->name)
+		{
+			e->name = strdup(name);
+			if (!e->name)
+				return (NULL);
+			e->hash = h;
+			++pc->cnt;
+		}
+		path_store(pc, e, path_search(pc, name, &dir), dir);
+	}
+	if (!e->path)
+		errno = ENOENT;
+	return (e->path);
+}
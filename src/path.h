@@ -0,0 +1,85 @@
+#ifndef PATH_H
+# define PATH_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <time.h>
+
+# define PATH_CACHE_INIT_CAP	64
+/* How long "command not found" is remembered */
+# define PATH_NEG_TTL_MS		1000
+
+/* One directory of PATH.
+ * mtime	- its modification time, changes whenever a file is
+ *			  added to or removed from it;
+ * checked	- cache generation `mtime` was read in: a directory
+ *			  is stat(2)ed at most once per prompt;
+ * exists	- false if stat(2) failed. */
+typedef struct s_path_dir
+{
+	char			*name;
+	struct timespec	mtime;
+	unsigned long	checked;
+	bool			exists;
+}	t_path_dir;
+
+/* name		- command name, NULL for an empty slot;
+ * path		- absolute path, NULL for a negative entry;
+ * dir		- index of the directory `path` was found in;
+ * mtime	- that directory's mtime when `path` was found;
+ * expires	- when a negative entry stops being trusted;
+ * hits		- how many times the entry was used. */
+typedef struct s_path_entry
+{
+	char			*name;
+	char			*path;
+	uint64_t		hash;
+	size_t			dir;
+	struct timespec	mtime;
+	struct timespec	expires;
+	size_t			hits;
+}	t_path_entry;
+
+typedef struct s_path_stats
+{
+	size_t	hits;
+	size_t	misses;
+	size_t	neg_hits;
+	size_t	invalidations;
+	size_t	flushes;
+}	t_path_stats;
+
+/* Command name -> absolute path table, like bash's `hash`.
+ * tab		 - open addressing table, `cap` is a power of 2;
+ * path_var	 - the PATH value the table was built for, the
+ *			   table is flushed as soon as PATH changes;
+ * dirs		 - `path_var` split on ':';
+ * gen		 - bumped once per prompt by path_cache_tick(). */
+typedef struct s_path_cache
+{
+	t_path_entry	*tab;
+	size_t			cap;
+	size_t			cnt;
+	char			*path_var;
+	t_path_dir		*dirs;
+	size_t			dir_cnt;
+	unsigned long	gen;
+	t_path_stats	stats;
+}	t_path_cache;
+
+void		path_cache_init(t_path_cache *pc);
+void		path_cache_flush(t_path_cache *pc);
+void		path_cache_free(t_path_cache *pc);
+void		path_cache_tick(t_path_cache *pc);
+void		path_cache_chdir(t_path_cache *pc);
+const char	*path_lookup(t_path_cache *pc, const char *name,
+				const char *path_var);
+
+/* path_dirs.c */
+void		path_dirs_free(t_path_cache *pc);
+int			path_dirs_set(t_path_cache *pc, const char *path_var);
+t_path_dir	*path_dir_stat(t_path_cache *pc, size_t i);
+char		*path_search(t_path_cache *pc, const char *name, size_t *dir);
+
+#endif
@@ -0,0 +1,101 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "path.h"
+
+void	path_dirs_free(t_path_cache *pc)
+{
+	size_t	i;
+
+	i = 0;
+	while (i < pc->dir_cnt)
+		free(pc->dirs[i++].name);
+	free(pc->dirs);
+	free(pc->path_var);
+	pc->dirs = NULL;
+	pc->dir_cnt = 0;
+	pc->path_var = NULL;
+}
+
+/* Splits PATH on ':'. An empty component means the current
+ * directory, as in every other shell */
+int	path_dirs_set(t_path_cache *pc, const char *path_var)
+{
+	const char	*p;
+	size_t		n;
+
+	path_dirs_free(pc);
+	pc->path_var = strdup(path_var);
+	n = 1;
+	p = path_var;
+	while (*p)
+		n += (*p++ == ':');
+	pc->dirs = calloc(n, sizeof(*pc->dirs));
+	if (!pc->path_var || !pc->dirs)
+	{
+		path_dirs_free(pc);
+		return (0);
+	}
+	while (pc->dir_cnt < n)
+	{
+		p = strchr(path_var, ':');
+		if (!p)
+			p = path_var + strlen(path_var);
+		if (p == path_var)
+			pc->dirs[pc->dir_cnt].name = strdup(".");
+		else
+			pc->dirs[pc->dir_cnt].name = strndup(path_var, p - path_var);
+		if (!pc->dirs[pc->dir_cnt++].name)
+		{
+			path_dirs_free(pc);
+			return (0);
+		}
+		path_var = p + (*p == ':');
+	}
+	return (1);
+}
+
+/* Returns the directory with its mtime read during this prompt */
+t_path_dir	*path_dir_stat(t_path_cache *pc, size_t i)
+{
+	t_path_dir	*d;
+	struct stat	st;
+
+	d = &pc->dirs[i];
+	if (d->checked == pc->gen)
+		return (d);
+	d->checked = pc->gen;
+	d->exists = (stat(d->name, &st) == 0);
+	if (d->exists)
+		d->mtime = st.st_mtim;
+	return (d);
+}
+
+/* Looks for an executable regular file `name` in every PATH
+ * directory. Returns its malloc'ed path or NULL if not found */
+char	*path_search(t_path_cache *pc, const char *name, size_t *dir)
+{
+	char		buf[PATH_MAX];
+	struct stat	st;
+	size_t		i;
+
+	i = 0;
+	while (i < pc->dir_cnt)
+	{
+		if (path_dir_stat(pc, i)->exists
+			&& snprintf(buf, sizeof(buf), "%s/%s", pc->dirs[i].name, name)
+			< (int) sizeof(buf)
+			&& stat(buf, &st) == 0 && S_ISREG(st.st_mode)
+			&& access(buf, X_OK) == 0)
+		{
+			*dir = i;
+			return (strdup(buf));
+		}
+		++i;
+	}
+	return (NULL);
+}
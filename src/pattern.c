@@ -0,0 +1,230 @@
+#include <ctype.h>
+#include <fnmatch.h>
+#include <string.h>
+
+#include "pattern.h"
+
+/* Classes of [[:name:]] */
+typedef struct s_pattern_class
+{
+	const char	*name;
+	int			(*is)(int);
+}	t_pattern_class;
+
+static const t_pattern_class	g_classes[] = {
+	{"alnum", isalnum}, {"alpha", isalpha}, {"blank", isblank},
+	{"cntrl", iscntrl}, {"digit", isdigit}, {"graph", isgraph},
+	{"lower", islower}, {"print", isprint}, {"punct", ispunct},
+	{"space", isspace}, {"upper", isupper}, {"xdigit", isxdigit}
+};
+
+/* [:name:] at `p`, added to `set`. Returns its length, 0 if it is
+ * not a known class */
+static size_t	pattern_posix(const char *p, const char *end, bool *set)
+{
+	const char	*close;
+	size_t		i;
+	int			c;
+
+	close = p + 2;
+	while (close + 1 < end && (close[0] != ':' || close[1] != ']'))
+		++close;
+	if (close + 1 >= end)
+		return (0);
+	i = 0;
+	while (i < sizeof(g_classes) / sizeof(*g_classes)
+		&& (strlen(g_classes[i].name) != (size_t)(close - p - 2)
+			|| strncmp(g_classes[i].name, p + 2, close - p - 2)))
+		++i;
+	if (i == sizeof(g_classes) / sizeof(*g_classes))
+		return (0);
+	c = 1;
+	while (c < 256)
+	{
+		if (g_classes[i].is(c))
+			set[c] = true;
+		++c;
+	}
+	return (close + 2 - p);
+}
+
+/* The byte at `*s` in a bracket, a backslash quoting the next one */
+static unsigned char	pattern_byte(const char **s, const char *end)
+{
+	if (**s == '\\' && *s + 1 < end)
+		++*s;
+	return ((unsigned char)*(*s)++);
+}
+
+/* Adds the bytes from `lo` to `hi` to `set`, none if reversed */
+static void	pattern_range(bool *set, unsigned char lo, unsigned char hi)
+{
+	int	c;
+
+	c = lo;
+	while (c <= hi)
+		set[c++] = true;
+}
+
+/* [...] at `p`: the bytes it accepts go to `set`. A `]` right after
+ * the `[` (or `[!`) is one of them. Returns its length, 0 when the
+ * bracket is not closed and the `[` is a plain byte */
+static size_t	pattern_class(const char *p, const char *end, bool *set)
+{
+	const char		*s;
+	size_t			n;
+	unsigned char	lo;
+	bool			neg;
+
+	memset(set, 0, 256);
+	s = p + 1;
+	neg = (s < end && (*s == '!' || *s == '^'));
+	s += neg;
+	while (s < end && (*s != ']' || s == p + 1 + neg))
+	{
+		n = 0;
+		if (*s == '[' && s + 1 < end && s[1] == ':')
+			n = pattern_posix(s, end, set);
+		s += n;
+		lo = 0;
+		if (!n)
+			lo = pattern_byte(&s, end);
+		if (!n && s + 1 < end && *s == '-' && s[1] != ']')
+		{
+			++s;
+			pattern_range(set, lo, pattern_byte(&s, end));
+		}
+		else if (!n)
+			set[lo] = true;
+	}
+	if (s >= end)
+		return (0);
+	n = 0;
+	while (neg && n < 256)
+	{
+		set[n] = !set[n];
+		++n;
+	}
+	set[0] = false;
+	set['/'] = false;
+	return (s + 1 - p);
+}
+
+/* Whether the `n` bytes of pattern at `p` match nothing but
+ * themselves (with their backslashes removed): `[` alone, `a\*` */
+bool	pattern_is_literal(const char *p, size_t n)
+{
+	bool	set[256];
+	size_t	i;
+
+	i = 0;
+	while (i < n)
+	{
+		if (p[i] == '*' || p[i] == '?')
+			return (false);
+		if (p[i] == '[' && pattern_class(p + i, p + n, set))
+			return (false);
+		i += 1 + (p[i] == '\\' && i + 1 < n);
+	}
+	return (true);
+}
+
+/* The item at `p`, its bytes to `set`. Returns its length */
+static size_t	pattern_item(const char *p, const char *end, bool *set)
+{
+	size_t	n;
+
+	if (*p == '[')
+	{
+		n = pattern_class(p, end, set);
+		if (n)
+			return (n);
+	}
+	memset(set, *p == '?', 256);
+	set[0] = false;
+	set['/'] = false;
+	if (*p == '?')
+		return (1);
+	n = (*p == '\\' && p + 1 < end);
+	set[(unsigned char)p[n]] = true;
+	return (n + 1);
+}
+
+/* Item `bit` accepts the bytes of `set` */
+static void	pattern_add(t_pattern *pt, const bool *set, uint64_t bit)
+{
+	int	c;
+
+	c = 0;
+	while (c < 256)
+	{
+		if (set[c])
+			pt->accept[c] |= bit;
+		++c;
+	}
+}
+
+/* Compiles the `n` bytes of `text`, NUL-terminated there. Quoted
+ * bytes come with a backslash before them */
+void	pattern_compile(t_pattern *pt, const char *text, size_t n)
+{
+	bool	set[256];
+	size_t	i;
+	size_t	items;
+
+	memset(pt, 0, sizeof(*pt));
+	pt->text = text;
+	pt->dot = (text[0] == '.' || (n > 1 && text[0] == '\\'
+				&& text[1] == '.'));
+	items = 0;
+	i = 0;
+	while (i < n && items <= PATTERN_BITS_MAX)
+	{
+		if (text[i] == '*')
+			pt->loop |= 1ULL << items;
+		if (text[i] == '*')
+			++i;
+		else
+		{
+			i += pattern_item(text + i, text + n, set);
+			if (++items <= PATTERN_BITS_MAX)
+				pattern_add(pt, set, 1ULL << items);
+		}
+	}
+	if (items <= PATTERN_BITS_MAX)
+		pt->final = 1ULL << items;
+}
+
+/* Whether `name` matches. A name starting with `.` only matches a
+ * pattern starting with one */
+bool	pattern_match(const t_pattern *pt, const char *name)
+{
+	uint64_t	d;
+
+	if (*name == '.' && !pt->dot)
+		return (false);
+	if (!pt->final)
+		return (!fnmatch(pt->text, name, FNM_PERIOD));
+	d = 1;
+	while (*name && d)
+		d = ((d << 1) & pt->accept[(unsigned char)*name++]) | (d & pt->loop);
+	return ((d & pt->final) != 0);
+}
+
+/* Copies the `n` bytes of pattern at `p` to `dst` (which may be
+ * `p`) without the backslashes that quote a byte. Returns the new
+ * length */
+size_t	pattern_unescape(char *dst, const char *p, size_t n)
+{
+	size_t	i;
+	size_t	k;
+
+	i = 0;
+	k = 0;
+	while (i < n)
+	{
+		i += (p[i] == '\\' && i + 1 < n);
+		dst[k++] = p[i++];
+	}
+	return (k);
+}
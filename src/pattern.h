@@ -0,0 +1,41 @@
+#ifndef PATTERN_H
+# define PATTERN_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+
+/* Items (a byte, `?` or a [...] class) a pattern may have to be run
+ * as bit masks: one bit per item, plus one for the start */
+# define PATTERN_BITS_MAX	63
+
+/* One component of a glob pattern (no `/` in it), compiled once
+ * into a bit-parallel automaton. State i means "the first i items
+ * matched", a state is a bit of a uint64_t and a name is matched
+ * with one shift, one and, one or per byte, whatever the number of
+ * stars:
+ *     d = ((d << 1) & accept[c]) | (d & loop)
+ * accept - for every byte, the states it leads to: bit i + 1 when
+ *			item i accepts the byte;
+ * loop	  - the states a `*` keeps, bit i for a `*` before item i;
+ * final  - the state of a complete match, 0 when the pattern has
+ *			more than PATTERN_BITS_MAX items: `text` is then
+ *			matched with fnmatch(3);
+ * dot	  - the pattern starts with a literal `.`, only then does it
+ *			match names starting with one;
+ * text	  - the component as written, NUL-terminated. */
+typedef struct s_pattern
+{
+	uint64_t	accept[256];
+	uint64_t	loop;
+	uint64_t	final;
+	bool		dot;
+	const char	*text;
+}	t_pattern;
+
+bool	pattern_is_literal(const char *p, size_t n);
+void	pattern_compile(t_pattern *pt, const char *text, size_t n);
+bool	pattern_match(const t_pattern *pt, const char *name);
+size_t	pattern_unescape(char *dst, const char *p, size_t n);
+
+#endif
@@ -0,0 +1,127 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pipesz.h"
+
+/* Commands that move data as fast as the pipe lets them, sorted
+ * for bsearch(). With `auto` their pipes get the largest buffer,
+ * fewer and larger writes mean fewer context switches */
+static const char *const	g_bulk[] = {
+	"base64", "brotli", "bunzip2", "bzcat", "bzip2", "cat", "cpio",
+	"dd", "gunzip", "gzip", "lz4", "lz4cat", "lzop", "mbuffer",
+	"md5sum", "openssl", "pigz", "pv", "sha1sum", "sha256sum",
+	"sha512sum", "socat", "tar", "tee", "unpigz", "unxz", "unzstd",
+	"xz", "xzcat", "zcat", "zstd", "zstdcat", "zstdmt"
+};
+
+static int	pipesz_bytes(const char *s, t_pipesz *ps)
+{
+	char	*end;
+	long	n;
+	long	unit;
+
+	if (*s < '0' || *s > '9')
+		return (0);
+	n = strtol(s, &end, 10);
+	unit = 1;
+	if (*end == 'k' || *end == 'K')
+		unit = 1024;
+	else if (*end == 'm' || *end == 'M')
+		unit = 1024 * 1024;
+	if (unit > 1)
+		++end;
+	if (*end || n <= 0 || n > LONG_MAX / unit)
+		return (0);
+	ps->mode = PIPESZ_FIXED;
+	ps->size = n * unit;
+	return (1);
+}
+
+/* SIZE is a number of bytes with an optional k or m suffix, or one
+ * of `default`, `auto` and `max`. `ps` is left alone when SIZE is
+ * invalid */
+int	pipesz_parse(const char *s, t_pipesz *ps)
+{
+	if (!strcmp(s, "default"))
+		ps->mode = PIPESZ_DEFAULT;
+	else if (!strcmp(s, "auto"))
+		ps->mode = PIPESZ_AUTO;
+	else if (!strcmp(s, "max"))
+		ps->mode = PIPESZ_FIXED;
+	else
+		return (pipesz_bytes(s, ps));
+	ps->size = LONG_MAX;
+	return (1);
+}
+
+/* Read once: the limit only changes when root writes to it */
+static long	pipesz_max(void)
+{
+	static long	max;
+	char		buf[32];
+	ssize_t		n;
+	int			fd;
+
+	if (max)
+		return (max);
+	max = PIPESZ_MAX_DEF;
+	fd = open(PIPESZ_MAX_FILE, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (max);
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n > 0)
+	{
+		buf[n] = '\0';
+		if (atol(buf) > 0)
+			max = atol(buf);
+	}
+	return (max);
+}
+
+static int	bulk_cmp(const void *key, const void *elem)
+{
+	return (strcmp(key, *(const char *const *)elem));
+}
+
+static bool	pipesz_bulk(const t_ast *node)
+{
+	const char	*name;
+
+	if (node->type != NODE_CMD || !node->args[0])
+		return (false);
+	name = strrchr(node->args[0], '/');
+	if (name)
+		++name;
+	else
+		name = node->args[0];
+	return (bsearch(name, g_bulk, sizeof(g_bulk) / sizeof(*g_bulk),
+			sizeof(*g_bulk), bulk_cmp) != NULL);
+}
+
+/* Buffer size for the pipe from `writer` to `reader`, 0 to leave
+ * the pipe as it is */
+long	pipesz_for(const t_pipesz *ps, const t_ast *writer,
+	const t_ast *reader)
+{
+	if (ps->mode == PIPESZ_FIXED && ps->size < pipesz_max())
+		return (ps->size);
+	if (ps->mode == PIPESZ_FIXED
+		|| (ps->mode == PIPESZ_AUTO
+			&& (pipesz_bulk(writer) || pipesz_bulk(reader))))
+		return (pipesz_max());
+	return (0);
+}
+
+/* The kernel rounds the size up to a power of two pages. A refusal
+ * (EPERM once the user has too many large pipes) only leaves the
+ * pipe at its default size, so it is not reported */
+void	pipesz_apply(int fd, long size)
+{
+	if (size > 0 && size <= INT_MAX)
+		fcntl(fd, F_SETPIPE_SZ, (int)size);
+}
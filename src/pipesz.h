@@ -0,0 +1,41 @@
+#ifndef PIPESZ_H
+# define PIPESZ_H
+
+# include <stdbool.h>
+
+# include "ast.h"
+
+/* Shell variable that overrides --pipe-size for the pipelines
+ * started while it is set: ( export PIPESIZE=1m && a | b ) */
+# define PIPESZ_VAR			"PIPESIZE"
+
+/* Largest buffer an unprivileged process may ask for, and what is
+ * assumed when it cannot be read (the kernel default) */
+# define PIPESZ_MAX_FILE	"/proc/sys/fs/pipe-max-size"
+# define PIPESZ_MAX_DEF		1048576
+
+typedef enum e_pipesz_mode
+{
+	PIPESZ_DEFAULT,
+	PIPESZ_FIXED,
+	PIPESZ_AUTO
+}	t_pipesz_mode;
+
+/* How big the pipes of a pipeline are made.
+ * PIPESZ_DEFAULT	- as the kernel creates them (64 KiB);
+ * PIPESZ_FIXED		- `size` bytes, at most the system maximum;
+ * PIPESZ_AUTO		- the maximum for a pipe next to a command known
+ *					  to stream a lot of data (zstd, tar, dd...),
+ *					  the default for the others. */
+typedef struct s_pipesz
+{
+	t_pipesz_mode	mode;
+	long			size;
+}	t_pipesz;
+
+int		pipesz_parse(const char *s, t_pipesz *ps);
+long	pipesz_for(const t_pipesz *ps, const t_ast *writer,
+			const t_ast *reader);
+void	pipesz_apply(int fd, long size);
+
+#endif
@@ -7,14 +7,18 @@ int	main(void)
 	"\tminishell [GNU long option] [option] script-file ...\n"
 	"GNU long options:\n"
 	"\t--bash-compliant\n"
+	"\t--glob-threads=N\n"
 	"\t--help\n"
 	"\t--init-file\n"
 	"\t--login\n"
 	"\t--noprofile\n"
 	"\t--norc\n"
+	"\t--pipe-size=SIZE\n"
+	"\t--profile=FILE\n"
 	"\t--rcfile\n"
 	"\t--verbose\n"
 	"\t--version\n"
+	"\t--xtrace=FILE\n"
 	"Shell options:\n"
 	"\t-clv\n");
 	return 0;
@@ -0,0 +1,157 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "prof.h"
+
+void	prof_init(t_prof *p)
+{
+	p->fd = -1;
+	p->pid = getpid();
+	p->buf = NULL;
+	p->len = 0;
+	p->n = 0;
+}
+
+static void	prof_flush(t_prof *p)
+{
+	ssize_t	n;
+	size_t	off;
+
+	off = 0;
+	while (off < p->len)
+	{
+		n = write(p->fd, p->buf + off, p->len - off);
+		if (n <= 0)
+			break ;
+		off += n;
+	}
+	p->len = 0;
+}
+
+/* Appends one event, `fmt` being its JSON object. The file is a
+ * JSON array, which the trace viewers also accept without its
+ * closing bracket (a shell that was killed) */
+static void	prof_event(t_prof *p, const char *fmt, ...)
+{
+	va_list	ap;
+	int		n;
+
+	if (p->len + PROF_EVENT_MAX > PROF_BUF_SIZE)
+		prof_flush(p);
+	if (p->n++)
+		p->buf[p->len++] = ',';
+	p->buf[p->len++] = '\n';
+	va_start(ap, fmt);
+	n = vsnprintf(p->buf + p->len, PROF_EVENT_MAX - 2, fmt, ap);
+	va_end(ap);
+	if (n > 0 && n < PROF_EVENT_MAX - 2)
+		p->len += n;
+}
+
+/* Starts writing the trace to `path`. Returns 0 after printing a
+ * message on failure, profiling stays off then */
+int	prof_open(t_prof *p, const char *path)
+{
+	prof_init(p);
+	p->buf = malloc(PROF_BUF_SIZE);
+	if (p->buf)
+		p->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (p->fd == -1)
+	{
+		fprintf(stderr, "minishell: --profile: %s: %s\n", path,
+			strerror(errno));
+		free(p->buf);
+		p->buf = NULL;
+		return (0);
+	}
+	p->buf[p->len++] = '[';
+	prof_proc(p, p->pid, "minishell");
+	return (1);
+}
+
+void	prof_close(t_prof *p)
+{
+	if (p->fd == -1)
+		return ;
+	prof_flush(p);
+	memcpy(p->buf, "\n]\n", 3);
+	p->len = 3;
+	prof_flush(p);
+	close(p->fd);
+	prof_drop(p);
+}
+
+/* In a forked child: the events buffered by the parent are the
+ * parent's to write */
+void	prof_drop(t_prof *p)
+{
+	if (p->fd != -1)
+		close(p->fd);
+	free(p->buf);
+	prof_init(p);
+}
+
+/* Microseconds since boot, 0 when profiling is off */
+int64_t	prof_now(const t_prof *p)
+{
+	struct timespec	ts;
+
+	if (p->fd == -1)
+		return (0);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * (int64_t)1000000 + ts.tv_nsec / 1000);
+}
+
+/* A span of the shell itself, from `start` until now */
+void	prof_span(t_prof *p, const char *name, int64_t start)
+{
+	if (p->fd == -1)
+		return ;
+	prof_event(p, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,"
+		"\"pid\":%d,\"tid\":%d}", name, (long long)start,
+		(long long)(prof_now(p) - start), p->pid, p->pid);
+}
+
+/* Names the process `pid` of the trace. Quotes, backslashes and
+ * control characters of `name` are left out */
+void	prof_proc(t_prof *p, pid_t pid, const char *name)
+{
+	char	clean[PROF_EVENT_MAX / 2];
+	size_t	i;
+
+	if (p->fd == -1)
+		return ;
+	i = 0;
+	while (*name && i + 1 < sizeof(clean))
+	{
+		if (*name != '"' && *name != '\\' && (unsigned char)*name >= 0x20)
+			clean[i++] = *name;
+		++name;
+	}
+	clean[i] = '\0';
+	prof_event(p, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"tid\":%d,\"args\":{\"name\":\"%s\"}}", pid, pid, clean);
+}
+
+/* The whole life of a child, once it has been reaped */
+void	prof_run(t_prof *p, const t_jproc *proc)
+{
+	const struct rusage	*ru;
+
+	if (p->fd == -1)
+		return ;
+	ru = &proc->ru;
+	prof_event(p, "{\"name\":\"run\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,"
+		"\"pid\":%d,\"tid\":%d,\"args\":{\"status\":%d,\"user_us\":%lld,"
+		"\"sys_us\":%lld,\"maxrss_kb\":%ld}}", (long long)proc->start,
+		(long long)(prof_now(p) - proc->start), proc->pid, proc->pid,
+		proc->status, ru->ru_utime.tv_sec * 1000000LL + ru->ru_utime.tv_usec,
+		ru->ru_stime.tv_sec * 1000000LL + ru->ru_stime.tv_usec,
+		ru->ru_maxrss);
+}
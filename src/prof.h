@@ -0,0 +1,44 @@
+#ifndef PROF_H
+# define PROF_H
+
+# include <stddef.h>
+# include <stdint.h>
+# include <sys/types.h>
+
+# include "jobs.h"
+
+/* Events are written out once this many bytes are buffered */
+# define PROF_BUF_SIZE	65536
+/* Longest event, command names are cut to fit */
+# define PROF_EVENT_MAX	512
+
+/* --profile=FILE: what the shell spends its time on, as Chrome
+ * trace events (chrome://tracing, Perfetto). The spans of the
+ * shell (readline, lex, parse, redir, spawn, builtin, reap) are on
+ * the track of its pid. Every child it starts is a process of the
+ * trace, named after the command, with one "run" span from its
+ * start until it was reaped and its rusage as arguments. Forked
+ * children do not profile: they drop the buffer they inherit.
+ * fd	- the trace file, -1 when profiling is off;
+ * pid	- the shell's pid;
+ * buf	- `len` bytes not written yet;
+ * n	- events so far. */
+typedef struct s_prof
+{
+	int		fd;
+	pid_t	pid;
+	char	*buf;
+	size_t	len;
+	size_t	n;
+}	t_prof;
+
+void	prof_init(t_prof *p);
+int		prof_open(t_prof *p, const char *path);
+void	prof_close(t_prof *p);
+void	prof_drop(t_prof *p);
+int64_t	prof_now(const t_prof *p);
+void	prof_span(t_prof *p, const char *name, int64_t start);
+void	prof_proc(t_prof *p, pid_t pid, const char *name);
+void	prof_run(t_prof *p, const t_jproc *proc);
+
+#endif
@@ -0,0 +1,116 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "heredoc.h"
+#include "redir.h"
+
+/* A here-document gets its own descriptor of the body read
+ * before the prompt started, see heredoc_read_tty() */
+static int	redir_open_one(t_vector *docs, t_redi_node *redi)
+{
+	int	fd;
+
+	if (redi->type == T_REDIR_IN)
+		return (open(redi->filename, O_RDONLY | O_CLOEXEC));
+	if (redi->type == T_REDIR_OUT)
+		return (open(redi->filename,
+				O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+	if (redi->type == T_APPEND)
+		return (open(redi->filename,
+				O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644));
+	fd = heredoc_fd(docs, redi->filename);
+	if (fd == -1)
+	{
+		errno = EBADF;
+		return (-1);
+	}
+	return (fcntl(fd, F_DUPFD_CLOEXEC, 0));
+}
+
+/* Opens the redirections left to right in the shell itself, so
+ * errors name the right file and nothing has been started yet
+ * when one fails. A later redirection of the same direction
+ * replaces the earlier one (the file is still created) */
+int	redir_open(t_vector *docs, t_redi_node *redi, t_redir_fds *fds)
+{
+	int	fd;
+	int	*slot;
+
+	fds->in = -1;
+	fds->out = -1;
+	while (redi)
+	{
+		fd = redir_open_one(docs, redi);
+		if (fd == -1)
+		{
+			fprintf(stderr, "minishell: %s: %s\n", redi->filename,
+				strerror(errno));
+			redir_close(fds);
+			return (0);
+		}
+		slot = &fds->out;
+		if (redi->type == T_REDIR_IN || redi->type == T_HEREDOC)
+			slot = &fds->in;
+		if (*slot != -1)
+			close(*slot);
+		*slot = fd;
+		redi = redi->next;
+	}
+	return (1);
+}
+
+void	redir_close(t_redir_fds *fds)
+{
+	if (fds->in != -1)
+		close(fds->in);
+	if (fds->out != -1)
+		close(fds->out);
+	fds->in = -1;
+	fds->out = -1;
+}
+
+/* Makes `fd` the shell's descriptor `target`, saving the old one
+ * in *saved. Nothing is done when `fd` is -1 */
+static int	redir_apply_one(int fd, int target, int *saved)
+{
+	*saved = -1;
+	if (fd == -1)
+		return (1);
+	*saved = fcntl(target, F_DUPFD_CLOEXEC, REDIR_SAVE_FD_MIN);
+	if (*saved == -1 || dup2(fd, target) == -1)
+	{
+		perror("minishell");
+		if (*saved != -1)
+			close(*saved);
+		*saved = -1;
+		return (0);
+	}
+	return (1);
+}
+
+/* Puts `in` and `out` (-1: unchanged) on the shell's own stdin and
+ * stdout, for a builtin that runs without a child process. The
+ * previous descriptors are kept in `saved` for redir_restore() */
+int	redir_apply(int in, int out, t_redir_fds *saved)
+{
+	saved->out = -1;
+	if (!redir_apply_one(in, STDIN_FILENO, &saved->in)
+		|| !redir_apply_one(out, STDOUT_FILENO, &saved->out))
+	{
+		redir_restore(saved);
+		return (0);
+	}
+	return (1);
+}
+
+void	redir_restore(t_redir_fds *saved)
+{
+	if (saved->in != -1)
+		dup2(saved->in, STDIN_FILENO);
+	if (saved->out != -1)
+		dup2(saved->out, STDOUT_FILENO);
+	redir_close(saved);
+}
@@ -0,0 +1,25 @@
+#ifndef REDIR_H
+# define REDIR_H
+
+# include "ast.h"
+# include "vector.h"
+
+/* Descriptors opened for the redirections of one command.
+ * in	- last `<` file or `<<` body, -1 if none;
+ * out	- last `>`/`>>` file, -1 if none. */
+typedef struct s_redir_fds
+{
+	int	in;
+	int	out;
+}	t_redir_fds;
+
+/* The shell's own stdin/stdout are saved at or above this
+ * descriptor while a builtin runs with redirections */
+# define REDIR_SAVE_FD_MIN	10
+
+int		redir_open(t_vector *docs, t_redi_node *redi, t_redir_fds *fds);
+void	redir_close(t_redir_fds *fds);
+int		redir_apply(int in, int out, t_redir_fds *saved);
+void	redir_restore(t_redir_fds *saved);
+
+#endif
@@ -3,6 +3,12 @@
 
 # define MINISHELL_VERSION	"1.0-release"
 
+/* Exit status of an invalid command line (as in bash) */
+# define EXIT_USAGE			2
+
+/* Input prompt displayed by the interactive shell */
+# define DEF_PS1			"minishell$ "
+
 /* The default path is used when
  * it isn't inherited from the
  * parent or found in any configs */
@@ -38,6 +44,9 @@
 # define DEF_MINISHL_ETC_LOGOUT_PATH	"/etc/minishell.minishell_logout"
 # define DEF_MINISHL_HOME_HIST_PATH		"~/.minishell_history"
 
+/* Compiled startup files are cached here, see config.h */
+# define DEF_MINISHL_CACHE_DIR			"~/.cache/minishell"
+
 /* NON-LOGIN SHELL */
 /* Original bash default configs paths */
 /* `/etc/bash.bashrc`	- also called system-wide initialization file;
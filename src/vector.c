@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "vector.h"
+
+void	vec_init(t_vector *v, size_t elem_size)
+{
+	v->elem_size = elem_size;
+	v->len = 0;
+	v->cap = VEC_INLINE_SIZE / elem_size;
+	v->heap = NULL;
+}
+
+void	*vec_data(t_vector *v)
+{
+	if (v->heap)
+		return (v->heap);
+	return (v->inl.buf);
+}
+
+void	*vec_at(t_vector *v, size_t i)
+{
+	return ((unsigned char *)vec_data(v) + i * v->elem_size);
+}
+
+/* Makes room for at least `cap` elements. The capacity is at
+ * least doubled, so pushing n elements costs O(n) in total */
+int	vec_reserve(t_vector *v, size_t cap)
+{
+	unsigned char	*heap;
+	size_t			new_cap;
+
+	if (cap <= v->cap)
+		return (1);
+	new_cap = v->cap * 2;
+	if (new_cap < cap)
+		new_cap = cap;
+	heap = realloc(v->heap, new_cap * v->elem_size);
+	if (!heap)
+		return (0);
+	if (!v->heap)
+		memcpy(heap, v->inl.buf, v->len * v->elem_size);
+	v->heap = heap;
+	v->cap = new_cap;
+	return (1);
+}
+
+/* Appends an uninitialized element and returns it,
+ * or returns NULL if the vector could not grow */
+void	*vec_emplace(t_vector *v)
+{
+	if (v->len == v->cap && !vec_reserve(v, v->len + 1))
+		return (NULL);
+	++v->len;
+	return (vec_at(v, v->len - 1));
+}
+
+void	*vec_push(t_vector *v, const void *elem)
+{
+	void	*slot;
+
+	slot = vec_emplace(v);
+	if (!slot)
+		return (NULL);
+	memcpy(slot, elem, v->elem_size);
+	return (slot);
+}
+
+void	vec_pop(t_vector *v)
+{
+	if (v->len > 0)
+		--v->len;
+}
+
+/* Forgets all elements in O(1). The memory is kept,
+ * so refilling the vector does not allocate again */
+void	vec_clear(t_vector *v)
+{
+	v->len = 0;
+}
+
+void	vec_free(t_vector *v)
+{
+	free(v->heap);
+	vec_init(v, v->elem_size);
+}
@@ -0,0 +1,47 @@
+#ifndef VECTOR_H
+# define VECTOR_H
+
+# include <stddef.h>
+
+/* Number of bytes stored inside the vector itself. Until the
+ * elements outgrow it the vector never touches the heap */
+# define VEC_INLINE_SIZE	256
+
+/* Growable array of `elem_size`-byte elements.
+ * len	 - number of elements in use;
+ * cap	 - number of elements that fit without growing;
+ * heap	 - NULL while the elements live in `inl`.
+ *
+ * Elements are reached through vec_data()/vec_at() (or the
+ * typed VEC_AT() macro), never through a cached pointer:
+ * pushing may move them to the heap. Because `heap` is NULL
+ * until then, a vector that still uses its inline storage can
+ * be copied by value like any other struct. */
+typedef struct s_vector
+{
+	size_t			elem_size;
+	size_t			len;
+	size_t			cap;
+	unsigned char	*heap;
+	union
+	{
+		max_align_t		align;
+		unsigned char	buf[VEC_INLINE_SIZE];
+	}				inl;
+}	t_vector;
+
+/* Typed element access: VEC_AT(&d->ops, t_operand, i).name */
+# define VEC_AT(v, type, i)	(((type *)vec_data(v))[i])
+# define VEC_LAST(v, type)	VEC_AT(v, type, (v)->len - 1)
+
+void	vec_init(t_vector *v, size_t elem_size);
+void	*vec_data(t_vector *v);
+void	*vec_at(t_vector *v, size_t i);
+int		vec_reserve(t_vector *v, size_t cap);
+void	*vec_emplace(t_vector *v);
+void	*vec_push(t_vector *v, const void *elem);
+void	vec_pop(t_vector *v);
+void	vec_clear(t_vector *v);
+void	vec_free(t_vector *v);
+
+#endif
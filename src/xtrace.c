@@ -0,0 +1,184 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "xtrace.h"
+
+void	xtrace_init(t_xtrace *x)
+{
+	x->fd = -1;
+	x->ring = NULL;
+	atomic_init(&x->head, 0);
+	atomic_init(&x->tail, 0);
+	atomic_init(&x->idle, 0);
+	atomic_init(&x->stop, false);
+	x->threaded = false;
+	x->lost = 0;
+	x->seen = NULL;
+	x->seen_cap = 0;
+	x->seen_cnt = 0;
+}
+
+static int	xt_write_all(int fd, const void *buf, size_t len)
+{
+	ssize_t	n;
+
+	while (len)
+	{
+		n = write(fd, buf, len);
+		if (n == -1 && errno == EINTR)
+			continue ;
+		if (n <= 0)
+			return (0);
+		buf = (const char *)buf + n;
+		len -= n;
+	}
+	return (1);
+}
+
+/* Writes what the ring holds up to its end (the rest is written
+ * by the next call). Returns the number of bytes written. Only
+ * one thread drains: the writer, or the shell when there is none */
+size_t	xtrace_drain(t_xtrace *x)
+{
+	uint64_t	head;
+	uint64_t	tail;
+	size_t		off;
+	size_t		n;
+
+	head = atomic_load_explicit(&x->head, memory_order_acquire);
+	tail = atomic_load_explicit(&x->tail, memory_order_relaxed);
+	if (head == tail)
+		return (0);
+	off = tail & (XT_RING_SIZE - 1);
+	n = head - tail;
+	if (n > XT_RING_SIZE - off)
+		n = XT_RING_SIZE - off;
+	xt_write_all(x->fd, x->ring + off, n);
+	atomic_store_explicit(&x->tail, tail + n, memory_order_release);
+	return (n);
+}
+
+/* Wakes the writer if it sleeps. `idle` is cleared first: a
+ * writer about to sleep then does not */
+void	xtrace_wake(t_xtrace *x)
+{
+	if (atomic_exchange(&x->idle, 0))
+		syscall(SYS_futex, &x->idle, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/* Sleeps `ns` at most, less if the shell calls xtrace_wake() */
+static void	xt_sleep(t_xtrace *x, long ns)
+{
+	struct timespec	ts;
+
+	ts.tv_sec = ns / 1000000000L;
+	ts.tv_nsec = ns % 1000000000L;
+	atomic_store(&x->idle, 1);
+	if (atomic_load(&x->head) == atomic_load(&x->tail)
+		&& !atomic_load(&x->stop))
+		syscall(SYS_futex, &x->idle, FUTEX_WAIT_PRIVATE, 1, &ts, NULL, 0);
+	atomic_store(&x->idle, 0);
+}
+
+/* Sleeps while the ring is empty, longer and longer while the
+ * shell is idle, leaves once asked to and everything has been
+ * written */
+static void	*xt_writer(void *arg)
+{
+	t_xtrace	*x;
+	long		ns;
+	bool		stop;
+
+	x = arg;
+	ns = XT_POLL_NS;
+	while (1)
+	{
+		stop = atomic_load_explicit(&x->stop, memory_order_acquire);
+		if (xtrace_drain(x))
+		{
+			ns = XT_POLL_NS;
+			continue ;
+		}
+		if (stop)
+			break ;
+		xt_sleep(x, ns);
+		if (ns < XT_POLL_MAX_NS / 2)
+			ns *= 2;
+		else
+			ns = XT_POLL_MAX_NS;
+	}
+	return (NULL);
+}
+
+static int	xt_header(t_xtrace *x)
+{
+	struct timespec	ts;
+	t_xt_file		hdr;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = XT_MAGIC;
+	hdr.version = XT_VERSION;
+	hdr.pid = getpid();
+	hdr.rec_align = XT_REC_ALIGN;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	hdr.mono_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	hdr.real_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	return (xt_write_all(x->fd, &hdr, sizeof(hdr)));
+}
+
+/* Starts tracing to `path`. Returns 0 after printing a message on
+ * failure, tracing stays off then. Without a writer thread the
+ * trace still works, drained by the shell itself */
+int	xtrace_open(t_xtrace *x, const char *path)
+{
+	xtrace_init(x);
+	x->ring = malloc(XT_RING_SIZE);
+	if (x->ring)
+		x->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (x->fd == -1 || !xt_header(x))
+	{
+		fprintf(stderr, "minishell: --xtrace: %s: %s\n", path,
+			strerror(errno));
+		xtrace_drop(x);
+		return (0);
+	}
+	x->threaded = !pthread_create(&x->writer, NULL, xt_writer, x);
+	return (1);
+}
+
+/* Writes out every record left and stops tracing */
+void	xtrace_close(t_xtrace *x)
+{
+	if (x->fd == -1)
+		return ;
+	if (x->threaded)
+	{
+		atomic_store(&x->stop, true);
+		xtrace_wake(x);
+		pthread_join(x->writer, NULL);
+		x->threaded = false;
+	}
+	xtrace_lost(x);
+	while (xtrace_drain(x))
+		;
+	xtrace_drop(x);
+}
+
+/* In a forked child, which has no writer thread: the records in
+ * the ring are the parent's to write */
+void	xtrace_drop(t_xtrace *x)
+{
+	if (x->fd != -1)
+		close(x->fd);
+	free(x->ring);
+	free(x->seen);
+	xtrace_init(x);
+}
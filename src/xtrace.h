@@ -0,0 +1,112 @@
+#ifndef XTRACE_H
+# define XTRACE_H
+
+# include <pthread.h>
+# include <stdatomic.h>
+# include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <sys/types.h>
+
+# define XT_MAGIC		0x5458534dU
+# define XT_VERSION		1
+/* Bytes of the ring, a power of 2 */
+# define XT_RING_SIZE	(1U << 20)
+/* Records start and end on this boundary */
+# define XT_REC_ALIGN	32
+/* Longest command text, longer ones are cut */
+# define XT_TEXT_MAX	448
+/* How long the writer sleeps when the ring is empty: XT_POLL_NS
+ * at first, twice as long each time it is still empty, up to
+ * XT_POLL_MAX_NS. The shell wakes it early once XT_WAKE_BYTES
+ * are waiting */
+# define XT_POLL_NS		1000000
+# define XT_POLL_MAX_NS	1000000000
+# define XT_WAKE_BYTES	(XT_RING_SIZE / 4)
+
+/* XT_PAD		- skip `len` more bytes (the end of the ring);
+ * XT_TEXT		- `len` bytes of text: the command whose argv hashes
+ *				  to `hash`, sent once per distinct command;
+ * XT_SPAWN		- the command `hash` was started as `pid`;
+ * XT_BUILTIN	- the builtin `hash` ran in the shell, `status`;
+ * XT_EXIT		- `pid` exited with `status`;
+ * XT_LOST		- `status` records were dropped, the ring was full. */
+typedef enum e_xt_type
+{
+	XT_PAD,
+	XT_TEXT,
+	XT_SPAWN,
+	XT_BUILTIN,
+	XT_EXIT,
+	XT_LOST
+}	t_xt_type;
+
+/* Start of a trace file, records follow.
+ * mono_ns, real_ns - CLOCK_MONOTONIC and CLOCK_REALTIME when the
+ *					  trace started: record times are monotonic. */
+typedef struct s_xt_file
+{
+	uint32_t	magic;
+	uint32_t	version;
+	int32_t		pid;
+	uint32_t	rec_align;
+	uint64_t	mono_ns;
+	uint64_t	real_ns;
+}	t_xt_file;
+
+/* One record, XT_REC_ALIGN bytes, followed by `len` bytes (text
+ * or padding) rounded up to XT_REC_ALIGN */
+typedef struct s_xt_rec
+{
+	uint16_t	type;
+	uint16_t	len;
+	int32_t		pid;
+	uint64_t	ts_ns;
+	uint64_t	hash;
+	int32_t		status;
+	uint32_t	unused;
+}	t_xt_rec;
+
+/* --xtrace=FILE: every command the shell runs, as binary records
+ * in a single-producer single-consumer ring. The shell only copies
+ * a record in and moves `head`; a writer thread moves the bytes to
+ * the file and `tail` along. Nothing blocks the shell: when the
+ * ring is full records are dropped and counted. Without the thread
+ * the ring is written out by the shell when it fills and on exit.
+ * fd		- the trace file, -1 when tracing is off;
+ * head		- bytes ever put in the ring (shell only);
+ * tail		- bytes ever written to the file (writer only);
+ * idle		- 1 while the writer sleeps, a futex to wake it;
+ * lost		- records dropped since the last XT_LOST;
+ * seen		- hashes whose text was sent, open addressing, 0 for
+ *			  an empty slot, `seen_cap` a power of 2. */
+typedef struct s_xtrace
+{
+	int					fd;
+	unsigned char		*ring;
+	_Atomic uint64_t	head;
+	_Atomic uint64_t	tail;
+	_Atomic uint32_t	idle;
+	atomic_bool			stop;
+	bool				threaded;
+	pthread_t			writer;
+	uint64_t			lost;
+	uint64_t			*seen;
+	size_t				seen_cap;
+	size_t				seen_cnt;
+}	t_xtrace;
+
+void	xtrace_init(t_xtrace *x);
+int		xtrace_open(t_xtrace *x, const char *path);
+void	xtrace_close(t_xtrace *x);
+void	xtrace_drop(t_xtrace *x);
+size_t	xtrace_drain(t_xtrace *x);
+void	xtrace_wake(t_xtrace *x);
+
+/* xtrace_rec.c */
+void	xtrace_spawn(t_xtrace *x, pid_t pid, char **argv);
+void	xtrace_builtin(t_xtrace *x, char **argv, int status);
+void	xtrace_exit(t_xtrace *x, pid_t pid, int status);
+void	xtrace_lost(t_xtrace *x);
+
+#endif
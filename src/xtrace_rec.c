@@ -0,0 +1,250 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "xtrace.h"
+
+#define XT_FNV_OFFSET	0xcbf29ce484222325ULL
+#define XT_FNV_PRIME	0x100000001b3ULL
+
+/* FNV-1a of the arguments, each followed by a 0 so that "a b" and
+ * "ab" differ. Never 0, the empty slot of `seen` */
+static uint64_t	xt_hash(char **argv)
+{
+	uint64_t	h;
+	size_t		i;
+
+	h = XT_FNV_OFFSET;
+	while (argv && *argv)
+	{
+		i = 0;
+		while (1)
+		{
+			h = (h ^ (unsigned char)(*argv)[i]) * XT_FNV_PRIME;
+			if (!(*argv)[i++])
+				break ;
+		}
+		++argv;
+	}
+	if (!h)
+		h = 1;
+	return (h);
+}
+
+static void	xt_seen_grow(t_xtrace *x)
+{
+	uint64_t	*old;
+	size_t		old_cap;
+	size_t		i;
+	size_t		j;
+
+	old = x->seen;
+	old_cap = x->seen_cap;
+	x->seen_cap = 64;
+	if (old_cap)
+		x->seen_cap = old_cap * 2;
+	x->seen = calloc(x->seen_cap, sizeof(*x->seen));
+	if (!x->seen)
+	{
+		x->seen = old;
+		x->seen_cap = old_cap;
+		return ;
+	}
+	i = 0;
+	while (i < old_cap)
+	{
+		j = old[i] & (x->seen_cap - 1);
+		while (old[i] && x->seen[j])
+			j = (j + 1) & (x->seen_cap - 1);
+		x->seen[j] = old[i++];
+	}
+	free(old);
+}
+
+/* The slot of `hash` in `seen`: holding it when its text was sent
+ * already, empty otherwise. NULL when out of memory, every record
+ * carries its text again then */
+static uint64_t	*xt_seen(t_xtrace *x, uint64_t hash)
+{
+	size_t	i;
+
+	if ((x->seen_cnt + 1) * 4 > x->seen_cap * 3)
+		xt_seen_grow(x);
+	if ((x->seen_cnt + 1) * 4 > x->seen_cap * 3)
+		return (NULL);
+	i = hash & (x->seen_cap - 1);
+	while (x->seen[i] && x->seen[i] != hash)
+		i = (i + 1) & (x->seen_cap - 1);
+	return (x->seen + i);
+}
+
+/* Room for `size` bytes at `head`, after a XT_PAD to the end of the
+ * ring when they do not fit before it. NULL when the ring is full
+ * and the writer is behind: the shell does not wait for it */
+static unsigned char	*xt_reserve(t_xtrace *x, size_t size, uint64_t *head)
+{
+	t_xt_rec	*pad;
+	uint64_t	tail;
+	size_t		end;
+
+	*head = atomic_load_explicit(&x->head, memory_order_relaxed);
+	tail = atomic_load_explicit(&x->tail, memory_order_acquire);
+	end = XT_RING_SIZE - (*head & (XT_RING_SIZE - 1));
+	if (end >= size)
+		end = 0;
+	if (XT_RING_SIZE - (*head - tail) < end + size && !x->threaded)
+	{
+		while (xtrace_drain(x))
+			;
+		tail = atomic_load_explicit(&x->tail, memory_order_relaxed);
+	}
+	if (XT_RING_SIZE - (*head - tail) < end + size)
+		return (NULL);
+	if (end)
+	{
+		pad = (t_xt_rec *)(x->ring + (*head & (XT_RING_SIZE - 1)));
+		memset(pad, 0, sizeof(*pad));
+		pad->type = XT_PAD;
+		pad->len = end - sizeof(*pad);
+		*head += end;
+	}
+	return (x->ring + (*head & (XT_RING_SIZE - 1)));
+}
+
+/* Copies `rec` and `rec->len` bytes of `text` into the ring.
+ * Returns 0 when they do not fit, one more lost record. The first
+ * record that fits after a loss is preceded by a XT_LOST */
+static int	xt_put(t_xtrace *x, const t_xt_rec *rec, const char *text)
+{
+	unsigned char	*dst;
+	uint64_t		head;
+	size_t			size;
+	t_xt_rec		lost;
+
+	if (x->lost)
+	{
+		memset(&lost, 0, sizeof(lost));
+		lost.type = XT_LOST;
+		lost.ts_ns = rec->ts_ns;
+		lost.status = x->lost;
+		x->lost = 0;
+		if (!xt_put(x, &lost, NULL))
+			x->lost = lost.status;
+	}
+	size = (sizeof(*rec) + rec->len + XT_REC_ALIGN - 1)
+		& ~(size_t)(XT_REC_ALIGN - 1);
+	dst = NULL;
+	if (!x->lost)
+		dst = xt_reserve(x, size, &head);
+	if (!dst)
+	{
+		++x->lost;
+		return (0);
+	}
+	memcpy(dst, rec, sizeof(*rec));
+	if (rec->len)
+		memcpy(dst + sizeof(*rec), text, rec->len);
+	atomic_store(&x->head, head + size);
+	if (x->threaded && head + size - atomic_load(&x->tail) >= XT_WAKE_BYTES)
+		xtrace_wake(x);
+	return (1);
+}
+
+/* A record of `type` about `pid`, stamped now */
+static void	xt_rec(t_xt_rec *rec, t_xt_type type, pid_t pid)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	memset(rec, 0, sizeof(*rec));
+	rec->type = type;
+	rec->pid = pid;
+	rec->ts_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* `rec` about the command `argv`, its text first if it was not
+ * sent before */
+static void	xt_cmd(t_xtrace *x, t_xt_rec *rec, char **argv)
+{
+	t_xt_rec	text_rec;
+	char		text[XT_TEXT_MAX];
+	uint64_t	*seen;
+	size_t		len;
+	size_t		n;
+
+	rec->hash = xt_hash(argv);
+	seen = xt_seen(x, rec->hash);
+	if (!seen || !*seen)
+	{
+		len = 0;
+		while (argv && *argv && len < sizeof(text))
+		{
+			if (len)
+				text[len++] = ' ';
+			n = strnlen(*argv++, sizeof(text) - len);
+			memcpy(text + len, argv[-1], n);
+			len += n;
+		}
+		xt_rec(&text_rec, XT_TEXT, 0);
+		text_rec.len = len;
+		text_rec.hash = rec->hash;
+		if (xt_put(x, &text_rec, text) && seen)
+		{
+			*seen = rec->hash;
+			++x->seen_cnt;
+		}
+	}
+	xt_put(x, rec, NULL);
+}
+
+/* `argv` was started as `pid`, NULL for a subshell */
+void	xtrace_spawn(t_xtrace *x, pid_t pid, char **argv)
+{
+	static char	*subshell[] = {"( ... )", NULL};
+	t_xt_rec	rec;
+
+	if (x->fd == -1)
+		return ;
+	if (!argv)
+		argv = subshell;
+	xt_rec(&rec, XT_SPAWN, pid);
+	xt_cmd(x, &rec, argv);
+}
+
+void	xtrace_builtin(t_xtrace *x, char **argv, int status)
+{
+	t_xt_rec	rec;
+
+	if (x->fd == -1)
+		return ;
+	xt_rec(&rec, XT_BUILTIN, getpid());
+	rec.status = status;
+	xt_cmd(x, &rec, argv);
+}
+
+/* Records the loss the ring still owes, at the end of the trace */
+void	xtrace_lost(t_xtrace *x)
+{
+	t_xt_rec	rec;
+
+	if (x->fd == -1 || !x->lost)
+		return ;
+	xt_rec(&rec, XT_LOST, 0);
+	rec.status = x->lost;
+	x->lost = 0;
+	if (!xt_put(x, &rec, NULL))
+		x->lost = rec.status;
+}
+
+/* `pid` was reaped */
+void	xtrace_exit(t_xtrace *x, pid_t pid, int status)
+{
+	t_xt_rec	rec;
+
+	if (x->fd == -1)
+		return ;
+	xt_rec(&rec, XT_EXIT, pid);
+	rec.status = status;
+	xt_put(x, &rec, NULL);
+}
@@ -0,0 +1,204 @@
+/* minishell/tests/benchmarks/pipeline_syscalls.c
+ *
+ * Counts the system calls the shell makes to run pipelines of
+ * N stages of /bin/true, N = 1, 10, 100 and 500 by default:
+ *
+ *     ./pipeline_syscalls SHELL [N]...
+ *
+ * The shell runs `SHELL -c '/bin/true | ... | /bin/true'` under
+ * ptrace(2). Its own calls are counted, and so are the calls of
+ * every child it starts, up to the execve() of the command: the
+ * cost of setting a stage up, not of the stage itself. With
+ * close-on-exec pipes the calls per stage stay the same whatever
+ * N is; closing every pipe in every child made them grow with N.
+ * A run without pipes (N = 1) is subtracted as the startup cost.
+ *
+ * First it checks that a descriptor the shell inherited still
+ * reaches the commands it starts: close-on-exec pipes leave the
+ * other descriptors of a stage as they were */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+
+#define PROG_PATH	"/bin/true"
+#define FD_CHECK	"/bin/ls /proc/self/fd/3 && /bin/true \
+	| /bin/ls /proc/self/fd/3"
+#define TRACE_OPTS	(PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEFORK \
+	| PTRACE_O_TRACEVFORK | PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXEC \
+	| PTRACE_O_EXITKILL)
+
+static const int	g_def_stages[] = {1, 10, 100, 500};
+
+static char	*make_cmd(int stages)
+{
+	size_t	len;
+	char	*cmd;
+	int		i;
+
+	len = stages * (sizeof(PROG_PATH) + 3);
+	cmd = malloc(len);
+	if (!cmd)
+		return (NULL);
+	cmd[0] = '\0';
+	i = 0;
+	while (i < stages)
+	{
+		if (i++)
+			strcat(cmd, " | ");
+		strcat(cmd, PROG_PATH);
+	}
+	return (cmd);
+}
+
+/* Syscall entries of the tracee `pid` are counted. A child is
+ * let go once it has become the command */
+static int	on_stop(pid_t shell, pid_t pid, int ws, long *calls)
+{
+	struct __ptrace_syscall_info	info;
+	int								sig;
+	int								event;
+
+	sig = WSTOPSIG(ws);
+	event = ws >> 16;
+	if (sig == (SIGTRAP | 0x80))
+	{
+		if (ptrace(PTRACE_GET_SYSCALL_INFO, pid, sizeof(info), &info) > 0
+			&& info.op == PTRACE_SYSCALL_INFO_ENTRY)
+			++*calls;
+		sig = 0;
+	}
+	else if (event == PTRACE_EVENT_EXEC && pid != shell)
+		return (ptrace(PTRACE_DETACH, pid, 0, 0));
+	else if (event || sig == SIGTRAP || sig == SIGSTOP)
+		sig = 0;
+	return (ptrace(PTRACE_SYSCALL, pid, 0, sig));
+}
+
+static long	count(char *shell, char *cmd)
+{
+	char	*argv[4];
+	long	calls;
+	pid_t	pid;
+	pid_t	child;
+	int		ws;
+
+	argv[0] = shell;
+	argv[1] = "-c";
+	argv[2] = cmd;
+	argv[3] = NULL;
+	child = fork();
+	if (child == 0)
+	{
+		ptrace(PTRACE_TRACEME, 0, 0, 0);
+		execv(shell, argv);
+		_exit(127);
+	}
+	if (child == -1 || waitpid(child, &ws, 0) == -1
+		|| ptrace(PTRACE_SETOPTIONS, child, 0, TRACE_OPTS) == -1
+		|| ptrace(PTRACE_SYSCALL, child, 0, 0) == -1)
+		return (-1);
+	calls = 0;
+	while (1)
+	{
+		pid = waitpid(-1, &ws, __WALL);
+		if (pid == -1)
+			return (-1);
+		if ((WIFEXITED(ws) || WIFSIGNALED(ws)) && pid == child)
+			break ;
+		if (WIFSTOPPED(ws))
+			on_stop(child, pid, ws, &calls);
+	}
+	while (waitpid(-1, &ws, __WALL) > 0)
+		;
+	return (calls);
+}
+
+/* Runs FD_CHECK with fd 3 open and not close-on-exec, as a make
+ * jobserver pipe would be. Returns whether every command saw it */
+static int	fd_inherited(char *shell)
+{
+	char	*argv[4];
+	pid_t	child;
+	int		ws;
+
+	argv[0] = shell;
+	argv[1] = "-c";
+	argv[2] = FD_CHECK;
+	argv[3] = NULL;
+	child = fork();
+	if (child == 0)
+	{
+		if (dup2(open("/dev/null", O_WRONLY), 3) != 3
+			|| dup2(3, STDOUT_FILENO) == -1)
+			_exit(127);
+		execv(shell, argv);
+		_exit(127);
+	}
+	return (child != -1 && waitpid(child, &ws, 0) == child
+		&& WIFEXITED(ws) && WEXITSTATUS(ws) == 0);
+}
+
+static long	run(char *shell, int stages)
+{
+	char	*cmd;
+	long	calls;
+
+	cmd = make_cmd(stages);
+	if (!cmd)
+		return (-1);
+	calls = count(shell, cmd);
+	free(cmd);
+	return (calls);
+}
+
+int	main(int argc, char **argv)
+{
+	long	base;
+	long	calls;
+	int		stages;
+	int		n;
+	int		i;
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s SHELL [STAGES]...\n", argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (!fd_inherited(argv[1]))
+	{
+		fprintf(stderr, "%s: fd 3 did not reach the commands\n", argv[1]);
+		return (EXIT_FAILURE);
+	}
+	base = run(argv[1], 1);
+	if (base == -1)
+	{
+		perror("ptrace");
+		return (EXIT_FAILURE);
+	}
+	printf("%-8s %10s %12s\n", "stages", "syscalls", "per stage");
+	n = argc - 2;
+	if (!n)
+		n = sizeof(g_def_stages) / sizeof(*g_def_stages);
+	i = 0;
+	while (i < n)
+	{
+		stages = g_def_stages[i];
+		if (argc > 2)
+			stages = atoi(argv[i + 2]);
+		calls = run(argv[1], stages);
+		if (stages > 1)
+			printf("%-8d %10ld %12.1f\n", stages, calls,
+				(double)(calls - base) / (stages - 1));
+		else
+			printf("%-8d %10ld %12s\n", stages, calls, "-");
+		++i;
+	}
+	return (EXIT_SUCCESS);
+}
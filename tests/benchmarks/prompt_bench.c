@@ -0,0 +1,565 @@
+/* minishell/tests/benchmarks/prompt_bench.c
+ *
+ * Replays a corpus of prompts through the shell and reports, for
+ * every prompt, the latency from starting `SHELL -c PROMPT` to its
+ * exit and what the shell did meanwhile:
+ *
+ *     ./prompt_bench [-n RUNS] [-o OUT] [-b BASELINE] [-t PCT] SHELL
+ *                    [CORPUS]
+ *
+ * CORPUS is prompts.txt by default. Every prompt is run RUNS times
+ * (100 by default) after one warm-up run, p50 and p99 are taken
+ * over the runs. It is then run once more under ptrace(2) to count
+ *     forks    - processes the shell started (fork, vfork, spawn);
+ *     execs    - execve() calls that succeeded, the shell's own
+ *                one included when it runs a command in place;
+ *     syscalls - calls made by the shell and by its children up to
+ *                their execve(), as in pipeline_syscalls.c.
+ * The results are written as JSON to OUT (stdout by default). With
+ * -b they are compared with a previous OUT: a prompt whose counts
+ * grew, or whose p50 grew by more than PCT percent (10 by default),
+ * is a regression and the exit status is 1 */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+
+#define DEF_CORPUS	"prompts.txt"
+#define DEF_RUNS	100
+#define DEF_TOL_PCT	10.0
+#define LINE_MAX_LEN	4096
+#define TRACE_OPTS	(PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEFORK \
+	| PTRACE_O_TRACEVFORK | PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXEC \
+	| PTRACE_O_EXITKILL)
+
+/* One prompt of the corpus and what was measured.
+ * json - the prompt as a JSON string (quotes included), prompts
+ *		  are matched with the baseline by this text. */
+typedef struct s_result
+{
+	char	*prompt;
+	char	*json;
+	double	p50_us;
+	double	p99_us;
+	long	forks;
+	long	execs;
+	long	syscalls;
+}	t_result;
+
+typedef struct s_opts
+{
+	const char	*shell;
+	const char	*corpus;
+	const char	*out;
+	const char	*baseline;
+	int			runs;
+	double		tol_pct;
+}	t_opts;
+
+extern char	**environ;
+
+/* Corpus */
+
+static char	*str_append(char *s, const char *tail)
+{
+	size_t	len;
+	char	*res;
+
+	len = 0;
+	if (s)
+		len = strlen(s);
+	res = realloc(s, len + strlen(tail) + 1);
+	if (!res)
+	{
+		perror("prompt_bench");
+		exit(2);
+	}
+	strcpy(res + len, tail);
+	return (res);
+}
+
+/* `prompt` inside `nest` pairs of parentheses */
+static char	*corpus_nest(char *prompt, long nest)
+{
+	size_t	len;
+	char	*res;
+
+	if (nest <= 0)
+		return (prompt);
+	len = strlen(prompt);
+	res = malloc(len + 2 * nest + 1);
+	if (!res)
+	{
+		perror("prompt_bench");
+		exit(2);
+	}
+	memset(res, '(', nest);
+	memcpy(res + nest, prompt, len);
+	memset(res + nest + len, ')', nest);
+	res[len + 2 * nest] = '\0';
+	free(prompt);
+	return (res);
+}
+
+/* Adds the prompt being built to `res` once it is complete */
+static int	corpus_add(t_result **res, int *n, char *prompt)
+{
+	t_result	*grown;
+
+	grown = realloc(*res, (*n + 1) * sizeof(**res));
+	if (!grown)
+		return (0);
+	*res = grown;
+	memset(&grown[*n], 0, sizeof(**res));
+	grown[(*n)++].prompt = prompt;
+	return (1);
+}
+
+static int	corpus_read(const char *path, t_result **res)
+{
+	char	line[LINE_MAX_LEN];
+	char	*prompt;
+	size_t	len;
+	long	nest;
+	FILE	*f;
+	int		n;
+
+	f = fopen(path, "r");
+	if (!f)
+		return (-1);
+	*res = NULL;
+	n = 0;
+	nest = 0;
+	prompt = NULL;
+	while (n != -1 && fgets(line, sizeof(line), f))
+	{
+		len = strcspn(line, "\n");
+		line[len] = '\0';
+		if (!prompt && !strncmp(line, "@nest ", 6))
+			nest = strtol(line + 6, NULL, 10);
+		if (!prompt && (!len || line[0] == '#' || line[0] == '@'))
+			continue ;
+		if (len && line[len - 1] == '\\')
+			strcpy(line + len - 1, "\n");
+		prompt = str_append(prompt, line);
+		if (len && line[len - 1] == '\n')
+			continue ;
+		if (!corpus_add(res, &n, corpus_nest(prompt, nest)))
+			n = -1;
+		prompt = NULL;
+		nest = 0;
+	}
+	if (prompt && n != -1 && !corpus_add(res, &n, prompt))
+		n = -1;
+	fclose(f);
+	return (n);
+}
+
+/* The prompt as a JSON string */
+static char	*json_quote(const char *s)
+{
+	char	buf[8];
+	char	*res;
+
+	res = str_append(NULL, "\"");
+	while (*s)
+	{
+		if (*s == '"' || *s == '\\')
+			snprintf(buf, sizeof(buf), "\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			snprintf(buf, sizeof(buf), "\\u%04x", *s);
+		else
+			snprintf(buf, sizeof(buf), "%c", *s);
+		res = str_append(res, buf);
+		++s;
+	}
+	return (str_append(res, "\""));
+}
+
+/* Latency */
+
+static double	now_us(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e6 + ts.tv_nsec / 1e3);
+}
+
+/* Runs the prompt once with stdin and stdout on /dev/null, returns
+ * the time it took in microseconds, -1 on error */
+static double	run_once(const t_opts *o, const char *prompt)
+{
+	posix_spawn_file_actions_t	fa;
+	char						*argv[4];
+	double						t0;
+	pid_t						pid;
+	int							err;
+
+	argv[0] = (char *)o->shell;
+	argv[1] = "-c";
+	argv[2] = (char *)prompt;
+	argv[3] = NULL;
+	posix_spawn_file_actions_init(&fa);
+	posix_spawn_file_actions_addopen(&fa, STDIN_FILENO, "/dev/null",
+		O_RDONLY, 0);
+	posix_spawn_file_actions_addopen(&fa, STDOUT_FILENO, "/dev/null",
+		O_WRONLY, 0);
+	t0 = now_us();
+	err = posix_spawn(&pid, o->shell, &fa, NULL, argv, environ);
+	posix_spawn_file_actions_destroy(&fa);
+	if (err || waitpid(pid, NULL, 0) == -1)
+		return (-1);
+	return (now_us() - t0);
+}
+
+static int	cmp_double(const void *a, const void *b)
+{
+	double	x;
+	double	y;
+
+	x = *(const double *)a;
+	y = *(const double *)b;
+	return ((x > y) - (x < y));
+}
+
+static int	measure_latency(const t_opts *o, t_result *r)
+{
+	double	*us;
+	int		i;
+
+	us = malloc(o->runs * sizeof(*us));
+	if (!us || run_once(o, r->prompt) < 0)
+	{
+		free(us);
+		return (0);
+	}
+	i = 0;
+	while (i < o->runs)
+	{
+		us[i] = run_once(o, r->prompt);
+		if (us[i++] < 0)
+		{
+			free(us);
+			return (0);
+		}
+	}
+	qsort(us, o->runs, sizeof(*us), cmp_double);
+	r->p50_us = us[(o->runs - 1) / 2];
+	r->p99_us = us[(o->runs - 1) * 99 / 100];
+	free(us);
+	return (1);
+}
+
+/* Counts */
+
+/* A ptrace stop of `pid`. Syscall entries are counted, a process
+ * is let go once it has become a command: a child, or the shell
+ * itself when it runs a command in place. Thread creation (a plain
+ * clone event) is not a fork */
+static void	on_stop(t_result *r, pid_t pid, int ws)
+{
+	struct __ptrace_syscall_info	info;
+	int								sig;
+	int								event;
+
+	sig = WSTOPSIG(ws);
+	event = ws >> 16;
+	if (sig == (SIGTRAP | 0x80))
+	{
+		if (ptrace(PTRACE_GET_SYSCALL_INFO, pid, sizeof(info), &info) > 0
+			&& info.op == PTRACE_SYSCALL_INFO_ENTRY)
+			++r->syscalls;
+		sig = 0;
+	}
+	else if (event == PTRACE_EVENT_FORK || event == PTRACE_EVENT_VFORK)
+		++r->forks;
+	else if (event == PTRACE_EVENT_EXEC)
+	{
+		++r->execs;
+		ptrace(PTRACE_DETACH, pid, 0, 0);
+		return ;
+	}
+	if (event || sig == SIGTRAP || sig == SIGSTOP)
+		sig = 0;
+	ptrace(PTRACE_SYSCALL, pid, 0, sig);
+}
+
+static pid_t	trace_start(const t_opts *o, const char *prompt)
+{
+	char	*argv[4];
+	pid_t	child;
+	int		fd;
+
+	argv[0] = (char *)o->shell;
+	argv[1] = "-c";
+	argv[2] = (char *)prompt;
+	argv[3] = NULL;
+	child = fork();
+	if (child == 0)
+	{
+		fd = open("/dev/null", O_RDWR);
+		if (fd != -1)
+			dup2(fd, STDIN_FILENO);
+		if (fd != -1)
+			dup2(fd, STDOUT_FILENO);
+		ptrace(PTRACE_TRACEME, 0, 0, 0);
+		execv(o->shell, argv);
+		_exit(127);
+	}
+	return (child);
+}
+
+static int	measure_counts(const t_opts *o, t_result *r)
+{
+	pid_t	child;
+	pid_t	pid;
+	int		ws;
+
+	child = trace_start(o, r->prompt);
+	if (child == -1 || waitpid(child, &ws, 0) == -1
+		|| ptrace(PTRACE_SETOPTIONS, child, 0, TRACE_OPTS) == -1
+		|| ptrace(PTRACE_SYSCALL, child, 0, 0) == -1)
+		return (0);
+	while (1)
+	{
+		pid = waitpid(-1, &ws, __WALL);
+		if (pid == -1)
+			return (0);
+		if ((WIFEXITED(ws) || WIFSIGNALED(ws)) && pid == child)
+			break ;
+		if (WIFSTOPPED(ws))
+			on_stop(r, pid, ws);
+	}
+	while (waitpid(-1, &ws, __WALL) > 0)
+		;
+	return (1);
+}
+
+/* JSON */
+
+static void	json_write(FILE *f, const t_opts *o, t_result *res, int n)
+{
+	int	i;
+
+	fprintf(f, "{\n  \"shell\": %s,\n  \"runs\": %d,\n"
+		"  \"prompts\": [\n", json_quote(o->shell), o->runs);
+	i = 0;
+	while (i < n)
+	{
+		fprintf(f, "    {\"prompt\": %s, \"p50_us\": %.1f, \"p99_us\": %.1f, "
+			"\"forks\": %ld, \"execs\": %ld, \"syscalls\": %ld}%s\n",
+			res[i].json, res[i].p50_us, res[i].p99_us, res[i].forks,
+			res[i].execs, res[i].syscalls, (i + 1 < n) ? "," : "");
+		++i;
+	}
+	fprintf(f, "  ]\n}\n");
+}
+
+/* Reads back one prompt line of json_write(). Returns 0 for the
+ * other lines */
+static int	json_parse_line(char *line, t_result *r)
+{
+	char	*p;
+	char	*end;
+
+	p = strstr(line, "{\"prompt\": \"");
+	if (!p)
+		return (0);
+	p += strlen("{\"prompt\": ");
+	end = p + 1;
+	while (*end && *end != '"')
+		end += 1 + (*end == '\\' && end[1]);
+	if (*end != '"')
+		return (0);
+	r->json = strndup(p, ++end - p);
+	return (r->json && sscanf(end, ", \"p50_us\": %lf, \"p99_us\": %lf, "
+			"\"forks\": %ld, \"execs\": %ld, \"syscalls\": %ld",
+			&r->p50_us, &r->p99_us, &r->forks, &r->execs,
+			&r->syscalls) == 5);
+}
+
+static int	json_read(const char *path, t_result **res)
+{
+	char		line[LINE_MAX_LEN * 2];
+	t_result	r;
+	FILE		*f;
+	int			n;
+
+	f = fopen(path, "r");
+	if (!f)
+		return (-1);
+	*res = NULL;
+	n = 0;
+	while (n != -1 && fgets(line, sizeof(line), f))
+	{
+		memset(&r, 0, sizeof(r));
+		if (!json_parse_line(line, &r))
+			free(r.json);
+		else if (!corpus_add(res, &n, NULL))
+			n = -1;
+		else
+			(*res)[n - 1] = r;
+	}
+	fclose(f);
+	return (n);
+}
+
+/* Comparison */
+
+static const t_result	*find_base(const t_result *base, int n,
+	const char *json)
+{
+	int	i;
+
+	i = 0;
+	while (i < n)
+	{
+		if (!strcmp(base[i].json, json))
+			return (&base[i]);
+		++i;
+	}
+	return (NULL);
+}
+
+/* Prints one line per prompt of the baseline still in the corpus.
+ * Returns the number of regressions */
+static int	compare(const t_opts *o, const t_result *res, int n,
+	const t_result *base, int nb)
+{
+	const t_result	*b;
+	int				bad;
+	int				reg;
+	int				i;
+
+	fprintf(stderr, "%-36.36s %9s %9s %7s %7s %9s\n", "prompt", "p50 base",
+		"p50 now", "forks", "execs", "syscalls");
+	reg = 0;
+	i = -1;
+	while (++i < n)
+	{
+		b = find_base(base, nb, res[i].json);
+		if (!b)
+			continue ;
+		bad = res[i].forks > b->forks || res[i].execs > b->execs
+			|| res[i].syscalls > b->syscalls
+			|| res[i].p50_us > b->p50_us * (1 + o->tol_pct / 100);
+		reg += bad;
+		fprintf(stderr, "%-36.36s %9.1f %9.1f %3ld>%-3ld %3ld>%-3ld "
+			"%4ld>%-4ld%s\n", res[i].json, b->p50_us, res[i].p50_us,
+			b->forks, res[i].forks,
+			b->execs, res[i].execs, b->syscalls, res[i].syscalls,
+			bad ? "  REGRESSION" : "");
+	}
+	return (reg);
+}
+
+/* Driver */
+
+static int	parse_opts(int argc, char **argv, t_opts *o)
+{
+	int	c;
+
+	o->corpus = DEF_CORPUS;
+	o->out = NULL;
+	o->baseline = NULL;
+	o->runs = DEF_RUNS;
+	o->tol_pct = DEF_TOL_PCT;
+	while ((c = getopt(argc, argv, "n:o:b:t:")) != -1)
+	{
+		if (c == 'n')
+			o->runs = atoi(optarg);
+		else if (c == 'o')
+			o->out = optarg;
+		else if (c == 'b')
+			o->baseline = optarg;
+		else if (c == 't')
+			o->tol_pct = atof(optarg);
+		else
+			return (0);
+	}
+	if (optind >= argc || o->runs < 1)
+		return (0);
+	o->shell = argv[optind++];
+	if (optind < argc)
+		o->corpus = argv[optind];
+	return (1);
+}
+
+static int	bench_all(const t_opts *o, t_result *res, int n)
+{
+	int	i;
+
+	i = 0;
+	while (i < n)
+	{
+		res[i].json = json_quote(res[i].prompt);
+		if (!measure_latency(o, &res[i]) || !measure_counts(o, &res[i]))
+		{
+			fprintf(stderr, "prompt_bench: %s: failed to run %s\n",
+				o->shell, res[i].json);
+			return (0);
+		}
+		++i;
+	}
+	return (1);
+}
+
+static int	report(const t_opts *o, t_result *res, int n)
+{
+	t_result	*base;
+	FILE		*f;
+	int			nb;
+
+	f = stdout;
+	if (o->out)
+		f = fopen(o->out, "w");
+	if (!f)
+	{
+		perror(o->out);
+		return (2);
+	}
+	json_write(f, o, res, n);
+	if (f != stdout)
+		fclose(f);
+	if (!o->baseline)
+		return (0);
+	nb = json_read(o->baseline, &base);
+	if (nb == -1)
+	{
+		perror(o->baseline);
+		return (2);
+	}
+	return (compare(o, res, n, base, nb) != 0);
+}
+
+int	main(int argc, char **argv)
+{
+	t_opts		o;
+	t_result	*res;
+	int			n;
+
+	if (!parse_opts(argc, argv, &o))
+	{
+		fprintf(stderr, "usage: %s [-n RUNS] [-o OUT] [-b BASELINE] "
+			"[-t PCT] SHELL [CORPUS]\n", argv[0]);
+		return (2);
+	}
+	n = corpus_read(o.corpus, &res);
+	if (n == -1)
+	{
+		perror(o.corpus);
+		return (2);
+	}
+	if (!bench_all(&o, res, n))
+		return (2);
+	return (report(&o, res, n));
+}
@@ -0,0 +1,116 @@
+/* minishell/tests/benchmarks/spawn_latency.c
+ *
+ * Compares how long the shell is blocked while starting one
+ * pipeline stage with fork() + execve() and with the launcher
+ * (src/launch.c, posix_spawn). To look like a shell that has
+ * been running for a while (history, environment, caches) the
+ * benchmark first allocates and touches HEAP_MB megabytes.
+ *
+ *     ./spawn_latency [STAGES] [HEAP_MB]
+ *
+ * For every method it prints the mean time spent in the launch
+ * call itself and the mean time until the stage was reaped */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../../src/launch.h"
+
+#define DEF_STAGES	200
+#define DEF_HEAP_MB	512
+#define PROG_PATH	"/bin/true"
+
+static double	now_us(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e6 + ts.tv_nsec / 1e3);
+}
+
+static pid_t	start_fork(char **argv, char **envp)
+{
+	pid_t	pid;
+
+	pid = fork();
+	if (pid == 0)
+	{
+		execve(argv[0], argv, envp);
+		_exit(127);
+	}
+	return (pid);
+}
+
+static pid_t	start_spawn(char **argv, char **envp)
+{
+	t_launch	l;
+
+	memset(&l, 0, sizeof(l));
+	l.argv = argv;
+	l.envp = envp;
+	l.fd_in = -1;
+	l.fd_out = -1;
+	return (launch_spawn(&l));
+}
+
+static void	bench(const char *name, pid_t (*start)(char **, char **),
+	int stages, char **envp)
+{
+	char	*argv[2];
+	double	t0;
+	double	launch_us;
+	double	total_us;
+	int		i;
+
+	argv[0] = PROG_PATH;
+	argv[1] = NULL;
+	launch_us = 0;
+	total_us = 0;
+	i = 0;
+	while (i < stages)
+	{
+		t0 = now_us();
+		if (start(argv, envp) == -1)
+		{
+			perror(name);
+			exit(EXIT_FAILURE);
+		}
+		launch_us += now_us() - t0;
+		wait(NULL);
+		total_us += now_us() - t0;
+		++i;
+	}
+	printf("%-14s launch %8.1f us/stage, launch+reap %8.1f us/stage\n",
+		name, launch_us / stages, total_us / stages);
+}
+
+int	main(int argc, char **argv, char **env)
+{
+	int		stages;
+	size_t	heap_mb;
+	char	*heap;
+
+	stages = DEF_STAGES;
+	heap_mb = DEF_HEAP_MB;
+	if (argc > 1)
+		stages = atoi(argv[1]);
+	if (argc > 2)
+		heap_mb = atol(argv[2]);
+	heap = malloc(heap_mb << 20);
+	if (!heap && heap_mb)
+	{
+		perror("malloc");
+		return (EXIT_FAILURE);
+	}
+	memset(heap, 1, heap_mb << 20);
+	printf("%d stages of %s, %zu MB of touched heap\n",
+		stages, PROG_PATH, heap_mb);
+	bench("fork+execve", start_fork, stages, env);
+	bench("posix_spawn", start_spawn, stages, env);
+	free(heap);
+	return (EXIT_SUCCESS);
+}
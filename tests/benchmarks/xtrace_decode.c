@@ -0,0 +1,362 @@
+/* minishell/tests/benchmarks/xtrace_decode.c
+ *
+ * Prints a trace written by `minishell --xtrace=FILE` as text:
+ *
+ *     ./xtrace_decode [-s] FILE
+ *
+ * One line per record, seconds since the trace started first:
+ *     0.000412  4242 spawn   /bin/ls -l
+ *     0.001873  4242 exit 0  1.461 ms  /bin/ls -l
+ *     0.001901  4241 builtin 0  cd /tmp
+ * and a line for every run of records the shell dropped because
+ * the ring was full. With -s a table follows, one row per distinct
+ * command: runs, failed runs (status other than 0), and the total
+ * and longest time from spawn to exit */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../../src/xtrace.h"
+
+#define TAB_MIN	256
+
+/* A distinct command, by the hash of its argv */
+typedef struct s_cmd
+{
+	uint64_t	hash;
+	char		*text;
+	long		runs;
+	long		failed;
+	uint64_t	total_ns;
+	uint64_t	max_ns;
+}	t_cmd;
+
+/* A child spawned and not reaped yet */
+typedef struct s_live
+{
+	int32_t		pid;
+	uint64_t	hash;
+	uint64_t	start_ns;
+}	t_live;
+
+/* cmds and live are open addressing tables, `cap`s powers of 2 */
+typedef struct s_decoder
+{
+	t_cmd		*cmds;
+	size_t		cmd_cap;
+	size_t		cmd_cnt;
+	t_live		*live;
+	size_t		live_cap;
+	uint64_t	mono_ns;
+	uint64_t	lost;
+}	t_decoder;
+
+static t_cmd	*cmd_slot(t_cmd *cmds, size_t cap, uint64_t hash)
+{
+	size_t	i;
+
+	i = hash & (cap - 1);
+	while (cmds[i].hash && cmds[i].hash != hash)
+		i = (i + 1) & (cap - 1);
+	return (cmds + i);
+}
+
+/* The command `hash`, added if new */
+static t_cmd	*cmd_get(t_decoder *d, uint64_t hash)
+{
+	t_cmd	*old;
+	size_t	old_cap;
+	size_t	i;
+	t_cmd	*c;
+
+	if ((d->cmd_cnt + 1) * 4 > d->cmd_cap * 3)
+	{
+		old = d->cmds;
+		old_cap = d->cmd_cap;
+		d->cmd_cap *= 2;
+		d->cmds = calloc(d->cmd_cap, sizeof(*d->cmds));
+		if (!d->cmds)
+		{
+			perror("xtrace_decode");
+			exit(1);
+		}
+		i = 0;
+		while (i < old_cap)
+		{
+			if (old[i].hash)
+				*cmd_slot(d->cmds, d->cmd_cap, old[i].hash) = old[i];
+			++i;
+		}
+		free(old);
+	}
+	c = cmd_slot(d->cmds, d->cmd_cap, hash);
+	if (!c->hash)
+	{
+		c->hash = hash;
+		++d->cmd_cnt;
+	}
+	return (c);
+}
+
+static const char	*cmd_text(const t_cmd *c)
+{
+	if (c->text)
+		return (c->text);
+	return ("?");
+}
+
+/* The slot of `pid` among the running children, or an empty one.
+ * A pid is reused only after its exit was recorded, so a table of
+ * fixed size only fails with that many children at once */
+static t_live	*live_slot(t_decoder *d, int32_t pid)
+{
+	size_t	i;
+	size_t	n;
+
+	i = (uint32_t)pid * 2654435761U & (d->live_cap - 1);
+	n = 0;
+	while (d->live[i].pid && d->live[i].pid != pid && ++n < d->live_cap)
+		i = (i + 1) & (d->live_cap - 1);
+	return (d->live + i);
+}
+
+/* Empties `l`, moving the entries after it back so that lookups
+ * do not stop at the hole */
+static void	live_del(t_decoder *d, t_live *l)
+{
+	size_t	hole;
+	size_t	i;
+	size_t	home;
+
+	hole = l - d->live;
+	i = (hole + 1) & (d->live_cap - 1);
+	while (d->live[i].pid)
+	{
+		home = (uint32_t)d->live[i].pid * 2654435761U & (d->live_cap - 1);
+		if (((i - home) & (d->live_cap - 1))
+			>= ((i - hole) & (d->live_cap - 1)))
+		{
+			d->live[hole] = d->live[i];
+			hole = i;
+		}
+		i = (i + 1) & (d->live_cap - 1);
+	}
+	d->live[hole].pid = 0;
+}
+
+static void	decode_exit(t_decoder *d, const t_xt_rec *r, double t)
+{
+	t_live		*l;
+	t_cmd		*c;
+	uint64_t	ns;
+
+	l = live_slot(d, r->pid);
+	if (l->pid != r->pid)
+	{
+		printf("%12.6f %6d exit %d\n", t, r->pid, r->status);
+		return ;
+	}
+	c = cmd_get(d, l->hash);
+	ns = r->ts_ns - l->start_ns;
+	++c->runs;
+	c->failed += r->status != 0;
+	c->total_ns += ns;
+	if (ns > c->max_ns)
+		c->max_ns = ns;
+	printf("%12.6f %6d exit %d  %.3f ms  %s\n", t, r->pid, r->status,
+		ns / 1e6, cmd_text(c));
+	live_del(d, l);
+}
+
+static void	decode_rec(t_decoder *d, const t_xt_rec *r, const char *text)
+{
+	double	t;
+	t_cmd	*c;
+	t_live	*l;
+
+	t = (r->ts_ns - d->mono_ns) / 1e9;
+	if (r->type == XT_TEXT)
+	{
+		c = cmd_get(d, r->hash);
+		free(c->text);
+		c->text = strndup(text, r->len);
+	}
+	else if (r->type == XT_SPAWN)
+	{
+		printf("%12.6f %6d spawn   %s\n", t, r->pid,
+			cmd_text(cmd_get(d, r->hash)));
+		l = live_slot(d, r->pid);
+		l->pid = r->pid;
+		l->hash = r->hash;
+		l->start_ns = r->ts_ns;
+	}
+	else if (r->type == XT_BUILTIN)
+	{
+		c = cmd_get(d, r->hash);
+		++c->runs;
+		c->failed += r->status != 0;
+		printf("%12.6f %6d builtin %d  %s\n", t, r->pid, r->status,
+			cmd_text(c));
+	}
+	else if (r->type == XT_EXIT)
+		decode_exit(d, r, t);
+	else if (r->type == XT_LOST)
+	{
+		d->lost += r->status;
+		printf("%12.6f        lost %d records\n", t, r->status);
+	}
+}
+
+/* Walks the records of `buf`, the trace without its header.
+ * Returns 0 if the file is cut short or corrupted */
+static int	decode(t_decoder *d, const char *buf, size_t len)
+{
+	t_xt_rec	r;
+	size_t		off;
+	size_t		size;
+
+	off = 0;
+	while (off + sizeof(r) <= len)
+	{
+		memcpy(&r, buf + off, sizeof(r));
+		size = (sizeof(r) + r.len + XT_REC_ALIGN - 1)
+			& ~(size_t)(XT_REC_ALIGN - 1);
+		if (off + size > len || r.type > XT_LOST)
+			return (0);
+		decode_rec(d, &r, buf + off + sizeof(r));
+		off += size;
+	}
+	return (off == len);
+}
+
+static int	cmp_total(const void *a, const void *b)
+{
+	const t_cmd	*x;
+	const t_cmd	*y;
+
+	x = a;
+	y = b;
+	if (x->total_ns != y->total_ns)
+		return ((x->total_ns < y->total_ns) - (x->total_ns > y->total_ns));
+	return ((x->runs < y->runs) - (x->runs > y->runs));
+}
+
+/* Distinct commands, the most time first */
+static void	summary(t_decoder *d)
+{
+	size_t	i;
+	size_t	n;
+
+	n = 0;
+	i = 0;
+	while (i < d->cmd_cap)
+	{
+		if (d->cmds[i].hash)
+			d->cmds[n++] = d->cmds[i];
+		++i;
+	}
+	qsort(d->cmds, n, sizeof(*d->cmds), cmp_total);
+	printf("\n%8s %8s %12s %12s  %s\n", "runs", "failed", "total ms",
+		"max ms", "command");
+	i = 0;
+	while (i < n)
+	{
+		printf("%8ld %8ld %12.3f %12.3f  %s\n", d->cmds[i].runs,
+			d->cmds[i].failed, d->cmds[i].total_ns / 1e6,
+			d->cmds[i].max_ns / 1e6, cmd_text(d->cmds + i));
+		++i;
+	}
+	if (d->lost)
+		printf("%lu records lost\n", (unsigned long)d->lost);
+}
+
+static char	*read_file(const char *path, size_t *len)
+{
+	struct stat	st;
+	char		*buf;
+	ssize_t		n;
+	int			fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1 || fstat(fd, &st) == -1)
+		return (NULL);
+	buf = malloc(st.st_size + 1);
+	*len = 0;
+	while (buf && *len < (size_t)st.st_size)
+	{
+		n = read(fd, buf + *len, st.st_size - *len);
+		if (n <= 0)
+			break ;
+		*len += n;
+	}
+	close(fd);
+	return (buf);
+}
+
+static void	print_header(const t_xt_file *hdr, const char *path)
+{
+	char		date[64];
+	time_t		sec;
+	struct tm	tm;
+
+	sec = hdr->real_ns / 1000000000ULL;
+	localtime_r(&sec, &tm);
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+	printf("%s: shell %d, started %s.%06lu\n", path, hdr->pid, date,
+		(unsigned long)(hdr->real_ns % 1000000000ULL / 1000));
+}
+
+int	main(int argc, char **argv)
+{
+	t_decoder	d;
+	t_xt_file	hdr;
+	char		*buf;
+	size_t		len;
+	int			sum;
+	int			ok;
+
+	sum = argc == 3 && !strcmp(argv[1], "-s");
+	if (argc != 2 + sum)
+	{
+		fprintf(stderr, "usage: %s [-s] FILE\n", argv[0]);
+		return (2);
+	}
+	buf = read_file(argv[1 + sum], &len);
+	if (!buf)
+	{
+		perror(argv[1 + sum]);
+		return (1);
+	}
+	memset(&hdr, 0, sizeof(hdr));
+	if (len >= sizeof(hdr))
+		memcpy(&hdr, buf, sizeof(hdr));
+	if (hdr.magic != XT_MAGIC
+		|| hdr.version != XT_VERSION || hdr.rec_align != XT_REC_ALIGN)
+	{
+		fprintf(stderr, "%s: not a minishell trace\n", argv[1 + sum]);
+		return (1);
+	}
+	print_header(&hdr, argv[1 + sum]);
+	memset(&d, 0, sizeof(d));
+	d.mono_ns = hdr.mono_ns;
+	d.cmd_cap = TAB_MIN;
+	d.live_cap = TAB_MIN * 16;
+	d.cmds = calloc(d.cmd_cap, sizeof(*d.cmds));
+	d.live = calloc(d.live_cap, sizeof(*d.live));
+	if (!d.cmds || !d.live)
+	{
+		perror("xtrace_decode");
+		return (1);
+	}
+	ok = decode(&d, buf + sizeof(hdr), len - sizeof(hdr));
+	if (!ok)
+		fprintf(stderr, "%s: truncated trace\n", argv[1 + sum]);
+	if (sum)
+		summary(&d);
+	return (!ok);
+}
@@ -0,0 +1,227 @@
+/* minishell/tests/boolean_logic_tester/progs/letter.c
+ *
+ * The letter-operands of the boolean logic tester, a-z and A-Z,
+ * as one multi-call binary: every letter is a symbolic link to
+ * `letter` and the program acts on the name it was called by.
+ *
+ *     x [-d MS] [-o BYTES] [-x CODE] [-q]
+ *
+ * A lowercase letter exits with 0 and an uppercase one with 1,
+ * like the bash scripts they replace. Before exiting the program
+ * prints its name to /dev/tty and writes its PID and PPID to
+ * ../logs/<letter> (the tester's log directory when run from
+ * progs/). Options:
+ *     -d MS    - sleep MS milliseconds first. By default a letter
+ *                sleeps its index in the alphabet (a/A = 0, z/Z =
+ *                25) times $LETTER_STEP_MS, 0 when unset: with
+ *                LETTER_STEP_MS=1000 the letters sleep as the old
+ *                scripts did;
+ *     -o BYTES - write BYTES bytes (k and m suffixes work) to
+ *                stdout, after a copy of stdin unless stdin is a
+ *                terminal: a pipeline workload;
+ *     -x CODE  - exit with CODE instead;
+ *     -q       - write neither to /dev/tty nor to the log file.
+ *
+ * Without the sleeps the tester runs thousands of cases a second */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STEP_VAR	"LETTER_STEP_MS"
+#define LOG_DIR		"../logs/"
+#define CHUNK		65536
+#define EXIT_USAGE	2
+
+typedef struct s_letter
+{
+	char	name;
+	long	delay_ms;
+	long	out_bytes;
+	int		code;
+	int		quiet;
+}	t_letter;
+
+/* N, Nk or Nm; -1 if `s` is not a size */
+static long	parse_size(const char *s)
+{
+	char	*end;
+	long	n;
+
+	errno = 0;
+	n = strtol(s, &end, 10);
+	if (errno || end == s || n < 0)
+		return (-1);
+	if (*end == 'k' || *end == 'K')
+		n <<= 10;
+	else if (*end == 'm' || *end == 'M')
+		n <<= 20;
+	else if (*end)
+		return (-1);
+	if (*end && end[1])
+		return (-1);
+	return (n);
+}
+
+/* The letter the program was called by, 0 if it is not one */
+static char	letter_name(const char *argv0)
+{
+	const char	*base;
+
+	base = strrchr(argv0, '/');
+	if (base)
+		++base;
+	else
+		base = argv0;
+	if (base[0] && !base[1] && ((base[0] >= 'a' && base[0] <= 'z')
+			|| (base[0] >= 'A' && base[0] <= 'Z')))
+		return (base[0]);
+	return (0);
+}
+
+static void	letter_defaults(t_letter *l)
+{
+	const char	*step;
+	int			index;
+
+	l->code = 0;
+	index = l->name - 'a';
+	if (l->name >= 'A' && l->name <= 'Z')
+	{
+		l->code = 1;
+		index = l->name - 'A';
+	}
+	l->delay_ms = 0;
+	step = getenv(STEP_VAR);
+	if (step)
+		l->delay_ms = index * atol(step);
+	l->out_bytes = 0;
+	l->quiet = 0;
+}
+
+static int	letter_opts(int argc, char **argv, t_letter *l)
+{
+	int	c;
+
+	while ((c = getopt(argc, argv, "d:o:x:q")) != -1)
+	{
+		if (c == 'd')
+			l->delay_ms = parse_size(optarg);
+		else if (c == 'o')
+			l->out_bytes = parse_size(optarg);
+		else if (c == 'x')
+			l->code = atoi(optarg);
+		else if (c == 'q')
+			l->quiet = 1;
+		else
+			return (0);
+		if (l->delay_ms < 0 || l->out_bytes < 0)
+			return (0);
+	}
+	return (optind == argc);
+}
+
+static int	write_all(const char *buf, size_t len)
+{
+	ssize_t	n;
+
+	while (len)
+	{
+		n = write(STDOUT_FILENO, buf, len);
+		if (n < 0 && errno == EINTR)
+			continue ;
+		if (n < 0)
+			return (0);
+		buf += n;
+		len -= n;
+	}
+	return (1);
+}
+
+/* The stdin of a pipeline stage, then `l->out_bytes` bytes of the letter
+ * in lines of 64 */
+static int	produce(const t_letter *l)
+{
+	static char	buf[CHUNK];
+	ssize_t		n;
+	size_t		len;
+	long		left;
+
+	n = 1;
+	while (!isatty(STDIN_FILENO) && n > 0)
+	{
+		n = read(STDIN_FILENO, buf, sizeof(buf));
+		if (n > 0 && !write_all(buf, n))
+			return (0);
+	}
+	memset(buf, l->name, sizeof(buf));
+	n = 63;
+	while (n < CHUNK)
+	{
+		buf[n] = '\n';
+		n += 64;
+	}
+	left = l->out_bytes;
+	while (left)
+	{
+		len = CHUNK;
+		if ((long)len > left)
+			len = left;
+		if (!write_all(buf, len))
+			return (0);
+		left -= len;
+	}
+	return (1);
+}
+
+/* What the old scripts did: the letter on the terminal, PID and
+ * PPID in the log directory. Either may be missing */
+static void	report(const t_letter *l)
+{
+	char	path[sizeof(LOG_DIR) + 1];
+	int		fd;
+
+	fd = open("/dev/tty", O_WRONLY | O_NOCTTY | O_CLOEXEC);
+	if (fd != -1)
+	{
+		dprintf(fd, "%c\n", l->name);
+		close(fd);
+	}
+	snprintf(path, sizeof(path), LOG_DIR "%c", l->name);
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd != -1)
+	{
+		dprintf(fd, "PID=%d\nPPID=%d\n", getpid(), getppid());
+		close(fd);
+	}
+}
+
+int	main(int argc, char **argv)
+{
+	struct timespec	ts;
+	t_letter		l;
+
+	l.name = letter_name(argv[0]);
+	if (l.name)
+		letter_defaults(&l);
+	if (!l.name || !letter_opts(argc, argv, &l))
+	{
+		fprintf(stderr, "usage: [a-zA-Z] [-d MS] [-o BYTES] [-x CODE] "
+			"[-q]\n(%s must be called through a one-letter link)\n",
+			argv[0]);
+		return (EXIT_USAGE);
+	}
+	ts.tv_sec = l.delay_ms / 1000;
+	ts.tv_nsec = l.delay_ms % 1000 * 1000000;
+	while (l.delay_ms && nanosleep(&ts, &ts) == -1 && errno == EINTR)
+		;
+	if (l.out_bytes && !produce(&l))
+		perror(argv[0]);
+	if (!l.quiet)
+		report(&l);
+	return (l.code);
+}
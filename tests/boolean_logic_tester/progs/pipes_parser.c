@@ -5,6 +5,7 @@
  * alphabet. Lowercase-letter programs always return 0 (success),
  * while uppercase-letter programs always return 1 (failure) */
 
+# define _GNU_SOURCE
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
@@ -19,18 +20,15 @@
 # include <readline/readline.h>
 # include <readline/history.h>
 
+# include "../../../src/vector.h"
+# include "../../../src/launch.h"
+
 typedef long long	t_ll;
 
 # define EXIT_CMD			"exit"
 
 # define MAX_FORMAT_STR_LEN	64
 # define PROMPT_INV_LEN		64	// Maximum length of user's prompt invitation string
-# define MAX_PIPES_NUM		128
-# define MAX_OPS_NUM		128
-# define MAX_PAR_NUM		128	// Maximum parentheses number
-# define MAX_TOKENS_NUM		128 // Maximum number of tokens
-# define MAX_SUBSHS_NUM		128 // Maximum number of subshells
-# define MAX_TOKEN_LEN		128 // Maximum length of each token
 
 # define READ_END			0
 # define WRITE_END			1
@@ -84,8 +82,9 @@ typedef enum e_par_type
 	CLOSING_PAR
 }	t_par_type;
 
-/* If this token's type is OPERAND we store
- * the pointer to the corresponding operand.
+/* If this token's type is OPERAND we store the index
+ * of the corresponding operand in `d->ops` (not a pointer,
+ * the operands vector may be moved when it grows).
  *
  *     start_pi - Index of the first character
  *				  in the prompt string with
@@ -94,50 +93,58 @@ typedef enum e_par_type
 typedef struct s_token
 {
 	t_token_type	type;
-	t_operand		*op;
+	size_t			op_ind;
 	size_t			start_pi;
 }	t_token;
 
+/* Prompt index and its flag (NOT_CLOSED_PAR or CLOSED_PAR) */
+typedef struct s_par_pos
+{
+	size_t	ind;
+	int		flag;
+}	t_par_pos;
+
+/* All the arrays below are vectors (src/vector.h): their
+ * length is the corresponding counter, they start in inline
+ * storage and only grow to the heap for big prompts.
+ * Clearing them between prompts is O(1) */
 typedef struct s_engine_data
 {
-	char		*prompt;					// Prompt entered by user
-	size_t		pi;							// Prompt index
-
-	size_t		pipe_cnt;					// Pipe counter
-	int			pipes[MAX_PIPES_NUM][2];	// All pipes array
-	
-	size_t		op_cnt;						// Operand counter
-	t_operand	ops[MAX_OPS_NUM];			// Operands (programs to launch)
-	
-	size_t		opar_num;					// Number of all opening-parentheses
-	size_t		all_open_pars[MAX_PAR_NUM][2]; // Indexes of all opening-parentheses
-	
-	int			opar_cnt;					// Opening-parentheses counter (must be int)
-	size_t		open_par[MAX_PAR_NUM];		// Opening-parentheses indexes found and thier flags
-	
-	int			cpar_cnt;					// Closing-parentheses counter (for now let it be int)
-	size_t		close_par[MAX_PAR_NUM][2];	// Closing-parentheses indexes found and their flags
-	
-	t_pair		pars[MAX_PAR_NUM];			// A member that represents each parentheses pair
-	size_t		par_cnt;					// Parentheses pair counter
-	
-	size_t		token_cnt;					// Token counter
-	t_token		tokens[MAX_TOKENS_NUM];		// Here we store all tokens we found during parsing
+	char		*prompt;		// Prompt entered by user
+	size_t		prompt_len;		// Its length (the prompt is never changed after init)
+	size_t		pi;				// Prompt index
+
+	t_vector	pipes;			// int[2]: all pipes array
+	t_vector	ops;			// t_operand: operands (programs to launch)
+	t_vector	all_open_pars;	// t_par_pos: all opening-parentheses
+	t_vector	open_par;		// size_t: stack of opening-parentheses being handled
+	t_vector	close_par;		// t_par_pos: closing-parentheses found and their flags
+	t_vector	pars;			// t_pair: each parentheses pair
+	t_vector	tokens;			// t_token: all tokens we found during parsing
 
 }	t_engine_data;
 
+# define PIPE_AT(d, i)		((int *)vec_at(&(d)->pipes, (i)))
+# define OP_AT(d, i)		VEC_AT(&(d)->ops, t_operand, (i))
+# define TOKEN_AT(d, i)		VEC_AT(&(d)->tokens, t_token, (i))
+# define LAST_TOKEN(d)		VEC_LAST(&(d)->tokens, t_token)
+
 /* Initialization */
+void			engine_data_init(t_engine_data *d);
+void			engine_data_free(t_engine_data *d);
 int				parser_init(t_engine_data *d, char *rline_buf);
-void			init_ops(t_operand *ops);
 void			init_open_par(t_engine_data *d);
 void			init_close_par(t_engine_data *d);
 void			init_tokens(t_engine_data *d);
-void			init_pars(t_pair *pars);
+void			*emplace(t_vector *v);
 void			remove_right_spaces(char *prompt);
 bool			check_empty_par(char *prompt);
 
 /* Parser engine */
 bool			parser_engine(t_engine_data *d);
+t_token			*add_token(t_engine_data *d, t_token_type type);
+void			add_operand(t_engine_data *d);
+void			add_pipe(t_engine_data *d);
 void			handle_open_par(t_engine_data *d, int opar_ind, bool *f_noerr);
 void			handle_close_par(t_engine_data *d, bool *f_noerr);
 int				later_goes_open_par(char *str, size_t ind);
@@ -145,6 +152,7 @@ void			skip_spaces(char *prompt, size_t *pi);
 
 /* Execution flow */
 int				exec_ops(t_engine_data *d);
+int				spawn_op(t_engine_data *d, t_operand *op);
 t_ll			get_par_by_token(t_engine_data *d, size_t ti, t_par_type ptype);
 t_ll			get_token_by_par(t_engine_data *d, size_t pi);
 int				close_pipes(t_engine_data *d);
@@ -162,6 +170,7 @@ int	main(void)
 
 	rline_buf = NULL;
 	strncpy(prompt, "dchernik@c3r3s6: ", PROMPT_INV_LEN);
+	engine_data_init(&eng_data);
 	while (1) // readline loop
 	{
 		rline_buf = readline(prompt);
@@ -206,28 +215,50 @@ int	main(void)
 		rline_buf = NULL;
 
 	} // while (1) // readline loop
+	engine_data_free(&eng_data);
 	return 0;
 }
 
+void	engine_data_init(t_engine_data *d)
+{
+	vec_init(&d->pipes, sizeof(int [2]));
+	vec_init(&d->ops, sizeof(t_operand));
+	vec_init(&d->all_open_pars, sizeof(t_par_pos));
+	vec_init(&d->open_par, sizeof(size_t));
+	vec_init(&d->close_par, sizeof(t_par_pos));
+	vec_init(&d->pars, sizeof(t_pair));
+	vec_init(&d->tokens, sizeof(t_token));
+}
+
+void	engine_data_free(t_engine_data *d)
+{
+	vec_free(&d->pipes);
+	vec_free(&d->ops);
+	vec_free(&d->all_open_pars);
+	vec_free(&d->open_par);
+	vec_free(&d->close_par);
+	vec_free(&d->pars);
+	vec_free(&d->tokens);
+}
+
+/* Only the slots the previous prompt used are forgotten here,
+ * clearing a vector is O(1). Each new operand, token and pair
+ * is initialized when it is added during parsing */
 int	parser_init(t_engine_data *d, char *rline_buf)
 {
 	d->pi			= 0;
-	d->op_cnt		= 0;
-	d->pipe_cnt		= 0;
-	d->opar_num		= 0;
-	d->opar_cnt		= 0;
-	d->cpar_cnt		= 0;
-	d->par_cnt		= 0;
-	d->token_cnt	= 1; // The first token is always NONE
 	d->prompt		= rline_buf;
 
 	remove_right_spaces(d->prompt);
+	d->prompt_len	= strlen(d->prompt);
 
-	init_ops(d->ops); // Initialize operators array
+	vec_clear(&d->pipes);
+	vec_clear(&d->ops);
+	vec_clear(&d->open_par);
+	vec_clear(&d->pars);
 	init_open_par(d);
 	init_close_par(d);
 	init_tokens(d);
-	init_pars(d->pars);
 
 	if (!check_empty_par(d->prompt))
 	{
@@ -238,90 +269,66 @@ int	parser_init(t_engine_data *d, char *rline_buf)
 	return 1;
 }
 
-/* Assign the default value to
- * the pipes of all operators */
-void	init_ops(t_operand *ops)
-{
-	size_t	i;
-
-	i = 0;
-	while (i < MAX_OPS_NUM)
-	{
-		ops[i].write_end = DEFAULT_FD;
-		ops[i].read_end = DEFAULT_FD;
-		++i;
-	}
-}
-
+/* Remembers the indexes of all opening parentheses */
 void	init_open_par(t_engine_data *d)
 {
-	size_t	i;
+	t_par_pos	*par;
+	size_t		i;
 
+	vec_clear(&d->all_open_pars);
 	i = 0;
-	while (i < strlen(d->prompt))
+	while (i < d->prompt_len)
 	{
 		if (d->prompt[i] == '(')
 		{
-			d->all_open_pars[d->opar_num][0] = i;
-			d->all_open_pars[d->opar_num][1] = NOT_CLOSED_PAR;
-			++d->opar_num;
+			par = emplace(&d->all_open_pars);
+			par->ind = i;
+			par->flag = NOT_CLOSED_PAR;
 		}
 		++i;
 	}
-	i = 0;
-	while (i < d->opar_num)
-	{
-		d->open_par[i] = NONE_INDEX;
-		++i;
-	}
 }
 
 /* Counts all closing parentheses and remembers their indexes */
 void	init_close_par(t_engine_data *d)
 {
-	size_t	i;
+	t_par_pos	*par;
+	size_t		i;
 
+	vec_clear(&d->close_par);
 	i = 0;
-	while (i < strlen(d->prompt))
+	while (i < d->prompt_len)
 	{
 		if (d->prompt[i] == ')')
 		{
-			d->close_par[d->cpar_cnt][0] = i;
-			d->close_par[d->cpar_cnt][1] = NOT_CLOSED_PAR;
-			++d->cpar_cnt;
+			par = emplace(&d->close_par);
+			par->ind = i;
+			par->flag = NOT_CLOSED_PAR;
 		}
 		++i;
 	}
 }
 
+/* The first token is always NONE */
 void	init_tokens(t_engine_data *d)
 {
-	size_t	i;
-
-	i = 0;
-	while (i < MAX_TOKENS_NUM)
-	{
-		d->tokens[i].op = NULL;
-		++i; 
-	}
-	d->tokens[0].type = NONE;
-	d->tokens[0].start_pi = 0;
+	vec_clear(&d->tokens);
+	add_token(d, NONE)->start_pi = 0;
 }
 
-/* Let's say the first element of the
- * pair is the opening parenthesis,
- * and the second is the closing one */
-void	init_pars(t_pair *pars)
+/* Appends a new slot to the vector. There is
+ * no way to go on parsing if we are out of memory */
+void	*emplace(t_vector *v)
 {
-	size_t	i;
+	void	*slot;
 
-	i = 0;
-	while (i < MAX_PAR_NUM)
+	slot = vec_emplace(v);
+	if (!slot)
 	{
-		pars->first = NONE_PAR_IND;
-		pars->second = NONE_PAR_IND;
-		++i;
+		fprintf(stderr, "Can't allocate memory: %s\n", strerror(errno));
+		exit(EXIT_FAILURE);
 	}
+	return (slot);
 }
 
 void	remove_right_spaces(char *prompt)
@@ -373,7 +380,7 @@ bool parser_engine(t_engine_data *d)
 	int		opar_ind;	// Prompt index of the open-parenthesis that goes after pipe
 	
 	f_noerr = true; // Let's assume there are no errors at first
-	prompt_len = strlen(d->prompt);
+	prompt_len = d->prompt_len;
 	while (d->pi < prompt_len) // Going through the entered prompt string
 	{
 		if (d->prompt[d->pi] == ' ')
@@ -389,9 +396,9 @@ bool parser_engine(t_engine_data *d)
 			// Letter-operand can go only after
 			// pipe or be the first token or
 			// go after '('
-			if (d->tokens[d->token_cnt - 1].type != NONE &&
-				d->tokens[d->token_cnt - 1].type != PIPE &&
-				d->tokens[d->token_cnt - 1].type != OPEN_PAR)
+			if (LAST_TOKEN(d).type != NONE &&
+				LAST_TOKEN(d).type != PIPE &&
+				LAST_TOKEN(d).type != OPEN_PAR)
 			{
 				// Situations like:
 				// "a | (b | c) d"
@@ -403,17 +410,8 @@ bool parser_engine(t_engine_data *d)
 				break ;
 			}
 
-			// Add this letter in the operators array
-			d->ops[d->op_cnt].name[0] = d->prompt[d->pi];
-			d->ops[d->op_cnt].name[1] = '\0';
-
-			// Add this operand into the tokens array
-			d->tokens[d->token_cnt].type = OPERAND;
-			d->tokens[d->token_cnt].op = (t_operand *)&d->ops[d->op_cnt];
-			d->tokens[d->token_cnt].start_pi = d->pi;
-			++d->token_cnt;
-
-			++d->op_cnt;
+			// Add this letter in the operators and tokens arrays
+			add_operand(d);
 
 			++d->pi; // Move one symbol forward in prompt
 
@@ -423,10 +421,10 @@ bool parser_engine(t_engine_data *d)
 			// It means nothing is on the right (just spaces)
 			if (d->pi == prompt_len) // We reached the end of the prompt
 			{
-				if (d->pipe_cnt > 0) // If it's the last operand in the prompt
+				if (d->pipes.len > 0) // If it's the last operand in the prompt
 				{
-					d->ops[d->op_cnt - 1].read_end = d->pipe_cnt - 1;
-					d->ops[d->op_cnt - 1].write_end = NONE_PIPE;
+					OP_AT(d, d->ops.len - 1).read_end = d->pipes.len - 1;
+					OP_AT(d, d->ops.len - 1).write_end = NONE_PIPE;
 				}
 				// Otherwise, it means our prompt contains only one letter-operand
 				break ;
@@ -436,8 +434,8 @@ bool parser_engine(t_engine_data *d)
 			if (d->prompt[d->pi] == '|') // If further goes pipe
 			{
 				// A pipe can go only after an operand or after a ')'
-				if (d->tokens[d->token_cnt - 1].type != OPERAND &&
-					d->tokens[d->token_cnt - 1].type != CLOSE_PAR)
+				if (LAST_TOKEN(d).type != OPERAND &&
+					LAST_TOKEN(d).type != CLOSE_PAR)
 				{
 					// Situations like:
 					// "a ( | b"
@@ -449,27 +447,18 @@ bool parser_engine(t_engine_data *d)
 				}
 
 				// Add this operand into the tokens array
-				d->tokens[d->token_cnt].type = PIPE;
-				d->tokens[d->token_cnt].start_pi = d->pi;
-				++d->token_cnt;
+				add_token(d, PIPE)->start_pi = d->pi;
 
-				// Let's create a pipe
-				if (pipe(&d->pipes[d->pipe_cnt][0]) == -1)
-				{
-					fprintf(stderr, "Can't create pipe: %s\n", strerror(errno));
-					exit(EXIT_FAILURE);
-				}
-
-				if (d->pipe_cnt == 0) // If it's the first operand found
-					d->ops[d->op_cnt - 1].read_end = NONE_PIPE;
+				if (d->pipes.len == 0) // If it's the first operand found
+					OP_AT(d, d->ops.len - 1).read_end = NONE_PIPE;
 				else // It's not the first operand
 				// Assign to its stdin the previous pipe index
-					d->ops[d->op_cnt - 1].read_end = d->pipe_cnt - 1;
+					OP_AT(d, d->ops.len - 1).read_end = d->pipes.len - 1;
 
 				// Assign to its stdout the current pipe index
-				d->ops[d->op_cnt - 1].write_end = d->pipe_cnt;
+				OP_AT(d, d->ops.len - 1).write_end = d->pipes.len;
 
-				++d->pipe_cnt;	// Increment pipe index
+				add_pipe(d); // Let's create a pipe
 
 				opar_ind = later_goes_open_par(d->prompt, d->pi);
 				// If after pipe goes opening-parenthesis '('
@@ -481,11 +470,11 @@ bool parser_engine(t_engine_data *d)
 					else
 					{
 						// If we are here it means ')' was found
-						if (d->tokens[d->token_cnt - 1].type == CLOSE_PAR &&
+						if (LAST_TOKEN(d).type == CLOSE_PAR &&
 							d->pi == prompt_len)
 						{
-							if (d->pipe_cnt > 0)
-								d->ops[d->op_cnt - 1].read_end = d->pipe_cnt - 1;
+							if (d->pipes.len > 0)
+								OP_AT(d, d->ops.len - 1).read_end = d->pipes.len - 1;
 						}
 						continue ; // Go further by prompt
 					}
@@ -529,9 +518,9 @@ bool parser_engine(t_engine_data *d)
 			{
 				// A '(' can go only after a pipe or another '('
 				// or also be the first token found
-				if (d->tokens[d->token_cnt - 1].type != NONE &&
-					d->tokens[d->token_cnt - 1].type != PIPE &&
-					d->tokens[d->token_cnt - 1].type != OPEN_PAR) // ~(A + B) = ~A * ~B
+				if (LAST_TOKEN(d).type != NONE &&
+					LAST_TOKEN(d).type != PIPE &&
+					LAST_TOKEN(d).type != OPEN_PAR) // ~(A + B) = ~A * ~B
 				{
 					// Situations like:
 					// "a | (b | c)(d | e)"
@@ -548,11 +537,11 @@ bool parser_engine(t_engine_data *d)
 				else
 				{
 					// If we are here it means ')' was found
-					if (d->tokens[d->token_cnt - 1].type == CLOSE_PAR &&
+					if (LAST_TOKEN(d).type == CLOSE_PAR &&
 						d->pi == prompt_len)
 					{
-						if (d->pipe_cnt > 0)
-							d->ops[d->op_cnt - 1].read_end = d->pipe_cnt - 1;
+						if (d->pipes.len > 0)
+							OP_AT(d, d->ops.len - 1).read_end = d->pipes.len - 1;
 					}
 					continue ; // Go further by prompt
 				}
@@ -565,8 +554,8 @@ bool parser_engine(t_engine_data *d)
 			else if (d->prompt[d->pi] == '|') // If it's pipe 
 			{
 				// Pipe can go only after a ')' or after an operand
-				if (d->tokens[d->token_cnt - 1].type != CLOSE_PAR &&
-					d->tokens[d->token_cnt - 1].type != OPERAND)
+				if (LAST_TOKEN(d).type != CLOSE_PAR &&
+					LAST_TOKEN(d).type != OPERAND)
 				{
 					// Situations like:
 					// "a | (b | c)( | d"
@@ -578,24 +567,15 @@ bool parser_engine(t_engine_data *d)
 				}
 
 				// Add this operand into the tokens array
-				d->tokens[d->token_cnt].type = PIPE;
-				d->tokens[d->token_cnt].start_pi = d->pi;
-				++d->token_cnt;
-
-				// Let's create a pipe
-				if (pipe(&d->pipes[d->pipe_cnt][0]) == -1)
-				{
-					fprintf(stderr, "Can't create pipe: %s\n", strerror(errno));
-					exit(EXIT_FAILURE);
-				}
+				add_token(d, PIPE)->start_pi = d->pi;
 
 				// Assign to its stdin the previous pipe index
-				d->ops[d->op_cnt - 1].read_end = d->pipe_cnt - 1;
+				OP_AT(d, d->ops.len - 1).read_end = d->pipes.len - 1;
 
 				// Assign to its stdout the current pipe index
-				d->ops[d->op_cnt - 1].write_end = d->pipe_cnt;
+				OP_AT(d, d->ops.len - 1).write_end = d->pipes.len;
 
-				++d->pipe_cnt; // Increment pipe index
+				add_pipe(d); // Let's create a pipe
 			
 				// Go further by prompt
 
@@ -614,32 +594,70 @@ bool parser_engine(t_engine_data *d)
 	return f_noerr;
 } // parser_engine() function
 
+t_token	*add_token(t_engine_data *d, t_token_type type)
+{
+	t_token	*token;
+
+	token = emplace(&d->tokens);
+	token->type = type;
+	token->op_ind = 0;
+	return (token);
+}
+
+/* Adds the letter at `d->pi` as a new operand */
+void	add_operand(t_engine_data *d)
+{
+	t_operand	*op;
+	t_token		*token;
+
+	op = emplace(&d->ops);
+	op->name[0] = d->prompt[d->pi];
+	op->name[1] = '\0';
+	op->read_end = DEFAULT_FD;
+	op->write_end = DEFAULT_FD;
+	op->pid = 0;
+	token = add_token(d, OPERAND);
+	token->op_ind = d->ops.len - 1;
+	token->start_pi = d->pi;
+}
+
+/* Pipes are close-on-exec, an operand only inherits the two
+ * ends it gets on its stdin/stdout */
+void	add_pipe(t_engine_data *d)
+{
+	if (pipe2(emplace(&d->pipes), O_CLOEXEC) == -1)
+	{
+		fprintf(stderr, "Can't create pipe: %s\n", strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+}
+
 /* Handles opening-parenthesis */
 void	handle_open_par(t_engine_data *d, int opar_ind, bool *f_noerr)
 {
-	size_t	last_opar_ind;
-	size_t	prompt_len;
-	size_t	i;
+	size_t		last_opar_ind;
+	size_t		prompt_len;
+	size_t		i;
+	t_pair		*pair;
+	t_par_pos	*cpar;
 
 	// Add this operand into the tokens array
-	d->tokens[d->token_cnt].type = OPEN_PAR;
-	d->tokens[d->token_cnt].start_pi = d->pi;
-	++d->token_cnt;
+	add_token(d, OPEN_PAR)->start_pi = d->pi;
 
-	prompt_len = strlen(d->prompt);
-	// Add its prompt index to the opening-parentheses array
-	d->open_par[d->opar_cnt] = opar_ind;
+	prompt_len = d->prompt_len;
+	// Add its prompt index to the opening-parentheses
+	// stack (this increments opening-parenthesis counter)
+	*(size_t *)emplace(&d->open_par) = opar_ind;
 
 	// Add this opening-parenthesis index to
 	// the pair of all all parentheses pairs
-	d->pars[d->par_cnt].first = opar_ind;
-	++d->par_cnt;
+	pair = emplace(&d->pars);
+	pair->first = opar_ind;
+	pair->second = NONE_PAR_IND;
 
 	// Move to the next symbol in the prompt after '('
 	d->pi = opar_ind + 1;
 
-	++d->opar_cnt; // Increment opening-parenthesis counter
-
 	// When prompt like this "a | b | (" for example
 	if (d->pi == prompt_len)
 	{
@@ -661,10 +679,10 @@ void	handle_open_par(t_engine_data *d, int opar_ind, bool *f_noerr)
 	 * this ')' and the last found '('.
 	 * Furthermore, we must remove the index
 	 * of the last found '(' from `d->opar`
-	 * and decrement `d->opar_cnt` */	
+	 * and pop it from `d->open_par` */	
 
 	// If the closing-parentheses array is empty
-	if (d->cpar_cnt == 0)
+	if (d->close_par.len == 0)
 	{
 		*f_noerr = false;
 		fprintf(stderr, "Parsing error: "
@@ -675,18 +693,18 @@ void	handle_open_par(t_engine_data *d, int opar_ind, bool *f_noerr)
 	// Let's find, in the closing-parentheses array, the nearest
 	// ')' that is not marked as closed to the last found '(' and
 	// that is located on the right from '('
-	last_opar_ind = d->open_par[d->opar_cnt - 1];
+	last_opar_ind = VEC_LAST(&d->open_par, size_t);
 	i = 0;
 	// The closing-parentheses array is already sorted
-	while (i < d->cpar_cnt)
+	while (i < d->close_par.len)
 	{
-		if (d->close_par[i][0] > last_opar_ind &&
-			d->close_par[i][1] == NOT_CLOSED_PAR)
+		cpar = &VEC_AT(&d->close_par, t_par_pos, i);
+		if (cpar->ind > last_opar_ind && cpar->flag == NOT_CLOSED_PAR)
 			break;
 		++i;
 	}
 
-	if (i == d->cpar_cnt) // We went out of the array border
+	if (i == d->close_par.len) // We went out of the array border
 	{
 		*f_noerr = false;
 		fprintf(stderr, "Parsing error: "
@@ -696,25 +714,26 @@ void	handle_open_par(t_engine_data *d, int opar_ind, bool *f_noerr)
 
 	// Move the prompt index to the next symbol in the
 	// prompt after the nearest ')' to the last '(' found
-	d->pi = d->close_par[i][0] + 1;
+	d->pi = cpar->ind + 1;
 	
 	// Mark this closing-parenthesis as closed
-	d->close_par[i][1] = CLOSED_PAR;
+	cpar->flag = CLOSED_PAR;
 
-	// By decrementing the opening-parentheses counter we remove
-	// the last element from the array of all opening-parentheses
-	--d->opar_cnt;
+	// Remove the last element from the
+	// opening-parentheses being handled
+	vec_pop(&d->open_par);
 }
 
 void	handle_close_par(t_engine_data *d, bool *f_noerr)
 {
-	int		i;
-	size_t	last_cpar_ind;	// Last closing-parenthesis index
-	size_t	pair_opar_ind;
+	size_t		i;
+	size_t		last_cpar_ind;	// Last closing-parenthesis index
+	size_t		pair_opar_ind;
+	t_par_pos	*opar;
 
 	// A ')' can go only after an operand or after another ')'
-	if (d->tokens[d->token_cnt - 1].type != OPERAND &&
-		d->tokens[d->token_cnt - 1].type != CLOSE_PAR)
+	if (LAST_TOKEN(d).type != OPERAND &&
+		LAST_TOKEN(d).type != CLOSE_PAR)
 	{
 		// Situations like:
 		// "a (b | )"
@@ -725,7 +744,7 @@ void	handle_close_par(t_engine_data *d, bool *f_noerr)
 	}
 
 	// If the array of opening-parenthesis is empty
-	if (d->opar_cnt == 0)
+	if (d->open_par.len == 0)
 	{
 		*f_noerr = false;
 		fprintf(stderr, "Parsing error: "
@@ -734,9 +753,7 @@ void	handle_close_par(t_engine_data *d, bool *f_noerr)
 	else
 	{
 		// Add this operand into the tokens array
-		d->tokens[d->token_cnt].type = CLOSE_PAR;
-		d->tokens[d->token_cnt].start_pi = d->pi;
-		++d->token_cnt;
+		add_token(d, CLOSE_PAR)->start_pi = d->pi;
 
 		// Let's find the nearest to us (to `d->pi`)
 		// not-yet-closed opening parenthesis to the
@@ -744,27 +761,26 @@ void	handle_close_par(t_engine_data *d, bool *f_noerr)
 		last_cpar_ind = d->pi;
 		i = 0;
 		pair_opar_ind = i;
-		// The `opar_num` after calculating it on the
+		// The `all_open_pars` after calculating it on the
 		// initialization stage will never be changed
-		// meanwhile `opar_cnt` will be decreased
+		// meanwhile `open_par` will be popped
 		// each time we find a closing-parenthesis
-		while (i < d->opar_num)
+		while (i < d->all_open_pars.len)
 		{
-			if (d->all_open_pars[i][0] < last_cpar_ind &&
-				d->all_open_pars[i][1] == NOT_CLOSED_PAR)
-			{
+			opar = &VEC_AT(&d->all_open_pars, t_par_pos, i);
+			if (opar->ind < last_cpar_ind && opar->flag == NOT_CLOSED_PAR)
 				pair_opar_ind = i;
-			}
 			++i;
 		}
 
 		// Add this closing parenthesis index to the
 		// list of all parenthesis pairs to match the
 		// corresponding opening parenthesis index
-		d->pars[pair_opar_ind].second = d->pi;
+		if (pair_opar_ind < d->pars.len)
+			VEC_AT(&d->pars, t_pair, pair_opar_ind).second = d->pi;
 
 		// Mark the matched opening-parenthesis as closed
-		d->all_open_pars[pair_opar_ind][1] = CLOSED_PAR;
+		VEC_AT(&d->all_open_pars, t_par_pos, pair_opar_ind).flag = CLOSED_PAR;
 	}
 }
 
@@ -802,83 +818,44 @@ void	skip_spaces(char *prompt, size_t *pi)
 // Now we have to launch all operand-programs
 int	exec_ops(t_engine_data *d)
 {
-	t_operand	*op;					// Pointer to the current operand
-	pid_t		progs[MAX_OPS_NUM];		// Program PIDs
-	pid_t		subshs[MAX_SUBSHS_NUM];	// Our subshells' PIDs
-	int			ti;						// Token index (must be int)
-	size_t		sh_i;					// Subshell index
-	size_t		pi;						// Program index
+	t_operand	*op;		// Pointer to the current operand
+	pid_t		subsh;		// Our subshell's PID
+	int			ti;			// Token index (must be int)
 	t_ll		cpar_ind;
 
 	// Traversing from right to left the tokens array
-	pi = 0;
-	sh_i = 0;
-	ti = (int)(d->token_cnt) - 1;
+	ti = (int)(d->tokens.len) - 1;
 	while (ti >= 0)
 	{
-		if (d->tokens[ti].type == OPERAND)
+		if (TOKEN_AT(d, ti).type == OPERAND)
 		{
-			progs[pi] = fork();
-			if (progs[pi] == -1)
-			{
-				fprintf(stderr, "Can't fork: %s\n", strerror(errno));
-				return (0);
-			}
-			else if (progs[pi] == 0) // 0 always is returned in the child
-			{
-				++pi;
-
-				// We're in the new process
-				char    *op_argv[2] = { 0, 0 };
-				char    *envp[] = { "HOME=/home/user",
-									"PATH=/bin:/usr/bin",
-									"USER=user", 0 };
-
-				op = d->tokens[ti].op;
-				op_argv[0] = &op->name[0];
-
-				// Let's attach pipes to each process (operand)
-				if (op->write_end != -1)
-					dup2(d->pipes[op->write_end][WRITE_END], STDOUT_FILENO);
-
-				if (op->read_end != -1)
-					dup2(d->pipes[op->read_end][READ_END], STDIN_FILENO);
-
-				// Let's close all inherited parent's pipes
-
-				if (!close_pipes(d))
-					return (0);
-
-				// Replace the executable image of this process
-				execve(op_argv[0], &op_argv[0], envp);
-
-				fprintf(stderr, "Opps, %s failed\n", op_argv[0]);
+			// Each operand remembers its own PID
+			op = &OP_AT(d, TOKEN_AT(d, ti).op_ind);
+			if (!spawn_op(d, op))
 				return (0);
-
-			} // else if (progs[op_i] == 0)
 		}
-		else if (d->tokens[ti].type == PIPE)
+		else if (TOKEN_AT(d, ti).type == PIPE)
 		{
 			// Do nothing
 		}
-		else if (d->tokens[ti].type == CLOSE_PAR)
+		else if (TOKEN_AT(d, ti).type == CLOSE_PAR)
 		{
 			cpar_ind = get_par_by_token(d, ti, CLOSING_PAR);
+			(void)cpar_ind;
 			// Let's launch a subshell
-			subshs[sh_i] = fork();
-			if (subshs[sh_i] == -1)
+			subsh = fork();
+			if (subsh == -1)
 			{
 				fprintf(stderr, "Can't fork: %s\n", strerror(errno));
 				return (0);
 			}
-			if (subshs[sh_i] == 0)
+			if (subsh == 0)
 			{
-				++sh_i;
 				--ti;
 				continue ;
 			}
 		}
-		else if (d->tokens[ti].type == OPEN_PAR)
+		else if (TOKEN_AT(d, ti).type == OPEN_PAR)
 		{
 			// Exit the current subshell
 			while (wait(NULL) > 0) {}
@@ -899,6 +876,44 @@ int	exec_ops(t_engine_data *d)
 	return (1);
 }
 
+/* Starts an operand-program with its pipes attached. Operands
+ * are plain programs, so they are started by the launcher
+ * (posix_spawn) instead of fork() + execve(): only subshells
+ * need a copy of this process. The pipes are close-on-exec, so
+ * the child does not have to close the pipes of the prompt one
+ * by one: that made every pipeline cost O(pipes^2) close()s */
+int	spawn_op(t_engine_data *d, t_operand *op)
+{
+	char		path[sizeof(op->name) + 2];
+	char		*op_argv[2];
+	char		*envp[] = { "HOME=/home/user",
+							"PATH=/bin:/usr/bin",
+							"USER=user", 0 };
+	t_launch	l;
+
+	// Operands are launched from the current directory
+	snprintf(path, sizeof(path), "./%s", op->name);
+	op_argv[0] = path;
+	op_argv[1] = NULL;
+	l.path = path;
+	l.argv = op_argv;
+	l.envp = envp;
+
+	// Let's attach pipes to each process (operand)
+	l.fd_in = DEFAULT_FD;
+	if (op->read_end != -1)
+		l.fd_in = PIPE_AT(d, op->read_end)[READ_END];
+	l.fd_out = DEFAULT_FD;
+	if (op->write_end != -1)
+		l.fd_out = PIPE_AT(d, op->write_end)[WRITE_END];
+
+	l.close_fds = NULL;
+	l.close_cnt = 0;
+
+	op->pid = launch_spawn(&l);
+	return (op->pid != -1);
+}
+
 /* Accepts the index of a parenthesis in the array of tokens
  * `d->tokens` and returns the index of this parenthesis in
  * `d->pars`. If there is no parenthesis with such a token
@@ -912,18 +927,18 @@ t_ll	get_par_by_token(t_engine_data *d, size_t ti, t_par_type ptype)
 	t_ll	pi;
 
 	pi = 0;
-	while (pi < d->par_cnt)
+	while (pi < (t_ll)d->pars.len)
 	{
 		// Go through opening-parentheses `d->pars[i].first`
 		if (ptype == OPENING_PAR)
 		{
-			if (ti == d->pars[pi].first)
+			if ((t_ll)ti == VEC_AT(&d->pars, t_pair, pi).first)
 				return (pi);
 		}
 		else if (ptype == CLOSING_PAR)
 		{
 			// Go through closing-parentheses `d->pars[i].second`
-			if (ti == d->pars[pi].second)
+			if ((t_ll)ti == VEC_AT(&d->pars, t_pair, pi).second)
 				return (pi);
 		}
 		++pi;
@@ -944,9 +959,9 @@ t_ll	get_token_by_par(t_engine_data *d, size_t pi)
 	t_ll	ti;
 
 	ti = 0;
-	while (ti < d->token_cnt)
+	while (ti < (t_ll)d->tokens.len)
 	{
-		if (pi == d->tokens[ti].start_pi)
+		if (pi == TOKEN_AT(d, ti).start_pi)
 			return (ti);
 		++ti;
 	}
@@ -958,14 +973,14 @@ int	close_pipes(t_engine_data *d)
 	size_t	i;
 
 	i = 0;
-	while (i < d->pipe_cnt)
+	while (i < d->pipes.len)
 	{
-		if (close(d->pipes[i][READ_END]) == -1)
+		if (close(PIPE_AT(d, i)[READ_END]) == -1)
 		{
 			perror("close()");
 			return 0;
 		}
-		if (close(d->pipes[i][WRITE_END]) == -1)
+		if (close(PIPE_AT(d, i)[WRITE_END]) == -1)
 		{
 			perror("close()");
 			return 0;
@@ -982,10 +997,10 @@ void	print_parsed_data(t_engine_data *d)
 	// Let's output the pipes we found
 	i = 0; 
 	printf("\nPipes:\n");
-	while (i < d->pipe_cnt)
+	while (i < d->pipes.len)
 	{
 		printf("%lu: [%d] [%d]\n", i + 1,
-			d->pipes[i][READ_END], d->pipes[i][WRITE_END]);
+			PIPE_AT(d, i)[READ_END], PIPE_AT(d, i)[WRITE_END]);
 		++i;
 	}
 	printf("\n");
@@ -993,10 +1008,10 @@ void	print_parsed_data(t_engine_data *d)
 	// Let's output the operands we found
 	i = 0; 
 	printf("\nOperands:\n");
-	while (i < d->op_cnt)
+	while (i < d->ops.len)
 	{
-		printf("%lu: [%s] [%d] [%d]\n", i + 1,
-			d->ops[i].name, d->ops[i].read_end, d->ops[i].write_end);
+		printf("%lu: [%s] [%d] [%d]\n", i + 1, OP_AT(d, i).name,
+			OP_AT(d, i).read_end, OP_AT(d, i).write_end);
 		++i;
 	}
 	printf("\n");
@@ -1010,20 +1025,21 @@ void	print_tokens(t_engine_data *d)
 	strncpy(format, "%d\t%s\t%lu\n", MAX_FORMAT_STR_LEN);
 	i = 0;
 	printf("\nTokens:\n");
-	while (i < d->token_cnt)
+	while (i < d->tokens.len)
 	{
-		if (d->tokens[i].type == OPERAND)
-			printf(format, i + 1, d->tokens[i].op->name, d->tokens[i].start_pi);
-		else if (d->tokens[i].type == PIPE)
-			printf(format, i + 1, TOKEN_PIPE, d->tokens[i].start_pi);
-		else if (d->tokens[i].type == OPEN_PAR)
-			printf(format, i + 1, TOKEN_OPEN_PAR, d->tokens[i].start_pi);
-		else if (d->tokens[i].type == CLOSE_PAR)
-			printf(format, i + 1, TOKEN_CLOSE_PAR, d->tokens[i].start_pi);
-		else if (d->tokens[i].type == AND)
-			printf(format, i + 1, TOKEN_AND, d->tokens[i].start_pi);
-		else if (d->tokens[i].type == OR)
-			printf(format, i + 1, TOKEN_OR, d->tokens[i].start_pi);
+		if (TOKEN_AT(d, i).type == OPERAND)
+			printf(format, i + 1, OP_AT(d, TOKEN_AT(d, i).op_ind).name,
+				TOKEN_AT(d, i).start_pi);
+		else if (TOKEN_AT(d, i).type == PIPE)
+			printf(format, i + 1, TOKEN_PIPE, TOKEN_AT(d, i).start_pi);
+		else if (TOKEN_AT(d, i).type == OPEN_PAR)
+			printf(format, i + 1, TOKEN_OPEN_PAR, TOKEN_AT(d, i).start_pi);
+		else if (TOKEN_AT(d, i).type == CLOSE_PAR)
+			printf(format, i + 1, TOKEN_CLOSE_PAR, TOKEN_AT(d, i).start_pi);
+		else if (TOKEN_AT(d, i).type == AND)
+			printf(format, i + 1, TOKEN_AND, TOKEN_AT(d, i).start_pi);
+		else if (TOKEN_AT(d, i).type == OR)
+			printf(format, i + 1, TOKEN_OR, TOKEN_AT(d, i).start_pi);
 		++i;
 	}
 	printf("\n");
@@ -1036,9 +1052,10 @@ void	print_parentheses(t_engine_data *d)
 	i = 0;
 	printf("\nParentheses:\n");
 	printf("#\t(\t)\n");
-	while (i < d->par_cnt)
+	while (i < d->pars.len)
 	{
-		printf("%lu\t%d\t%d\n", i + 1, d->pars[i].first, d->pars[i].second);
+		printf("%lu\t%d\t%d\n", i + 1, VEC_AT(&d->pars, t_pair, i).first,
+			VEC_AT(&d->pars, t_pair, i).second);
 		++i;
 	}
 	printf("\n");
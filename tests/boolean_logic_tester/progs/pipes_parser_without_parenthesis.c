@@ -4,6 +4,7 @@
  * Each program is named with a single letter of the English
  * alphabet. Lowercase-letter programs always return 0 (success),
  * while uppercase-letter programs always return 1 (failure) */
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -114,7 +115,8 @@ int	main(void)
                 if (prompt[pi] == '|') // If further goes pipe
                 {
                     // Let's create a pipe
-                    if (pipe(&pipes[pipe_cnt][0]) == -1)
+                    // Close-on-exec: a child keeps only its own ends
+                    if (pipe2(&pipes[pipe_cnt][0], O_CLOEXEC) == -1)
                     {
                         fprintf(stderr, "Can't create pipe: %s\n", strerror(errno));
                         exit(EXIT_FAILURE);
@@ -211,16 +213,8 @@ int	main(void)
                 if (ops[op_i].read_end != -1)
                     dup2(pipes[ops[op_i].read_end][READ_END], STDIN_FILENO);
 
-                // Let's close all inherited parent's pipes
-                int i;
-
-                i = 0;
-                while (i < pipe_cnt)
-                {
-                    if (close(pipes[i][READ_END]) == -1) { perror("close()"); }
-                    if (close(pipes[i][WRITE_END]) == -1) { perror("close()"); }
-                    ++i;
-                }
+                // The inherited pipes are close-on-exec, closing
+                // them one by one here cost O(pipes^2) per prompt
 
                 // Replace the executable image of this process
                 execve(op_argv[0], &op_argv[0], envp);
@@ -233,14 +227,8 @@ int	main(void)
 
         } // while (op_i >= 0)
 
-        // Wait for all children to finish
-        while (wait(NULL) > 0)
-        {
-            /*fprintf(stdout, "Parent: Children have finished "
-                "the execution, parent is done\n");*/
-        }
-
-        // Close all pipes of this prompt
+        // Close all pipes of this prompt before waiting: a child
+        // reading its stdin gets EOF only once every write end is gone
         i = 0;
         while (i < pipe_cnt)
         {
@@ -249,6 +237,13 @@ int	main(void)
             ++i;
         }
 
+        // Wait for all children to finish
+        while (wait(NULL) > 0)
+        {
+            /*fprintf(stdout, "Parent: Children have finished "
+                "the execution, parent is done\n");*/
+        }
+
 		free(rline_buf);
 		rline_buf = NULL;
 